@@ -34,7 +34,7 @@ int main(int argc, char *argv[])
     QString log_dir = QApplication::applicationDirPath() + "/../src/log";
     QDir().mkpath(log_dir);
     QString log_file = log_dir + "/comm_" + 
-        QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".log";
+        QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".axlog";
     comm_logger_t::instance()->start_logging(log_file);
     qDebug() << "通信日志保存至:" << log_file;
 
@@ -42,5 +42,9 @@ int main(int argc, char *argv[])
     main_window_t window;
     window.show();
 
-    return app.exec();
+    int ret = app.exec();
+
+    /* 等待后台线程写完剩余日志 */
+    comm_logger_t::instance()->stop_logging();
+    return ret;
 }
@@ -0,0 +1,295 @@
+/**
+ * @file modbus_codec.cpp
+ * @brief Modbus RTU帧编解码实现
+ */
+
+#include "modbus_codec.h"
+
+/* ============== CRC ============== */
+
+namespace {
+
+/* 查表CRC（slicing-by-8）
+ * s_crc_table[0]为逐字节表，s_crc_table[k][b]为字节b之后再经过k个零字节的CRC，
+ * 8个字节的贡献可并行查表后异或，循环依赖链比逐字节查表短8倍 */
+struct crc_table_t {
+    quint16 t[8][256];
+
+    constexpr crc_table_t() : t()
+    {
+        for (int b = 0; b < 256; ++b) {
+            quint16 crc = (quint16)b;
+            for (int j = 0; j < 8; ++j) {
+                crc = (crc & 0x0001) ? (quint16)((crc >> 1) ^ 0xA001) : (quint16)(crc >> 1);
+            }
+            t[0][b] = crc;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (int b = 0; b < 256; ++b) {
+                t[k][b] = (quint16)((t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xFF]);
+            }
+        }
+    }
+};
+
+constexpr crc_table_t s_crc_table;
+
+inline void put_u16(quint8 *p, quint16 v)
+{
+    p[0] = (quint8)(v >> 8);
+    p[1] = (quint8)(v & 0xFF);
+}
+
+inline quint16 get_u16(const quint8 *p)
+{
+    return (quint16)((p[0] << 8) | p[1]);
+}
+
+/* 追加CRC（低字节在前），返回帧总长度 */
+inline int append_crc(quint8 *buf, int len)
+{
+    quint16 crc = modbus_crc16(buf, len);
+    buf[len] = (quint8)(crc & 0xFF);
+    buf[len + 1] = (quint8)(crc >> 8);
+    return len + 2;
+}
+
+} // namespace
+
+quint16 modbus_crc16(const quint8 *data, int len)
+{
+    const quint16 (*t)[256] = s_crc_table.t;
+    quint16 crc = 0xFFFF;
+
+    while (len >= 8) {
+        crc = t[7][(data[0] ^ crc) & 0xFF] ^ t[6][(data[1] ^ (crc >> 8)) & 0xFF] ^
+              t[5][data[2]] ^ t[4][data[3]] ^ t[3][data[4]] ^ t[2][data[5]] ^
+              t[1][data[6]] ^ t[0][data[7]];
+        data += 8;
+        len -= 8;
+    }
+    while (len-- > 0) {
+        crc = (quint16)((crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF]);
+    }
+
+    return crc;
+}
+
+bool modbus_verify_crc(const quint8 *frame, int len)
+{
+    if (len < 4) {
+        return false;
+    }
+    quint16 recv_crc = (quint16)(frame[len - 2] | (frame[len - 1] << 8));
+    return modbus_crc16(frame, len - 2) == recv_crc;
+}
+
+/* ============== 帧长度 ============== */
+
+/**
+ * @brief 按帧头推算请求帧长度
+ * @note 读/写单个寄存器固定8字节，写多个寄存器为9+字节数
+ */
+int modbus_request_length(const quint8 *frame, int len)
+{
+    if (len < 2) {
+        return 0;
+    }
+
+    switch (frame[1]) {
+    case MODBUS_FC_READ_HOLDING_REGISTERS:
+    case MODBUS_FC_WRITE_SINGLE_REGISTER:
+        return 8;
+    case MODBUS_FC_WRITE_MULTIPLE_REGISTERS:
+        return len >= 7 ? 9 + frame[6] : 0;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief 按帧头推算响应帧长度
+ * @note 异常响应(功能码|0x80)固定5字节，读响应由字节数字段决定
+ */
+int modbus_response_length(const quint8 *frame, int len)
+{
+    if (len < 2) {
+        return 0;
+    }
+
+    if (frame[1] & 0x80) {
+        return 5;  /* 地址+功能码+异常码+CRC */
+    }
+
+    switch (frame[1]) {
+    case MODBUS_FC_READ_HOLDING_REGISTERS:
+        return len >= 3 ? 5 + frame[2] : 0;
+    case MODBUS_FC_WRITE_SINGLE_REGISTER:
+    case MODBUS_FC_WRITE_MULTIPLE_REGISTERS:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+/* ============== 编码 ============== */
+
+int modbus_build_read_request(quint8 *buf, int cap, quint8 slave_addr,
+                              quint16 start_addr, quint16 count)
+{
+    if (cap < 8) {
+        return 0;
+    }
+    buf[0] = slave_addr;
+    buf[1] = MODBUS_FC_READ_HOLDING_REGISTERS;
+    put_u16(buf + 2, start_addr);
+    put_u16(buf + 4, count);
+    return append_crc(buf, 6);
+}
+
+/**
+ * @brief 构建写单个寄存器帧
+ * @note 请求与正常响应格式相同
+ */
+int modbus_build_write_single(quint8 *buf, int cap, quint8 slave_addr,
+                              quint16 addr, quint16 value)
+{
+    if (cap < 8) {
+        return 0;
+    }
+    buf[0] = slave_addr;
+    buf[1] = MODBUS_FC_WRITE_SINGLE_REGISTER;
+    put_u16(buf + 2, addr);
+    put_u16(buf + 4, value);
+    return append_crc(buf, 6);
+}
+
+int modbus_build_write_multiple_request(quint8 *buf, int cap, quint8 slave_addr,
+                                        quint16 start_addr, const quint16 *values, int count)
+{
+    if (count <= 0 || count > MODBUS_MAX_WRITE_REGISTERS || cap < 9 + count * 2) {
+        return 0;
+    }
+    buf[0] = slave_addr;
+    buf[1] = MODBUS_FC_WRITE_MULTIPLE_REGISTERS;
+    put_u16(buf + 2, start_addr);
+    put_u16(buf + 4, (quint16)count);
+    buf[6] = (quint8)(count * 2);
+    for (int i = 0; i < count; ++i) {
+        put_u16(buf + 7 + i * 2, values[i]);
+    }
+    return append_crc(buf, 7 + count * 2);
+}
+
+int modbus_build_read_response(quint8 *buf, int cap, quint8 slave_addr,
+                               const quint16 *values, int count)
+{
+    if (count <= 0 || count > MODBUS_MAX_READ_REGISTERS || cap < 5 + count * 2) {
+        return 0;
+    }
+    buf[0] = slave_addr;
+    buf[1] = MODBUS_FC_READ_HOLDING_REGISTERS;
+    buf[2] = (quint8)(count * 2);
+    for (int i = 0; i < count; ++i) {
+        put_u16(buf + 3 + i * 2, values[i]);
+    }
+    return append_crc(buf, 3 + count * 2);
+}
+
+int modbus_build_write_multiple_response(quint8 *buf, int cap, quint8 slave_addr,
+                                         quint16 start_addr, quint16 count)
+{
+    if (cap < 8) {
+        return 0;
+    }
+    buf[0] = slave_addr;
+    buf[1] = MODBUS_FC_WRITE_MULTIPLE_REGISTERS;
+    put_u16(buf + 2, start_addr);
+    put_u16(buf + 4, count);
+    return append_crc(buf, 6);
+}
+
+int modbus_build_exception(quint8 *buf, int cap, quint8 slave_addr,
+                           quint8 function_code, quint8 exception_code)
+{
+    if (cap < 5) {
+        return 0;
+    }
+    buf[0] = slave_addr;
+    buf[1] = (quint8)(function_code | 0x80);
+    buf[2] = exception_code;
+    return append_crc(buf, 3);
+}
+
+/* ============== 解码 ============== */
+
+bool modbus_parse_request(const quint8 *frame, int len, modbus_adu_t &adu)
+{
+    int expected = modbus_request_length(frame, len);
+    if (expected == 0 || len != expected || !modbus_verify_crc(frame, len)) {
+        return false;
+    }
+
+    adu.slave_addr = frame[0];
+    adu.function_code = frame[1];
+    adu.exception_code = 0;
+    adu.addr = get_u16(frame + 2);
+    adu.data = nullptr;
+    adu.data_len = 0;
+
+    switch (adu.function_code) {
+    case MODBUS_FC_READ_HOLDING_REGISTERS:
+        adu.count = get_u16(frame + 4);
+        adu.value = 0;
+        return true;
+    case MODBUS_FC_WRITE_SINGLE_REGISTER:
+        adu.count = 1;
+        adu.value = get_u16(frame + 4);
+        return true;
+    default:  /* MODBUS_FC_WRITE_MULTIPLE_REGISTERS */
+        adu.count = get_u16(frame + 4);
+        adu.value = 0;
+        adu.data = frame + 7;
+        adu.data_len = frame[6];
+        return adu.data_len == adu.count * 2;
+    }
+}
+
+bool modbus_parse_response(const quint8 *frame, int len, modbus_adu_t &adu)
+{
+    int expected = modbus_response_length(frame, len);
+    if (expected == 0 || len != expected || !modbus_verify_crc(frame, len)) {
+        return false;
+    }
+
+    adu.slave_addr = frame[0];
+    adu.function_code = frame[1];
+    adu.exception_code = 0;
+    adu.addr = 0;
+    adu.count = 0;
+    adu.value = 0;
+    adu.data = nullptr;
+    adu.data_len = 0;
+
+    if (adu.function_code & 0x80) {
+        adu.exception_code = frame[2];
+        return true;
+    }
+
+    switch (adu.function_code) {
+    case MODBUS_FC_READ_HOLDING_REGISTERS:
+        adu.data = frame + 3;
+        adu.data_len = frame[2];
+        adu.count = (quint16)(adu.data_len / 2);
+        return (adu.data_len & 1) == 0;
+    case MODBUS_FC_WRITE_SINGLE_REGISTER:
+        adu.addr = get_u16(frame + 2);
+        adu.count = 1;
+        adu.value = get_u16(frame + 4);
+        return true;
+    default:  /* MODBUS_FC_WRITE_MULTIPLE_REGISTERS */
+        adu.addr = get_u16(frame + 2);
+        adu.count = get_u16(frame + 4);
+        return true;
+    }
+}
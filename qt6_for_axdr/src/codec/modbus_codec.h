@@ -0,0 +1,82 @@
+/**
+ * @file modbus_codec.h
+ * @brief Modbus RTU帧编解码
+ * @note 主站(modbus_client_t)与从机模拟器(modbus_slave_t)共用
+ * @note 编码写入调用方预分配的缓冲区，解码直接引用接收缓冲区，均不分配内存
+ */
+
+#ifndef MODBUS_CODEC_H
+#define MODBUS_CODEC_H
+
+#include <QtGlobal>
+
+/* Modbus功能码 */
+#define MODBUS_FC_READ_HOLDING_REGISTERS    0x03
+#define MODBUS_FC_WRITE_SINGLE_REGISTER     0x06
+#define MODBUS_FC_WRITE_MULTIPLE_REGISTERS  0x10
+
+/* Modbus异常码 */
+#define MODBUS_EX_ILLEGAL_FUNCTION      0x01
+#define MODBUS_EX_ILLEGAL_DATA_ADDRESS  0x02
+#define MODBUS_EX_ILLEGAL_DATA_VALUE    0x03
+
+/* 帧长度限制 */
+#define MODBUS_RTU_MAX_ADU          256     /* RTU帧最大长度 */
+#define MODBUS_MAX_READ_REGISTERS   125     /* 单次读取寄存器上限 */
+#define MODBUS_MAX_WRITE_REGISTERS  123     /* 单次写入寄存器上限 */
+
+/* 解码结果：字段均为解析出的值，data指向原缓冲区内的寄存器数据（大端） */
+typedef struct {
+    quint8 slave_addr;          /* 从机地址 */
+    quint8 function_code;       /* 功能码（异常响应保留0x80位） */
+    quint8 exception_code;      /* 异常码（仅异常响应） */
+    quint16 addr;               /* 起始地址（请求、写响应） */
+    quint16 count;              /* 寄存器数量（写单个寄存器时为1） */
+    quint16 value;              /* 写入值（写单个寄存器） */
+    const quint8 *data;         /* 寄存器数据（读响应、写多个寄存器请求） */
+    int data_len;               /* 寄存器数据字节数 */
+} modbus_adu_t;
+
+/* ============== CRC ============== */
+
+/* CRC-16/MODBUS（查表，每次处理8字节） */
+quint16 modbus_crc16(const quint8 *data, int len);
+
+/* 校验帧尾CRC（低字节在前） */
+bool modbus_verify_crc(const quint8 *frame, int len);
+
+/* ============== 帧长度 ============== */
+
+/* 按帧头推算长度，帧头未收全或功能码不支持时返回0 */
+int modbus_request_length(const quint8 *frame, int len);
+int modbus_response_length(const quint8 *frame, int len);
+
+/* ============== 编码 ============== */
+/* 写入buf，返回帧长度（含CRC）；参数越界或容量不足时返回0 */
+
+int modbus_build_read_request(quint8 *buf, int cap, quint8 slave_addr,
+                              quint16 start_addr, quint16 count);
+int modbus_build_write_single(quint8 *buf, int cap, quint8 slave_addr,
+                              quint16 addr, quint16 value);
+int modbus_build_write_multiple_request(quint8 *buf, int cap, quint8 slave_addr,
+                                        quint16 start_addr, const quint16 *values, int count);
+int modbus_build_read_response(quint8 *buf, int cap, quint8 slave_addr,
+                               const quint16 *values, int count);
+int modbus_build_write_multiple_response(quint8 *buf, int cap, quint8 slave_addr,
+                                         quint16 start_addr, quint16 count);
+int modbus_build_exception(quint8 *buf, int cap, quint8 slave_addr,
+                           quint8 function_code, quint8 exception_code);
+
+/* ============== 解码 ============== */
+/* 输入为完整帧（含CRC），CRC错误、长度与帧头不符或功能码不支持时返回false */
+
+bool modbus_parse_request(const quint8 *frame, int len, modbus_adu_t &adu);
+bool modbus_parse_response(const quint8 *frame, int len, modbus_adu_t &adu);
+
+/* 读取第i个寄存器（大端） */
+inline quint16 modbus_register(const modbus_adu_t &adu, int i)
+{
+    return (quint16)((adu.data[i * 2] << 8) | adu.data[i * 2 + 1]);
+}
+
+#endif /* MODBUS_CODEC_H */
@@ -0,0 +1,31 @@
+/**
+ * @file byte_order.h
+ * @brief 日志与抓包文件的小端字段读写
+ * @note comm_logger(.axlog)与modbus_capture(.axcap)文件头、记录头共用
+ */
+
+#ifndef BYTE_ORDER_H
+#define BYTE_ORDER_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/* value的低bytes字节按小端追加到out */
+inline void append_le(QByteArray &out, quint64 value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) {
+        out.append(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+/* 从p读取bytes字节小端无符号整数 */
+inline quint64 read_le(const quint8 *p, int bytes)
+{
+    quint64 value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+#endif /* BYTE_ORDER_H */
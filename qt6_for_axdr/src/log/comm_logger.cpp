@@ -4,7 +4,93 @@
  */
 
 #include "comm_logger.h"
+#include "byte_order.h"
+#include "codec/modbus_codec.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QTextStream>
 #include <QDir>
+#include <chrono>
+#include <cstring>
+
+/* ============== 无锁队列 ============== */
+
+namespace {
+
+const size_t LOG_QUEUE_CAPACITY = 4096;             /* 队列槽数（2的幂） */
+const int LOG_SLOT_DATA = MODBUS_RTU_MAX_ADU;       /* 单条记录数据上限 */
+
+/* 队列槽：seq为槽序号，生产者写完后发布为pos+1，消费者取走后回收为pos+容量 */
+struct log_slot_t {
+    std::atomic<size_t> seq;
+    quint64 timestamp_ns;
+    quint8 type;
+    quint16 length;
+    quint8 data[LOG_SLOT_DATA];
+};
+
+} // namespace
+
+/* 有界多生产者单消费者队列（按槽序号同步，无锁） */
+struct log_ring_t {
+    log_slot_t cells[LOG_QUEUE_CAPACITY];
+    alignas(64) std::atomic<size_t> tail;   /* 生产者共享 */
+    alignas(64) size_t head;                /* 仅后台线程访问 */
+
+    log_ring_t() { reset(); }
+
+    void reset()
+    {
+        for (size_t i = 0; i < LOG_QUEUE_CAPACITY; ++i) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+        tail.store(0, std::memory_order_relaxed);
+        head = 0;
+    }
+
+    /* 占用一个空槽，队列满时返回nullptr */
+    log_slot_t *acquire(size_t &pos)
+    {
+        pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            log_slot_t &slot = cells[pos & (LOG_QUEUE_CAPACITY - 1)];
+            size_t seq = slot.seq.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    return &slot;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish(log_slot_t *slot, size_t pos)
+    {
+        slot->seq.store(pos + 1, std::memory_order_release);
+    }
+
+    /* 取队首记录，队列空时返回nullptr；处理完后调用release */
+    log_slot_t *front()
+    {
+        log_slot_t &slot = cells[head & (LOG_QUEUE_CAPACITY - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != head + 1) {
+            return nullptr;
+        }
+        return &slot;
+    }
+
+    void release(log_slot_t *slot)
+    {
+        slot->seq.store(head + LOG_QUEUE_CAPACITY, std::memory_order_release);
+        ++head;
+    }
+};
+
+/* ============== 日志记录 ============== */
 
 comm_logger_t* comm_logger_t::s_instance = nullptr;
 
@@ -18,108 +104,408 @@ comm_logger_t* comm_logger_t::instance()
 
 comm_logger_t::comm_logger_t(QObject *parent)
     : QObject(parent)
+    , m_ring(new log_ring_t)
     , m_file(nullptr)
-    , m_stream(nullptr)
+    , m_file_index(0)
+    , m_file_size(0)
+    , m_max_file_size(DEFAULT_MAX_FILE_SIZE)
+    , m_max_files(DEFAULT_MAX_FILES)
+    , m_start_epoch_ms(0)
     , m_is_logging(false)
+    , m_dropped(0)
 {
 }
 
 comm_logger_t::~comm_logger_t()
 {
     stop_logging();
+    delete m_ring;
 }
 
+/**
+ * @brief 开始记录
+ * @note 文件在调用线程打开，以便立即返回失败；之后只由后台线程写入
+ */
 bool comm_logger_t::start_logging(const QString &file_path)
 {
     stop_logging();
 
-    m_file = new QFile(file_path);
-    if (!m_file->open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Append)) {
-        delete m_file;
-        m_file = nullptr;
+    m_file_path = file_path;
+    m_file_index = 0;
+    m_start_epoch_ms = QDateTime::currentMSecsSinceEpoch();
+    m_clock.start();
+    if (!open_file(file_path)) {
         return false;
     }
 
-    m_stream = new QTextStream(m_file);
-    m_stream->setEncoding(QStringConverter::Utf8);
-    m_is_logging = true;
+    m_ring->reset();
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_is_logging.store(true, std::memory_order_release);
+    m_writer = std::thread(&comm_logger_t::writer_loop, this);
 
     log_info("========== 日志开始 ==========");
     return true;
 }
 
+/**
+ * @brief 停止记录，等待后台线程写完队列中的记录
+ */
 void comm_logger_t::stop_logging()
 {
-    if (m_is_logging) {
-        log_info("========== 日志结束 ==========");
+    if (!m_writer.joinable()) {
+        return;
     }
 
-    if (m_stream) {
-        m_stream->flush();
-        delete m_stream;
-        m_stream = nullptr;
+    log_info("========== 日志结束 ==========");
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        m_is_logging.store(false, std::memory_order_release);
     }
+    m_wake.notify_one();
+    m_writer.join();
 
     if (m_file) {
         m_file->close();
         delete m_file;
         m_file = nullptr;
     }
-
-    m_is_logging = false;
 }
 
-bool comm_logger_t::is_logging() const
+/**
+ * @brief 设置按大小滚动的参数，需在start_logging前调用
+ */
+void comm_logger_t::set_rotation(qint64 max_bytes, int max_files)
 {
-    return m_is_logging;
+    m_max_file_size = max_bytes > COMM_LOG_HEADER_SIZE ? max_bytes : DEFAULT_MAX_FILE_SIZE;
+    m_max_files = max_files > 0 ? max_files : 1;
 }
 
-void comm_logger_t::log_send(const QByteArray &data, const QString &desc)
+void comm_logger_t::log_send(const quint8 *frame, int len)
 {
-    QString content = format_hex(data);
-    if (!desc.isEmpty()) {
-        content += " | " + desc;
-    }
-    write_log("发送", content);
+    push_record(e_log_send, frame, len);
 }
 
-void comm_logger_t::log_recv(const QByteArray &data, const QString &desc)
+void comm_logger_t::log_recv(const quint8 *frame, int len)
 {
-    QString content = format_hex(data);
-    if (!desc.isEmpty()) {
-        content += " | " + desc;
-    }
-    write_log("接收", content);
+    push_record(e_log_recv, frame, len);
 }
 
 void comm_logger_t::log_info(const QString &msg)
 {
-    write_log("信息", msg);
+    push_text(e_log_info, msg);
 }
 
 void comm_logger_t::log_error(const QString &msg)
 {
-    write_log("错误", msg);
+    push_text(e_log_error, msg);
 }
 
-void comm_logger_t::write_log(const QString &prefix, const QString &content)
+/**
+ * @brief 记录放入队列（不分配内存、不加锁），队列满时丢弃并计数
+ */
+void comm_logger_t::push_record(log_record_type_E type, const quint8 *data, int len)
 {
-    if (!m_is_logging || !m_stream) {
+    if (!is_logging()) {
+        return;
+    }
+
+    size_t pos;
+    log_slot_t *slot = m_ring->acquire(pos);
+    if (!slot) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
         return;
     }
 
-    QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");
-    QString line = QString("[%1] [%2] %3").arg(timestamp, prefix, content);
+    if (len > LOG_SLOT_DATA) {
+        len = LOG_SLOT_DATA;
+    }
+    slot->timestamp_ns = (quint64)m_clock.nsecsElapsed();
+    slot->type = (quint8)type;
+    slot->length = (quint16)len;
+    memcpy(slot->data, data, len);
+    m_ring->publish(slot, pos);
+}
+
+/**
+ * @brief 文本记录，超长时在UTF-8字符边界截断
+ */
+void comm_logger_t::push_text(log_record_type_E type, const QString &msg)
+{
+    if (!is_logging()) {
+        return;
+    }
+
+    QByteArray utf8 = msg.toUtf8();
+    int len = utf8.size();
+    if (len > LOG_SLOT_DATA) {
+        len = LOG_SLOT_DATA;
+        while (len > 0 && (static_cast<quint8>(utf8[len]) & 0xC0) == 0x80) {
+            --len;
+        }
+    }
+    push_record(type, reinterpret_cast<const quint8 *>(utf8.constData()), len);
+}
+
+/**
+ * @brief 后台写线程：每FLUSH_INTERVAL_MS取空队列，整批写入并刷新一次
+ */
+void comm_logger_t::writer_loop()
+{
+    QByteArray batch;
+    batch.reserve(64 * 1024);
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_wake.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS),
+                            [this] { return !m_is_logging.load(std::memory_order_acquire); });
+        }
+        bool stopping = !m_is_logging.load(std::memory_order_acquire);
+
+        while (log_slot_t *slot = m_ring->front()) {
+            append_le(batch, slot->timestamp_ns, 8);
+            append_le(batch, slot->type, 1);
+            append_le(batch, 0, 1);
+            append_le(batch, slot->length, 2);
+            batch.append(reinterpret_cast<const char *>(slot->data), slot->length);
+            m_ring->release(slot);
+        }
+
+        quint32 dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            append_le(batch, (quint64)m_clock.nsecsElapsed(), 8);
+            append_le(batch, e_log_dropped, 1);
+            append_le(batch, 0, 1);
+            append_le(batch, 4, 2);
+            append_le(batch, dropped, 4);
+        }
 
-    *m_stream << line << "\n";
-    m_stream->flush();
+        if (!batch.isEmpty()) {
+            if (m_file) {
+                m_file->write(batch);
+                m_file->flush();
+                m_file_size += batch.size();
+                if (m_file_size >= m_max_file_size) {
+                    rotate_file();
+                }
+            }
+            batch.clear();
+        }
+
+        if (stopping) {
+            return;
+        }
+    }
 }
 
-QString comm_logger_t::format_hex(const QByteArray &data)
+/**
+ * @brief 打开日志文件并写入文件头
+ */
+bool comm_logger_t::open_file(const QString &file_path)
 {
-    QStringList hex_list;
-    for (int i = 0; i < data.size(); ++i) {
-        hex_list.append(QString("%1").arg(static_cast<quint8>(data[i]), 2, 16, QChar('0')).toUpper());
+    QFile *file = new QFile(file_path);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        delete file;
+        return false;
     }
-    return hex_list.join(" ");
+
+    QByteArray header(COMM_LOG_MAGIC, 5);
+    append_le(header, COMM_LOG_VERSION, 1);
+    append_le(header, 0, 2);
+    append_le(header, (quint64)m_start_epoch_ms, 8);
+    file->write(header);
+
+    m_file = file;
+    m_file_size = header.size();
+    return true;
+}
+
+/**
+ * @brief 换到下一个文件，超出保留个数时删除最早的文件
+ * @note 每个文件都带文件头，可单独导出
+ */
+void comm_logger_t::rotate_file()
+{
+    m_file->close();
+    delete m_file;
+    m_file = nullptr;
+
+    ++m_file_index;
+    if (m_file_index >= m_max_files) {
+        QFile::remove(rotated_path(m_file_index - m_max_files));
+    }
+    open_file(rotated_path(m_file_index));
+}
+
+/**
+ * @brief 第index个滚动文件路径，如comm_x.axlog、comm_x.1.axlog、comm_x.2.axlog
+ */
+QString comm_logger_t::rotated_path(int index) const
+{
+    if (index == 0) {
+        return m_file_path;
+    }
+    QFileInfo info(m_file_path);
+    return QString("%1/%2.%3.%4").arg(info.absolutePath(), info.completeBaseName())
+                                 .arg(index).arg(info.suffix());
+}
+
+/* ============== 文本导出 ============== */
+
+namespace {
+
+QString format_hex(const quint8 *data, int len)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    QString hex;
+    hex.reserve(len * 3);
+    for (int i = 0; i < len; ++i) {
+        if (i > 0) {
+            hex += QChar(' ');
+        }
+        hex += QChar(digits[data[i] >> 4]);
+        hex += QChar(digits[data[i] & 0x0F]);
+    }
+    return hex;
+}
+
+QString format_registers(const modbus_adu_t &adu)
+{
+    QString values;
+    for (int i = 0; i < adu.data_len / 2; ++i) {
+        if (i > 0) {
+            values += QChar(' ');
+        }
+        values += QString("%1").arg(modbus_register(adu, i), 4, 16, QChar('0')).toUpper();
+    }
+    return values;
+}
+
+/* 请求帧描述；读请求的起始地址记入last_read_addr，供随后的读响应使用 */
+QString describe_request(const quint8 *frame, int len, int &last_read_addr)
+{
+    modbus_adu_t adu;
+    if (!modbus_parse_request(frame, len, adu)) {
+        return "无法解析";
+    }
+
+    switch (adu.function_code) {
+    case MODBUS_FC_READ_HOLDING_REGISTERS:
+        last_read_addr = adu.addr;
+        return QString("读取寄存器 地址:0x%1 数量:%2")
+                   .arg(adu.addr, 4, 16, QChar('0')).arg(adu.count);
+    case MODBUS_FC_WRITE_SINGLE_REGISTER:
+        return QString("写单个寄存器 地址:0x%1 值:%2")
+                   .arg(adu.addr, 4, 16, QChar('0')).arg(adu.value);
+    default:
+        return QString("写多个寄存器 地址:0x%1 数量:%2 值:[%3]")
+                   .arg(adu.addr, 4, 16, QChar('0')).arg(adu.count).arg(format_registers(adu));
+    }
+}
+
+QString describe_response(const quint8 *frame, int len, int last_read_addr)
+{
+    modbus_adu_t adu;
+    if (!modbus_parse_response(frame, len, adu)) {
+        return "校验失败";
+    }
+
+    if (adu.exception_code != 0) {
+        return QString("异常响应 功能码:0x%1 异常码:0x%2")
+                   .arg(adu.function_code, 2, 16, QChar('0'))
+                   .arg(adu.exception_code, 2, 16, QChar('0'));
+    }
+
+    switch (adu.function_code) {
+    case MODBUS_FC_READ_HOLDING_REGISTERS:
+        if (last_read_addr < 0) {
+            return QString("读取响应 值:[%1]").arg(format_registers(adu));
+        }
+        return QString("读取响应 地址:0x%1 值:[%2]")
+                   .arg(last_read_addr, 4, 16, QChar('0')).arg(format_registers(adu));
+    case MODBUS_FC_WRITE_SINGLE_REGISTER:
+        return QString("写入成功 地址:0x%1 值:%2")
+                   .arg(adu.addr, 4, 16, QChar('0')).arg(adu.value);
+    default:
+        return QString("写入成功 地址:0x%1 数量:%2")
+                   .arg(adu.addr, 4, 16, QChar('0')).arg(adu.count);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 二进制日志导出为文本
+ * @note 时间精确到微秒；文件尾不完整的记录（写入中）忽略
+ */
+bool comm_logger_t::export_text(const QString &log_path, const QString &text_path)
+{
+    QFile in(log_path);
+    if (!in.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    quint8 header[COMM_LOG_HEADER_SIZE];
+    if (in.read(reinterpret_cast<char *>(header), COMM_LOG_HEADER_SIZE) != COMM_LOG_HEADER_SIZE ||
+        memcmp(header, COMM_LOG_MAGIC, 5) != 0 || header[5] != COMM_LOG_VERSION) {
+        return false;
+    }
+    qint64 start_epoch_ms = (qint64)read_le(header + 8, 8);
+
+    QFile out(text_path);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        return false;
+    }
+    QTextStream stream(&out);
+    stream.setEncoding(QStringConverter::Utf8);
+
+    int last_read_addr = -1;
+    quint8 record[COMM_LOG_RECORD_SIZE];
+    quint8 data[65536];
+    while (in.read(reinterpret_cast<char *>(record), COMM_LOG_RECORD_SIZE) == COMM_LOG_RECORD_SIZE) {
+        quint64 timestamp_ns = read_le(record, 8);
+        quint8 type = record[8];
+        int len = (int)read_le(record + 10, 2);
+        if (in.read(reinterpret_cast<char *>(data), len) != len) {
+            break;
+        }
+
+        qint64 us = (qint64)(timestamp_ns / 1000);
+        QString timestamp = QDateTime::fromMSecsSinceEpoch(start_epoch_ms + us / 1000)
+                                .toString("yyyy-MM-dd hh:mm:ss.zzz") +
+                            QString("%1").arg(us % 1000, 3, 10, QChar('0'));
+
+        QString prefix;
+        QString content;
+        switch (type) {
+        case e_log_send:
+            prefix = "发送";
+            content = format_hex(data, len) + " | " + describe_request(data, len, last_read_addr);
+            break;
+        case e_log_recv:
+            prefix = "接收";
+            content = format_hex(data, len) + " | " + describe_response(data, len, last_read_addr);
+            last_read_addr = -1;
+            break;
+        case e_log_info:
+            prefix = "信息";
+            content = QString::fromUtf8(reinterpret_cast<const char *>(data), len);
+            break;
+        case e_log_error:
+            prefix = "错误";
+            content = QString::fromUtf8(reinterpret_cast<const char *>(data), len);
+            break;
+        case e_log_dropped:
+            prefix = "错误";
+            content = QString("日志队列已满，丢弃%1条记录").arg(len >= 4 ? read_le(data, 4) : 0);
+            break;
+        default:
+            continue;
+        }
+
+        stream << "[" << timestamp << "] [" << prefix << "] " << content << "\n";
+    }
+
+    stream.flush();
+    return true;
 }
@@ -1,6 +1,8 @@
 /**
  * @file comm_logger.h
  * @brief 通信日志记录类声明
+ * @note 调用线程只把原始帧和单调时间戳放入无锁队列，后台线程按批写入二进制文件
+ * @note 文本仅在导出时生成（export_text），记录时不做任何格式化
  */
 
 #ifndef COMM_LOGGER_H
@@ -8,13 +10,39 @@
 
 #include <QObject>
 #include <QFile>
-#include <QTextStream>
 #include <QString>
-#include <QDateTime>
+#include <QElapsedTimer>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/* 日志记录类型 */
+typedef enum {
+    e_log_send = 0,     /* 发送帧 */
+    e_log_recv,         /* 接收帧 */
+    e_log_info,         /* 信息（UTF-8文本） */
+    e_log_error,        /* 错误（UTF-8文本） */
+    e_log_dropped       /* 队列满丢弃的记录数（quint32） */
+} log_record_type_E;
+
+/*
+ * 二进制日志格式（小端）
+ * 文件头16字节: "AXLOG"(5) 版本(1) 保留(2) 起始时刻(quint64, ms since epoch)
+ * 记录头12字节: 时间戳(quint64, ns，相对起始时刻，单调) 类型(1) 保留(1) 长度(quint16)
+ * 记录头后紧跟长度字节的数据
+ */
+#define COMM_LOG_MAGIC          "AXLOG"
+#define COMM_LOG_VERSION        1
+#define COMM_LOG_HEADER_SIZE    16
+#define COMM_LOG_RECORD_SIZE    12
+
+struct log_ring_t;
 
 /**
  * @brief 通信日志记录类
  * @note 单例模式，记录Modbus通信数据
+ * @note log_*可在任意线程调用且不阻塞；队列满时丢弃并计数，不影响总线时序
  */
 class comm_logger_t : public QObject
 {
@@ -26,26 +54,52 @@ public:
     /* 日志控制 */
     bool start_logging(const QString &file_path);
     void stop_logging();
-    bool is_logging() const;
+    bool is_logging() const { return m_is_logging.load(std::memory_order_relaxed); }
+
+    /* 按大小滚动：当前文件超过max_bytes时另起新文件，最多保留max_files个 */
+    void set_rotation(qint64 max_bytes, int max_files);
 
     /* 日志记录 */
-    void log_send(const QByteArray &data, const QString &desc = QString());
-    void log_recv(const QByteArray &data, const QString &desc = QString());
+    void log_send(const quint8 *frame, int len);
+    void log_recv(const quint8 *frame, int len);
     void log_info(const QString &msg);
     void log_error(const QString &msg);
 
+    /* 导出为文本（帧按Modbus协议解析出功能码、地址与数值） */
+    static bool export_text(const QString &log_path, const QString &text_path);
+
 private:
     explicit comm_logger_t(QObject *parent = nullptr);
     ~comm_logger_t();
 
-    void write_log(const QString &prefix, const QString &content);
-    QString format_hex(const QByteArray &data);
+    void push_record(log_record_type_E type, const quint8 *data, int len);
+    void push_text(log_record_type_E type, const QString &msg);
+    void writer_loop();
+    bool open_file(const QString &file_path);
+    void rotate_file();
+    QString rotated_path(int index) const;
 
 private:
     static comm_logger_t *s_instance;
-    QFile *m_file;
-    QTextStream *m_stream;
-    bool m_is_logging;
+    log_ring_t *m_ring;                     /* 无锁记录队列 */
+    QFile *m_file;                          /* 当前日志文件（仅后台线程访问） */
+    QString m_file_path;                    /* 首个日志文件路径 */
+    int m_file_index;                       /* 当前滚动序号 */
+    qint64 m_file_size;                     /* 当前文件大小 */
+    qint64 m_max_file_size;                 /* 滚动阈值 */
+    int m_max_files;                        /* 最多保留文件数 */
+    qint64 m_start_epoch_ms;                /* 起始时刻（墙上时间） */
+    QElapsedTimer m_clock;                  /* 单调时钟 */
+
+    std::atomic<bool> m_is_logging;
+    std::atomic<quint32> m_dropped;         /* 队列满丢弃的记录数 */
+    std::thread m_writer;                   /* 后台写线程 */
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake;
+
+    static const int FLUSH_INTERVAL_MS = 100;       /* 批量写入间隔 */
+    static const qint64 DEFAULT_MAX_FILE_SIZE = 64LL * 1024 * 1024;
+    static const int DEFAULT_MAX_FILES = 8;
 };
 
 #endif /* COMM_LOGGER_H */
@@ -0,0 +1,139 @@
+/**
+ * @file modbus_capture.cpp
+ * @brief Modbus RTU抓包文件读写实现
+ */
+
+#include "modbus_capture.h"
+#include "byte_order.h"
+#include <QDateTime>
+#include <cstring>
+
+/* ============== 写入 ============== */
+
+modbus_capture_t::modbus_capture_t()
+{
+    /* 总线空闲时也按时写入，进程异常退出最多丢失最近1s的记录 */
+    QObject::connect(&m_flush_timer, &QTimer::timeout, [this]() { flush_batch(); });
+}
+
+modbus_capture_t::~modbus_capture_t()
+{
+    close();
+}
+
+/**
+ * @brief 创建抓包文件并写入文件头
+ */
+bool modbus_capture_t::open(const QString &file_path, capture_source_E source)
+{
+    close();
+
+    m_file.setFileName(file_path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    QByteArray header(CAPTURE_MAGIC, 5);
+    append_le(header, CAPTURE_VERSION, 1);
+    append_le(header, source, 1);
+    append_le(header, 0, 1);
+    append_le(header, (quint64)QDateTime::currentMSecsSinceEpoch(), 8);
+    m_file.write(header);
+
+    m_batch.clear();
+    m_batch.reserve(BATCH_SIZE + CAPTURE_RECORD_SIZE + MODBUS_RTU_MAX_ADU);
+    m_clock.start();
+    m_flush_timer.start(FLUSH_INTERVAL_MS);
+    return true;
+}
+
+void modbus_capture_t::close()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+    m_flush_timer.stop();
+    flush_batch();
+    m_file.close();
+}
+
+/**
+ * @brief 记录一帧
+ */
+void modbus_capture_t::record(capture_direction_E direction, const quint8 *frame, int len)
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+    if (len > MODBUS_RTU_MAX_ADU) {
+        len = MODBUS_RTU_MAX_ADU;
+    }
+
+    append_le(m_batch, (quint64)m_clock.nsecsElapsed(), 8);
+    append_le(m_batch, direction, 1);
+    append_le(m_batch, len > 0 ? frame[0] : 0, 1);
+    append_le(m_batch, (quint64)len, 2);
+    m_batch.append(reinterpret_cast<const char *>(frame), len);
+
+    if (m_batch.size() >= BATCH_SIZE) {
+        flush_batch();
+    }
+}
+
+void modbus_capture_t::flush_batch()
+{
+    if (m_batch.isEmpty()) {
+        return;
+    }
+    m_file.write(m_batch);
+    m_file.flush();
+    m_batch.clear();
+}
+
+/* ============== 读取 ============== */
+
+modbus_capture_reader_t::modbus_capture_reader_t()
+    : m_source(e_capture_master)
+    , m_start_epoch_ms(0)
+{
+}
+
+bool modbus_capture_reader_t::open(const QString &file_path)
+{
+    m_file.setFileName(file_path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    quint8 header[CAPTURE_HEADER_SIZE];
+    if (m_file.read(reinterpret_cast<char *>(header), CAPTURE_HEADER_SIZE) != CAPTURE_HEADER_SIZE ||
+        memcmp(header, CAPTURE_MAGIC, 5) != 0 || header[5] != CAPTURE_VERSION) {
+        m_file.close();
+        return false;
+    }
+
+    m_source = header[6] == e_capture_slave ? e_capture_slave : e_capture_master;
+    m_start_epoch_ms = (qint64)read_le(header + 8, 8);
+    return true;
+}
+
+/**
+ * @brief 读取下一条记录
+ * @return 文件结束或末尾记录不完整（抓包中途异常退出）时返回false
+ */
+bool modbus_capture_reader_t::read_next(capture_record_t &record)
+{
+    quint8 header[CAPTURE_RECORD_SIZE];
+    if (m_file.read(reinterpret_cast<char *>(header), CAPTURE_RECORD_SIZE) != CAPTURE_RECORD_SIZE) {
+        return false;
+    }
+
+    record.timestamp_ns = read_le(header, 8);
+    record.direction = header[8] == e_capture_response ? e_capture_response : e_capture_request;
+    record.slave_addr = header[9];
+    record.length = (int)read_le(header + 10, 2);
+    if (record.length > MODBUS_RTU_MAX_ADU) {
+        return false;
+    }
+    return m_file.read(reinterpret_cast<char *>(record.data), record.length) == record.length;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file modbus_capture.h
+ * @brief Modbus RTU抓包文件读写
+ * @note 主站(modbus_client_t)与从机模拟器(modbus_slave_t)均可写入，axcap工具离线解析与回放
+ */
+
+#ifndef MODBUS_CAPTURE_H
+#define MODBUS_CAPTURE_H
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTimer>
+#include "codec/modbus_codec.h"
+
+/* 抓包端 */
+typedef enum {
+    e_capture_master = 0,   /* 主站侧（上位机） */
+    e_capture_slave         /* 从机侧（从机模拟器） */
+} capture_source_E;
+
+/* 帧方向 */
+typedef enum {
+    e_capture_request = 0,  /* 主站 -> 从机 */
+    e_capture_response      /* 从机 -> 主站 */
+} capture_direction_E;
+
+/*
+ * 抓包文件格式（.axcap，小端）
+ * 文件头16字节: "AXCAP"(5) 版本(1) 抓包端(1) 保留(1) 起始时刻(quint64, ms since epoch)
+ * 记录头12字节: 时间戳(quint64, ns，相对起始时刻，单调) 方向(1) 从机地址(1) 长度(quint16)
+ * 记录头后紧跟原始帧（含CRC，校验错误的帧也原样保存）
+ */
+#define CAPTURE_MAGIC           "AXCAP"
+#define CAPTURE_VERSION         1
+#define CAPTURE_HEADER_SIZE     16
+#define CAPTURE_RECORD_SIZE     12
+
+/* 抓包记录 */
+typedef struct {
+    quint64 timestamp_ns;           /* 相对起始时刻的时间戳 */
+    capture_direction_E direction;  /* 帧方向 */
+    quint8 slave_addr;              /* 从机地址（帧首字节） */
+    int length;                     /* 帧长度 */
+    quint8 data[MODBUS_RTU_MAX_ADU];/* 原始帧 */
+} capture_record_t;
+
+/**
+ * @brief 抓包写入
+ * @note 记录先进入内存批次，满64KB或每隔1s（定时器，总线空闲时同样生效）写入文件，不逐帧刷新
+ * @note 须在有事件循环的线程中创建和使用
+ */
+class modbus_capture_t
+{
+public:
+    modbus_capture_t();
+    ~modbus_capture_t();
+
+    bool open(const QString &file_path, capture_source_E source);
+    void close();
+    bool is_open() const { return m_file.isOpen(); }
+
+    void record(capture_direction_E direction, const quint8 *frame, int len);
+
+private:
+    void flush_batch();
+
+private:
+    QFile m_file;
+    QByteArray m_batch;             /* 待写入记录 */
+    QElapsedTimer m_clock;          /* 单调时钟 */
+    QTimer m_flush_timer;           /* 定时写入 */
+
+    static const int BATCH_SIZE = 64 * 1024;
+    static const int FLUSH_INTERVAL_MS = 1000;
+};
+
+/**
+ * @brief 抓包读取
+ */
+class modbus_capture_reader_t
+{
+public:
+    modbus_capture_reader_t();
+
+    bool open(const QString &file_path);
+    bool read_next(capture_record_t &record);
+
+    capture_source_E source() const { return m_source; }
+    qint64 start_epoch_ms() const { return m_start_epoch_ms; }
+
+private:
+    QFile m_file;
+    capture_source_E m_source;     /* 抓包端 */
+    qint64 m_start_epoch_ms;        /* 起始时刻 */
+};
+
+#endif /* MODBUS_CAPTURE_H */
@@ -32,7 +32,7 @@ param_manager_t::~param_manager_t()
 
 /**
  * @brief 读取所有参数
- * @note 依次读取PID、电机、限制参数
+ * @note 依次读取PID、电机、限制参数，三个请求进入客户端事务队列后连续发送
  */
 void param_manager_t::read_all_params()
 {
@@ -61,8 +61,8 @@ void param_manager_t::read_limit_params()
 
 void param_manager_t::read_realtime_data()
 {
-    /* 读取实时数据 (12个寄存器) */
-    m_client->read_holding_registers(REG_ADDR_RT_VELOCITY, 12);
+    /* 读取实时数据 (12个寄存器)，后台轮询优先级最低，不阻塞用户读写 */
+    m_client->read_holding_registers(REG_ADDR_RT_VELOCITY, 12, e_priority_low);
 }
 
 /* ============== 参数写入函数 ============== */
@@ -265,12 +265,7 @@ void param_manager_t::slot_on_write_completed(int addr, bool success)
 float param_manager_t::registers_to_float(quint16 reg0, quint16 reg1)
 {
     /* 将两个16位寄存器合并为32位float (小端序: reg0在低位) */
-    union {
-        float f;
-        quint32 u;
-    } converter;
-    converter.u = ((quint32)reg1 << 16) | reg0;
-    return converter.f;
+    return register_map_to_float(reg0, reg1);
 }
 
 /**
@@ -283,13 +278,7 @@ float param_manager_t::registers_to_float(quint16 reg0, quint16 reg1)
 void param_manager_t::float_to_registers(float value, quint16 &reg0, quint16 &reg1)
 {
     /* 将float拆分为两个16位寄存器 (小端序: reg0存低位) */
-    union {
-        float f;
-        quint32 u;
-    } converter;
-    converter.f = value;
-    reg0 = (quint16)(converter.u & 0xFFFF);
-    reg1 = (quint16)(converter.u >> 16);
+    register_map_from_float(value, reg0, reg1);
 }
 
 QJsonObject param_manager_t::config_to_json(const motor_config_t &config)
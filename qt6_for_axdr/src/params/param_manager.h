@@ -11,51 +11,9 @@
 #include <QMap>
 #include <QJsonObject>
 #include "motor_params.h"
+#include "register_map.h"
 #include "serial/modbus_client.h"
 
-/* ============== 寄存器地址定义 ============== */
-/* PID参数寄存器地址 */
-#define REG_ADDR_PID_CURRENT_KP     0x0000
-#define REG_ADDR_PID_CURRENT_KI     0x0002
-#define REG_ADDR_PID_CURRENT_KD     0x0004
-#define REG_ADDR_PID_VELOCITY_KP    0x0006
-#define REG_ADDR_PID_VELOCITY_KI    0x0008
-#define REG_ADDR_PID_VELOCITY_KD    0x000A
-#define REG_ADDR_PID_POSITION_KP    0x000C
-#define REG_ADDR_PID_POSITION_KI    0x000E
-#define REG_ADDR_PID_POSITION_KD    0x0010
-
-/* 电机参数寄存器地址 */
-#define REG_ADDR_POLE_PAIRS         0x0020
-#define REG_ADDR_PHASE_RESISTANCE   0x0022
-#define REG_ADDR_PHASE_INDUCTANCE   0x0024
-#define REG_ADDR_TORQUE_CONSTANT    0x0026
-
-/* 限制参数寄存器地址 */
-#define REG_ADDR_CURRENT_LIMIT      0x0030
-#define REG_ADDR_VELOCITY_LIMIT     0x0032
-#define REG_ADDR_VOLTAGE_LIMIT      0x0034
-
-/* 编码器参数寄存器地址 */
-#define REG_ADDR_ENCODER_CPR        0x0040
-#define REG_ADDR_ENCODER_OFFSET     0x0042
-
-/* 保护参数寄存器地址 */
-#define REG_ADDR_OVER_VOLTAGE       0x0050
-#define REG_ADDR_UNDER_VOLTAGE      0x0052
-#define REG_ADDR_OVER_TEMP          0x0054
-
-/* 控制模式寄存器地址 */
-#define REG_ADDR_CONTROL_MODE       0x0060
-
-/* 实时数据寄存器地址（只读） */
-#define REG_ADDR_RT_VELOCITY        0x0100
-#define REG_ADDR_RT_POSITION        0x0102
-#define REG_ADDR_RT_CURRENT_Q       0x0104
-#define REG_ADDR_RT_CURRENT_D       0x0106
-#define REG_ADDR_RT_VOLTAGE_BUS     0x0108
-#define REG_ADDR_RT_TEMPERATURE     0x010A
-
 /**
  * @brief 参数管理器类
  */
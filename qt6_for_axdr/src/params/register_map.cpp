@@ -0,0 +1,76 @@
+/**
+ * @file register_map.cpp
+ * @brief AxDr寄存器地址映射实现
+ */
+
+#include "register_map.h"
+#include <cstring>
+
+/* 按地址升序排列 */
+static const register_map_entry_t s_register_map[] = {
+    { REG_ADDR_PID_CURRENT_KP,   "Kp_current",       e_reg_float  },
+    { REG_ADDR_PID_CURRENT_KI,   "Ki_current",       e_reg_float  },
+    { REG_ADDR_PID_CURRENT_KD,   "Kd_current",       e_reg_float  },
+    { REG_ADDR_PID_VELOCITY_KP,  "Kp_velocity",      e_reg_float  },
+    { REG_ADDR_PID_VELOCITY_KI,  "Ki_velocity",      e_reg_float  },
+    { REG_ADDR_PID_VELOCITY_KD,  "Kd_velocity",      e_reg_float  },
+    { REG_ADDR_PID_POSITION_KP,  "Kp_position",      e_reg_float  },
+    { REG_ADDR_PID_POSITION_KI,  "Ki_position",      e_reg_float  },
+    { REG_ADDR_PID_POSITION_KD,  "Kd_position",      e_reg_float  },
+    { REG_ADDR_POLE_PAIRS,       "pole_pairs",       e_reg_uint16 },
+    { REG_ADDR_PHASE_RESISTANCE, "phase_resistance", e_reg_float  },
+    { REG_ADDR_PHASE_INDUCTANCE, "phase_inductance", e_reg_float  },
+    { REG_ADDR_TORQUE_CONSTANT,  "torque_constant",  e_reg_float  },
+    { REG_ADDR_CURRENT_LIMIT,    "current_limit",    e_reg_float  },
+    { REG_ADDR_VELOCITY_LIMIT,   "velocity_limit",   e_reg_float  },
+    { REG_ADDR_VOLTAGE_LIMIT,    "voltage_limit",    e_reg_float  },
+    { REG_ADDR_ENCODER_CPR,      "encoder_cpr",      e_reg_float  },
+    { REG_ADDR_ENCODER_OFFSET,   "encoder_offset",   e_reg_float  },
+    { REG_ADDR_OVER_VOLTAGE,     "over_voltage",     e_reg_float  },
+    { REG_ADDR_UNDER_VOLTAGE,    "under_voltage",    e_reg_float  },
+    { REG_ADDR_OVER_TEMP,        "over_temp",        e_reg_float  },
+    { REG_ADDR_CONTROL_MODE,     "control_mode",     e_reg_uint16 },
+    { REG_ADDR_RT_VELOCITY,      "velocity",         e_reg_float  },
+    { REG_ADDR_RT_POSITION,      "position",         e_reg_float  },
+    { REG_ADDR_RT_CURRENT_Q,     "current_q",        e_reg_float  },
+    { REG_ADDR_RT_CURRENT_D,     "current_d",        e_reg_float  },
+    { REG_ADDR_RT_VOLTAGE_BUS,   "voltage_bus",      e_reg_float  },
+    { REG_ADDR_RT_TEMPERATURE,   "temperature",      e_reg_float  },
+};
+
+const register_map_entry_t *register_map_find(quint16 addr)
+{
+    for (const register_map_entry_t &entry : s_register_map) {
+        if (entry.addr == addr) {
+            return &entry;
+        }
+        if (entry.addr > addr) {
+            break;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 两个16位寄存器合并为float
+ * @note 小端序: reg0为低16位
+ */
+float register_map_to_float(quint16 reg0, quint16 reg1)
+{
+    quint32 u = ((quint32)reg1 << 16) | reg0;
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/**
+ * @brief float拆分为两个16位寄存器
+ * @note 小端序: reg0存低16位
+ */
+void register_map_from_float(float value, quint16 &reg0, quint16 &reg1)
+{
+    quint32 u;
+    memcpy(&u, &value, sizeof(u));
+    reg0 = (quint16)(u & 0xFFFF);
+    reg1 = (quint16)(u >> 16);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file register_map.h
+ * @brief AxDr寄存器地址映射
+ * @note 地址定义供param_manager_t读写参数，映射表供抓包解析工具按名称、类型解码寄存器
+ * @note 不依赖串口与QObject，可单独链接
+ */
+
+#ifndef REGISTER_MAP_H
+#define REGISTER_MAP_H
+
+#include <QtGlobal>
+
+/* ============== 寄存器地址定义 ============== */
+/* PID参数寄存器地址 */
+#define REG_ADDR_PID_CURRENT_KP     0x0000
+#define REG_ADDR_PID_CURRENT_KI     0x0002
+#define REG_ADDR_PID_CURRENT_KD     0x0004
+#define REG_ADDR_PID_VELOCITY_KP    0x0006
+#define REG_ADDR_PID_VELOCITY_KI    0x0008
+#define REG_ADDR_PID_VELOCITY_KD    0x000A
+#define REG_ADDR_PID_POSITION_KP    0x000C
+#define REG_ADDR_PID_POSITION_KI    0x000E
+#define REG_ADDR_PID_POSITION_KD    0x0010
+
+/* 电机参数寄存器地址 */
+#define REG_ADDR_POLE_PAIRS         0x0020
+#define REG_ADDR_PHASE_RESISTANCE   0x0022
+#define REG_ADDR_PHASE_INDUCTANCE   0x0024
+#define REG_ADDR_TORQUE_CONSTANT    0x0026
+
+/* 限制参数寄存器地址 */
+#define REG_ADDR_CURRENT_LIMIT      0x0030
+#define REG_ADDR_VELOCITY_LIMIT     0x0032
+#define REG_ADDR_VOLTAGE_LIMIT      0x0034
+
+/* 编码器参数寄存器地址 */
+#define REG_ADDR_ENCODER_CPR        0x0040
+#define REG_ADDR_ENCODER_OFFSET     0x0042
+
+/* 保护参数寄存器地址 */
+#define REG_ADDR_OVER_VOLTAGE       0x0050
+#define REG_ADDR_UNDER_VOLTAGE      0x0052
+#define REG_ADDR_OVER_TEMP          0x0054
+
+/* 控制模式寄存器地址 */
+#define REG_ADDR_CONTROL_MODE       0x0060
+
+/* 实时数据寄存器地址（只读） */
+#define REG_ADDR_RT_VELOCITY        0x0100
+#define REG_ADDR_RT_POSITION        0x0102
+#define REG_ADDR_RT_CURRENT_Q       0x0104
+#define REG_ADDR_RT_CURRENT_D       0x0106
+#define REG_ADDR_RT_VOLTAGE_BUS     0x0108
+#define REG_ADDR_RT_TEMPERATURE     0x010A
+
+/* 寄存器数据类型 */
+typedef enum {
+    e_reg_uint16 = 0,     /* 单寄存器无符号整数 */
+    e_reg_float           /* 两个寄存器组成的float（低16位在前） */
+} register_type_E;
+
+/* 寄存器映射表项 */
+typedef struct {
+    quint16 addr;           /* 起始地址 */
+    const char *name;       /* 名称（与docs/protocol.md一致） */
+    register_type_E type;   /* 数据类型 */
+} register_map_entry_t;
+
+/* 按起始地址查找映射表项，未定义或非起始地址时返回nullptr */
+const register_map_entry_t *register_map_find(quint16 addr);
+
+/* 两个寄存器与float互转（reg0为低16位） */
+float register_map_to_float(quint16 reg0, quint16 reg1);
+void register_map_from_float(float value, quint16 &reg0, quint16 &reg1);
+
+#endif /* REGISTER_MAP_H */
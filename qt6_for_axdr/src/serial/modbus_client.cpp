@@ -6,7 +6,9 @@
 
 #include "modbus_client.h"
 #include "log/comm_logger.h"
+#include "log/modbus_capture.h"
 #include <QDebug>
+#include <cmath>
 
 modbus_client_t::modbus_client_t(QObject *parent)
     : QObject(parent)
@@ -14,11 +16,19 @@ modbus_client_t::modbus_client_t(QObject *parent)
     , m_state(e_disconnected)
     , m_is_busy(false)
     , m_timeout_timer(nullptr)
+    , m_frame_timer(nullptr)
+    , m_rx_state(e_rx_idle)
+    , m_rx_gap_error(false)
+    , m_t15_us(750)
+    , m_t35_us(1750)
     , m_reconnect_timer(nullptr)
     , m_reconnect_attempts(0)
+    , m_rx_len(0)
     , m_expected_response_len(0)
     , m_current_start_addr(0)
     , m_current_function_code(0)
+    , m_current()
+    , m_capture(nullptr)
 {
     m_serial_port = new QSerialPort(this);
     
@@ -33,6 +43,12 @@ modbus_client_t::modbus_client_t(QObject *parent)
     connect(m_timeout_timer, &QTimer::timeout,
             this, &modbus_client_t::slot_on_timeout);
     
+    m_frame_timer = new QTimer(this);
+    m_frame_timer->setSingleShot(true);
+    m_frame_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_frame_timer, &QTimer::timeout,
+            this, &modbus_client_t::slot_on_frame_timer);
+    
     m_reconnect_timer = new QTimer(this);
     connect(m_reconnect_timer, &QTimer::timeout,
             this, &modbus_client_t::slot_reconnect_timer);
@@ -41,6 +57,7 @@ modbus_client_t::modbus_client_t(QObject *parent)
 modbus_client_t::~modbus_client_t()
 {
     disconnect_device();
+    stop_capture();
 }
 
 /**
@@ -57,8 +74,12 @@ bool modbus_client_t::connect_device(const serial_config_t &config)
     if (m_serial_port->isOpen()) {
         m_serial_port->close();
     }
+    
+    /* 重新连接时放弃未完成的事务 */
+    abort_transactions();
 
     m_config = config;
+    update_frame_timing();
     m_state = e_connecting;
     emit signal_connection_changed(m_state);
 
@@ -95,11 +116,9 @@ void modbus_client_t::disconnect_device()
 {
     QMutexLocker locker(&m_mutex);
     
-    m_timeout_timer->stop();
     m_reconnect_timer->stop();
     m_reconnect_attempts = 0;
-    m_recv_buffer.clear();
-    m_is_busy = false;
+    abort_transactions();
     
     if (m_serial_port->isOpen()) {
         m_serial_port->close();
@@ -119,12 +138,45 @@ serial_config_t modbus_client_t::get_current_config() const
     return m_config;
 }
 
+/**
+ * @brief 开始抓包
+ * @param file_path 抓包文件路径（.axcap）
+ * @note 与连接状态无关，断开重连期间继续记录
+ */
+bool modbus_client_t::start_capture(const QString &file_path)
+{
+    QMutexLocker locker(&m_mutex);
+    
+    stop_capture();
+    modbus_capture_t *capture = new modbus_capture_t();
+    if (!capture->open(file_path, e_capture_master)) {
+        delete capture;
+        emit signal_error_occurred(QString("无法创建抓包文件: %1").arg(file_path));
+        return false;
+    }
+    m_capture = capture;
+    return true;
+}
+
+/**
+ * @brief 停止抓包
+ */
+void modbus_client_t::stop_capture()
+{
+    QMutexLocker locker(&m_mutex);
+    
+    delete m_capture;
+    m_capture = nullptr;
+}
+
 /**
  * @brief 读取保持寄存器
  * @param start_addr 起始地址
  * @param count 读取数量
+ * @param priority 事务优先级
  */
-void modbus_client_t::read_holding_registers(int start_addr, quint16 count)
+void modbus_client_t::read_holding_registers(int start_addr, quint16 count,
+                                             transaction_priority_E priority)
 {
     QMutexLocker locker(&m_mutex);
     
@@ -132,34 +184,31 @@ void modbus_client_t::read_holding_registers(int start_addr, quint16 count)
         emit signal_error_occurred("未连接设备，无法读取");
         return;
     }
-    
-    /* 检查是否正在等待响应 */
-    if (m_is_busy) {
-        qDebug() << "[modbus_client] 请求被跳过(繁忙中), 地址:" << start_addr;
+    if (count == 0 || count > MODBUS_MAX_READ_REGISTERS) {
+        emit signal_error_occurred(QString("读取数量超出范围: %1").arg(count));
         return;
     }
 
-    QByteArray request = build_read_request(m_config.server_address, start_addr, count);
-    
-    m_recv_buffer.clear();
-    m_current_start_addr = start_addr;
-    m_current_function_code = MODBUS_FC_READ_HOLDING_REGISTERS;
-    m_expected_response_len = 5 + count * 2;  /* 地址+功能码+字节数+数据+CRC */
-    m_is_busy = true;
-    
-    comm_logger_t::instance()->log_send(request, 
-        QString("读取寄存器 地址:0x%1 数量:%2").arg(start_addr, 4, 16, QChar('0')).arg(count));
+    modbus_transaction_t transaction;
+    transaction.function_code = MODBUS_FC_READ_HOLDING_REGISTERS;
+    transaction.start_addr = start_addr;
+    transaction.count = count;
+    transaction.priority = priority;
+    transaction.retries_left = m_config.retry_count;
     
-    m_serial_port->write(request);
-    m_timeout_timer->start(m_config.response_timeout);
+    if (enqueue_transaction(transaction)) {
+        process_queue();
+    }
 }
 
 /**
  * @brief 写入单个保持寄存器
  * @param addr 寄存器地址
  * @param value 写入值
+ * @param priority 事务优先级
  */
-void modbus_client_t::write_holding_register(int addr, quint16 value)
+void modbus_client_t::write_holding_register(int addr, quint16 value,
+                                             transaction_priority_E priority)
 {
     QMutexLocker locker(&m_mutex);
     
@@ -167,33 +216,28 @@ void modbus_client_t::write_holding_register(int addr, quint16 value)
         emit signal_error_occurred("未连接设备，无法写入");
         return;
     }
-    
-    if (m_is_busy) {
-        qDebug() << "[modbus_client] 写入请求被跳过(繁忙中), 地址:" << addr;
-        return;
-    }
 
-    QByteArray request = build_write_single_request(m_config.server_address, addr, value);
-    
-    m_recv_buffer.clear();
-    m_current_start_addr = addr;
-    m_current_function_code = MODBUS_FC_WRITE_SINGLE_REGISTER;
-    m_expected_response_len = 8;  /* 固定8字节响应 */
-    m_is_busy = true;
+    modbus_transaction_t transaction;
+    transaction.function_code = MODBUS_FC_WRITE_SINGLE_REGISTER;
+    transaction.start_addr = addr;
+    transaction.count = 1;
+    transaction.values.append(value);
+    transaction.priority = priority;
+    transaction.retries_left = m_config.retry_count;
     
-    comm_logger_t::instance()->log_send(request, 
-        QString("写单个寄存器 地址:0x%1 值:%2").arg(addr, 4, 16, QChar('0')).arg(value));
-    
-    m_serial_port->write(request);
-    m_timeout_timer->start(m_config.response_timeout);
+    if (enqueue_transaction(transaction)) {
+        process_queue();
+    }
 }
 
 /**
  * @brief 写入多个保持寄存器
  * @param start_addr 起始地址
  * @param values 写入值列表
+ * @param priority 事务优先级
  */
-void modbus_client_t::write_holding_registers(int start_addr, const QVector<quint16> &values)
+void modbus_client_t::write_holding_registers(int start_addr, const QVector<quint16> &values,
+                                              transaction_priority_E priority)
 {
     QMutexLocker locker(&m_mutex);
     
@@ -201,183 +245,269 @@ void modbus_client_t::write_holding_registers(int start_addr, const QVector<quin
         emit signal_error_occurred("未连接设备，无法写入");
         return;
     }
-    
-    if (m_is_busy) {
-        qDebug() << "[modbus_client] 批量写入请求被跳过(繁忙中), 地址:" << start_addr;
+    if (values.isEmpty() || values.size() > MODBUS_MAX_WRITE_REGISTERS) {
+        emit signal_error_occurred(QString("写入数量超出范围: %1").arg(values.size()));
         return;
     }
 
-    QByteArray request = build_write_multiple_request(m_config.server_address, start_addr, values);
-    
-    m_recv_buffer.clear();
-    m_current_start_addr = start_addr;
-    m_current_function_code = MODBUS_FC_WRITE_MULTIPLE_REGISTERS;
-    m_expected_response_len = 8;  /* 固定8字节响应 */
-    m_is_busy = true;
+    modbus_transaction_t transaction;
+    transaction.function_code = MODBUS_FC_WRITE_MULTIPLE_REGISTERS;
+    transaction.start_addr = start_addr;
+    transaction.count = values.size();
+    transaction.values = values;
+    transaction.priority = priority;
+    transaction.retries_left = m_config.retry_count;
     
-    QString values_str;
-    for (int i = 0; i < values.size(); ++i) {
-        values_str += QString("%1 ").arg(values[i], 4, 16, QChar('0')).toUpper();
+    if (enqueue_transaction(transaction)) {
+        process_queue();
     }
-    comm_logger_t::instance()->log_send(request, 
-        QString("写多个寄存器 地址:0x%1 数量:%2 值:[%3]")
-            .arg(start_addr, 4, 16, QChar('0')).arg(values.size()).arg(values_str.trimmed()));
-    
-    m_serial_port->write(request);
-    m_timeout_timer->start(m_config.response_timeout);
 }
 
-/* ============== 协议构建函数 ============== */
-
 /**
- * @brief 构建读取寄存器请求帧
+ * @brief 待发送事务数（不含正在等待响应的事务）
  */
-QByteArray modbus_client_t::build_read_request(quint8 slave_addr, quint16 start_addr, quint16 count)
+int modbus_client_t::pending_count() const
 {
-    QByteArray frame;
-    frame.append(slave_addr);
-    frame.append(MODBUS_FC_READ_HOLDING_REGISTERS);
-    frame.append((start_addr >> 8) & 0xFF);
-    frame.append(start_addr & 0xFF);
-    frame.append((count >> 8) & 0xFF);
-    frame.append(count & 0xFF);
-    
-    quint16 crc = calc_crc16(frame);
-    frame.append(crc & 0xFF);
-    frame.append((crc >> 8) & 0xFF);
-    
-    return frame;
+    int count = 0;
+    for (int i = 0; i < e_priority_count; ++i) {
+        count += m_queues[i].size();
+    }
+    return count;
 }
 
 /**
- * @brief 构建写入单个寄存器请求帧
+ * @brief 清空待发送事务（正在等待响应的事务不受影响）
+ * @note 被丢弃的写请求逐个发送signal_write_completed(addr, false)
  */
-QByteArray modbus_client_t::build_write_single_request(quint8 slave_addr, quint16 addr, quint16 value)
+void modbus_client_t::clear_pending()
 {
-    QByteArray frame;
-    frame.append(slave_addr);
-    frame.append(MODBUS_FC_WRITE_SINGLE_REGISTER);
-    frame.append((addr >> 8) & 0xFF);
-    frame.append(addr & 0xFF);
-    frame.append((value >> 8) & 0xFF);
-    frame.append(value & 0xFF);
-    
-    quint16 crc = calc_crc16(frame);
-    frame.append(crc & 0xFF);
-    frame.append((crc >> 8) & 0xFF);
-    
-    return frame;
+    QMutexLocker locker(&m_mutex);
+    
+    /* 先取出再发信号，槽函数中重新提交的请求不受影响 */
+    QQueue<modbus_transaction_t> dropped[e_priority_count];
+    for (int i = 0; i < e_priority_count; ++i) {
+        dropped[i].swap(m_queues[i]);
+    }
+    for (int i = 0; i < e_priority_count; ++i) {
+        for (const modbus_transaction_t &transaction : dropped[i]) {
+            if (transaction.function_code != MODBUS_FC_READ_HOLDING_REGISTERS) {
+                emit signal_write_completed(transaction.start_addr, false);
+            }
+        }
+    }
 }
 
+/* ============== 事务调度 ============== */
+
 /**
- * @brief 构建写入多个寄存器请求帧
+ * @brief 事务入队
+ * @return 是否新增了事务（与已有读请求合并或队列已满时返回false）
+ * @note 队列已满时移除一条后台轮询读为更高优先级请求腾出位置；无法腾出时被拒绝的写请求报告写入失败
+ * @note 相同地址、数量的读请求只保留一个；新请求优先级更高时提升到新优先级
  */
-QByteArray modbus_client_t::build_write_multiple_request(quint8 slave_addr, quint16 start_addr,
-                                                          const QVector<quint16> &values)
+bool modbus_client_t::enqueue_transaction(const modbus_transaction_t &transaction)
 {
-    QByteArray frame;
-    frame.append(slave_addr);
-    frame.append(MODBUS_FC_WRITE_MULTIPLE_REGISTERS);
-    frame.append((start_addr >> 8) & 0xFF);
-    frame.append(start_addr & 0xFF);
-    
-    quint16 count = values.size();
-    frame.append((count >> 8) & 0xFF);
-    frame.append(count & 0xFF);
-    
-    quint8 byte_count = count * 2;
-    frame.append(byte_count);
-    
-    for (quint16 value : values) {
-        frame.append((value >> 8) & 0xFF);
-        frame.append(value & 0xFF);
+    if (transaction.function_code == MODBUS_FC_READ_HOLDING_REGISTERS) {
+        for (int p = 0; p < e_priority_count; ++p) {
+            QQueue<modbus_transaction_t> &queue = m_queues[p];
+            for (int i = 0; i < queue.size(); ++i) {
+                const modbus_transaction_t &pending = queue[i];
+                if (pending.function_code != MODBUS_FC_READ_HOLDING_REGISTERS ||
+                    pending.start_addr != transaction.start_addr ||
+                    pending.count != transaction.count) {
+                    continue;
+                }
+                if (p <= transaction.priority) {
+                    return false;
+                }
+                queue.removeAt(i);
+                m_queues[transaction.priority].enqueue(transaction);
+                return true;
+            }
+        }
     }
     
-    quint16 crc = calc_crc16(frame);
-    frame.append(crc & 0xFF);
-    frame.append((crc >> 8) & 0xFF);
+    if (pending_count() >= MAX_PENDING_TRANSACTIONS && !evict_low_priority_read(transaction.priority)) {
+        qDebug() << "[modbus_client] 事务队列已满，请求被丢弃, 地址:" << transaction.start_addr;
+        emit signal_error_occurred("事务队列已满，请求被丢弃");
+        if (transaction.function_code != MODBUS_FC_READ_HOLDING_REGISTERS) {
+            emit signal_write_completed(transaction.start_addr, false);
+        }
+        return false;
+    }
     
-    return frame;
+    m_queues[transaction.priority].enqueue(transaction);
+    return true;
 }
 
 /**
- * @brief 计算CRC16校验值
- * @note Modbus RTU使用CRC-16/MODBUS多项式
+ * @brief 队列已满时为更高优先级的请求腾出位置
+ * @return 是否移除了一条后台轮询读请求
+ * @note 移除最近入队的一条，轮询读在下一周期会重新提交
  */
-quint16 modbus_client_t::calc_crc16(const QByteArray &data)
+bool modbus_client_t::evict_low_priority_read(transaction_priority_E priority)
 {
-    quint16 crc = 0xFFFF;
-    
-    for (int i = 0; i < data.size(); ++i) {
-        crc ^= (quint8)data[i];
-        for (int j = 0; j < 8; ++j) {
-            if (crc & 0x0001) {
-                crc = (crc >> 1) ^ 0xA001;
-            } else {
-                crc >>= 1;
-            }
+    if (priority >= e_priority_low) {
+        return false;
+    }
+    QQueue<modbus_transaction_t> &queue = m_queues[e_priority_low];
+    for (int i = queue.size() - 1; i >= 0; --i) {
+        if (queue[i].function_code == MODBUS_FC_READ_HOLDING_REGISTERS) {
+            qDebug() << "[modbus_client] 事务队列已满，移除轮询读请求, 地址:" << queue[i].start_addr;
+            queue.removeAt(i);
+            return true;
         }
     }
-    
-    return crc;
+    return false;
 }
 
-/* ============== 响应解析函数 ============== */
-
 /**
- * @brief 解析读取响应
+ * @brief 总线空闲时发送优先级最高的待发送事务
  */
-bool modbus_client_t::parse_read_response(const QByteArray &response, QVector<quint16> &values)
+void modbus_client_t::process_queue()
 {
-    if (response.size() < 5) {
-        return false;
+    if (m_is_busy || m_rx_state == e_rx_turnaround || m_state != e_connected) {
+        return;
     }
     
-    /* 验证CRC */
-    QByteArray data_part = response.left(response.size() - 2);
-    quint16 recv_crc = ((quint8)response[response.size()-1] << 8) | (quint8)response[response.size()-2];
-    if (calc_crc16(data_part) != recv_crc) {
-        return false;
+    for (int p = 0; p < e_priority_count; ++p) {
+        if (!m_queues[p].isEmpty()) {
+            m_current = m_queues[p].dequeue();
+            send_transaction();
+            return;
+        }
     }
-    
-    /* 检查功能码 */
-    if ((quint8)response[1] != MODBUS_FC_READ_HOLDING_REGISTERS) {
-        return false;
+}
+
+/**
+ * @brief 发送当前事务（首次发送与重试共用）
+ */
+void modbus_client_t::send_transaction()
+{
+    quint8 request[MODBUS_RTU_MAX_ADU];
+    int len = 0;
+    
+    switch (m_current.function_code) {
+    case MODBUS_FC_READ_HOLDING_REGISTERS:
+        len = modbus_build_read_request(request, sizeof(request), m_config.server_address,
+                                        m_current.start_addr, m_current.count);
+        m_expected_response_len = 5 + m_current.count * 2;  /* 地址+功能码+字节数+数据+CRC */
+        break;
+    case MODBUS_FC_WRITE_SINGLE_REGISTER:
+        len = modbus_build_write_single(request, sizeof(request), m_config.server_address,
+                                        m_current.start_addr, m_current.values.value(0));
+        m_expected_response_len = 8;  /* 固定8字节响应 */
+        break;
+    default:
+        len = modbus_build_write_multiple_request(request, sizeof(request), m_config.server_address,
+                                                  m_current.start_addr, m_current.values.constData(),
+                                                  m_current.values.size());
+        m_expected_response_len = 8;  /* 固定8字节响应 */
+        break;
     }
     
-    quint8 byte_count = (quint8)response[2];
-    int reg_count = byte_count / 2;
+    m_rx_len = 0;
+    m_current_start_addr = m_current.start_addr;
+    m_current_function_code = m_current.function_code;
+    m_is_busy = true;
+    m_rx_state = e_rx_waiting;
+    m_rx_gap_error = false;
     
-    values.clear();
-    for (int i = 0; i < reg_count; ++i) {
-        quint16 value = ((quint8)response[3 + i*2] << 8) | (quint8)response[4 + i*2];
-        values.append(value);
+    /* 只记录原始帧，描述文本在导出时由帧内容生成 */
+    comm_logger_t::instance()->log_send(request, len);
+    if (m_capture) {
+        m_capture->record(e_capture_request, request, len);
     }
     
-    return true;
+    m_serial_port->write(reinterpret_cast<const char *>(request), len);
+    m_timeout_timer->start(m_config.response_timeout);
 }
 
 /**
- * @brief 解析写入响应
+ * @brief 当前事务结束，t3.5静默期后继续发送下一个
  */
-bool modbus_client_t::parse_write_response(const QByteArray &response)
+void modbus_client_t::finish_transaction()
 {
-    if (response.size() < 8) {
-        return false;
+    m_timeout_timer->stop();
+    m_rx_len = 0;
+    m_is_busy = false;
+    
+    m_rx_state = e_rx_turnaround;
+    m_frame_timer->start(frame_gap_ms());
+}
+
+/**
+ * @brief 放弃正在进行及排队中的全部事务（断开、重连、串口错误）
+ * @note 正在等待响应的写请求与队列中的写请求均发送失败的完成信号
+ */
+void modbus_client_t::abort_transactions()
+{
+    m_timeout_timer->stop();
+    m_frame_timer->stop();
+    m_rx_state = e_rx_idle;
+    m_rx_len = 0;
+    
+    if (m_is_busy) {
+        m_is_busy = false;
+        if (m_current_function_code != MODBUS_FC_READ_HOLDING_REGISTERS) {
+            emit signal_write_completed(m_current_start_addr, false);
+        }
+    }
+    clear_pending();
+}
+
+/**
+ * @brief 按串口参数计算RTU帧定时
+ * @note 字符时间 = (起始位 + 数据位 + 校验位 + 停止位) / 波特率
+ * @note 波特率高于19200时按规范取固定值 t1.5 = 750us、t3.5 = 1750us
+ */
+void modbus_client_t::update_frame_timing()
+{
+    if (m_config.baud_rate <= 0 || m_config.baud_rate > 19200) {
+        m_t15_us = 750;
+        m_t35_us = 1750;
+        return;
     }
     
-    /* 验证CRC */
-    QByteArray data_part = response.left(response.size() - 2);
-    quint16 recv_crc = ((quint8)response[response.size()-1] << 8) | (quint8)response[response.size()-2];
-    if (calc_crc16(data_part) != recv_crc) {
-        return false;
+    double bits = 1.0 + (int)m_config.data_bits;
+    if (m_config.parity != QSerialPort::NoParity) {
+        bits += 1.0;
+    }
+    switch (m_config.stop_bits) {
+    case QSerialPort::TwoStop:        bits += 2.0; break;
+    case QSerialPort::OneAndHalfStop: bits += 1.5; break;
+    default:                          bits += 1.0; break;
     }
     
-    /* 检查是否为异常响应 */
-    if ((quint8)response[1] & 0x80) {
+    const double char_us = bits * 1e6 / m_config.baud_rate;
+    m_t15_us = (int)std::ceil(1.5 * char_us);
+    m_t35_us = (int)std::ceil(3.5 * char_us);
+}
+
+/**
+ * @brief 按serial_config_t::retry_count重发当前事务
+ * @param reason 失败原因（写入日志）
+ * @return 是否将重发（重试次数用尽时返回false）
+ */
+bool modbus_client_t::retry_transaction(const QString &reason)
+{
+    if (m_current.retries_left <= 0 || m_state != e_connected) {
         return false;
     }
     
+    m_current.retries_left--;
+    comm_logger_t *logger = comm_logger_t::instance();
+    if (logger->is_logging()) {
+        logger->log_info(QString("%1，重试 地址:0x%2 剩余:%3次")
+                             .arg(reason).arg(m_current.start_addr, 4, 16, QChar('0'))
+                             .arg(m_current.retries_left));
+    }
+    
+    /* 保持繁忙，t3.5静默期后重发 */
+    m_timeout_timer->stop();
+    m_rx_len = 0;
+    m_rx_state = e_rx_turnaround;
+    m_frame_timer->start(frame_gap_ms());
     return true;
 }
 
@@ -385,47 +515,131 @@ bool modbus_client_t::parse_write_response(const QByteArray &response)
 
 /**
  * @brief 串口数据接收槽
+ * @note 按帧头推算的长度收满且CRC正确即结束本帧（含5字节异常响应），
+ *       否则以t3.5字符静默作为帧结束
  */
 void modbus_client_t::slot_on_ready_read()
 {
-    m_recv_buffer.append(m_serial_port->readAll());
+    /* 未在等待响应时收到的数据直接丢弃（抓包时保留，便于排查总线干扰） */
+    if (m_rx_state != e_rx_waiting && m_rx_state != e_rx_receiving) {
+        QByteArray stray = m_serial_port->readAll();
+        if (m_capture && !stray.isEmpty()) {
+            m_capture->record(e_capture_response,
+                              reinterpret_cast<const quint8 *>(stray.constData()), stray.size());
+        }
+        return;
+    }
     
-    /* 检查是否接收完整 */
-    if (m_recv_buffer.size() >= m_expected_response_len) {
+    if (m_rx_state == e_rx_waiting) {
+        /* 收到首字节，此后由字符间隔判定帧结束 */
         m_timeout_timer->stop();
-        m_is_busy = false;  /* 清除繁忙标志 */
-        
-        comm_logger_t::instance()->log_recv(m_recv_buffer, 
-            QString("响应 功能码:0x%1").arg(m_current_function_code, 2, 16, QChar('0')));
-        
-        if (m_current_function_code == MODBUS_FC_READ_HOLDING_REGISTERS) {
-            QVector<quint16> values;
-            if (parse_read_response(m_recv_buffer, values)) {
-                QString values_str;
-                for (int i = 0; i < values.size(); ++i) {
-                    values_str += QString("%1 ").arg(values[i], 4, 16, QChar('0')).toUpper();
-                }
-                comm_logger_t::instance()->log_info(
-                    QString("解析成功 地址:0x%1 值:[%2]")
-                        .arg(m_current_start_addr, 4, 16, QChar('0')).arg(values_str.trimmed()));
-                emit signal_read_completed(m_current_start_addr, values);
-            } else {
-                comm_logger_t::instance()->log_error("读取响应解析失败");
-                emit signal_error_occurred("读取响应解析失败");
+        m_rx_state = e_rx_receiving;
+    } else if (m_char_timer.nsecsElapsed() / 1000 > m_t15_us) {
+        /* 帧内字符间隔超过t1.5（USB串口按块上报时也会出现，仅作诊断） */
+        m_rx_gap_error = true;
+    }
+    m_char_timer.start();
+    
+    /* 直接读入接收缓冲区，超出RTU帧最大长度的部分丢弃（该帧必然校验失败） */
+    qint64 n = m_serial_port->read(reinterpret_cast<char *>(m_rx_frame + m_rx_len),
+                                   MODBUS_RTU_MAX_ADU - m_rx_len);
+    if (n > 0) {
+        m_rx_len += (int)n;
+    }
+    if (m_rx_len >= MODBUS_RTU_MAX_ADU) {
+        m_serial_port->readAll();
+    }
+    
+    int len = modbus_response_length(m_rx_frame, m_rx_len);
+    if (len > 0 && m_rx_len == len && modbus_verify_crc(m_rx_frame, m_rx_len)) {
+        m_frame_timer->stop();
+        handle_frame();
+        return;
+    }
+    
+    m_frame_timer->start(frame_gap_ms());
+}
+
+/**
+ * @brief 处理接收完成的响应帧
+ */
+void modbus_client_t::handle_frame()
+{
+    m_rx_state = e_rx_idle;
+    
+    comm_logger_t::instance()->log_recv(m_rx_frame, m_rx_len);
+    if (m_capture) {
+        m_capture->record(e_capture_response, m_rx_frame, m_rx_len);
+    }
+    
+    /* 帧尾多余字节：按帧头长度截取 */
+    int len = modbus_response_length(m_rx_frame, m_rx_len);
+    if (len > 0 && m_rx_len > len && modbus_verify_crc(m_rx_frame, len)) {
+        m_rx_len = len;
+    }
+    
+    if (!modbus_verify_crc(m_rx_frame, m_rx_len)) {
+        QString reason = m_rx_gap_error ? "响应帧校验失败(字符间隔超过t1.5)" : "响应帧校验失败";
+        if (retry_transaction(reason)) {
+            return;
+        }
+        comm_logger_t::instance()->log_error(reason);
+        emit signal_error_occurred(reason);
+        if (m_current_function_code != MODBUS_FC_READ_HOLDING_REGISTERS) {
+            emit signal_write_completed(m_current_start_addr, false);
+        }
+        finish_transaction();
+        return;
+    }
+    
+    modbus_adu_t adu;
+    bool parsed = modbus_parse_response(m_rx_frame, m_rx_len, adu);
+    
+    /* 异常响应：从机已明确拒绝，不重试 */
+    if (parsed && adu.exception_code != 0 && (adu.function_code & 0x7F) == m_current_function_code) {
+        QString msg = QString("从机异常响应 功能码:0x%1 异常码:0x%2")
+                          .arg(adu.function_code, 2, 16, QChar('0'))
+                          .arg(adu.exception_code, 2, 16, QChar('0'));
+        comm_logger_t::instance()->log_error(msg);
+        emit signal_error_occurred(msg);
+        if (m_current_function_code != MODBUS_FC_READ_HOLDING_REGISTERS) {
+            emit signal_write_completed(m_current_start_addr, false);
+        }
+        finish_transaction();
+        return;
+    }
+    
+    parsed = parsed && adu.function_code == m_current_function_code &&
+             m_rx_len == m_expected_response_len;
+    
+    if (m_current_function_code == MODBUS_FC_READ_HOLDING_REGISTERS) {
+        if (parsed) {
+            QVector<quint16> values(adu.count);
+            for (int i = 0; i < adu.count; ++i) {
+                values[i] = modbus_register(adu, i);
             }
+            emit signal_read_completed(m_current_start_addr, values);
+        } else {
+            if (retry_transaction("读取响应解析失败")) {
+                return;
+            }
+            comm_logger_t::instance()->log_error("读取响应解析失败");
+            emit signal_error_occurred("读取响应解析失败");
+        }
+    } else {
+        if (parsed) {
+            emit signal_write_completed(m_current_start_addr, true);
         } else {
-            if (parse_write_response(m_recv_buffer)) {
-                comm_logger_t::instance()->log_info("写入成功");
-                emit signal_write_completed(m_current_start_addr, true);
-            } else {
-                comm_logger_t::instance()->log_error("写入响应解析失败");
-                emit signal_error_occurred("写入响应解析失败");
-                emit signal_write_completed(m_current_start_addr, false);
+            if (retry_transaction("写入响应解析失败")) {
+                return;
             }
+            comm_logger_t::instance()->log_error("写入响应解析失败");
+            emit signal_error_occurred("写入响应解析失败");
+            emit signal_write_completed(m_current_start_addr, false);
         }
-        
-        m_recv_buffer.clear();
     }
+    
+    finish_transaction();
 }
 
 /**
@@ -437,9 +651,7 @@ void modbus_client_t::slot_on_error_occurred(QSerialPort::SerialPortError error)
         return;
     }
     
-    m_timeout_timer->stop();
-    m_is_busy = false;  /* 清除繁忙标志 */
-    m_recv_buffer.clear();
+    abort_transactions();
     m_state = e_error;
     emit signal_connection_changed(m_state);
     emit signal_error_occurred(m_serial_port->errorString());
@@ -452,15 +664,37 @@ void modbus_client_t::slot_on_error_occurred(QSerialPort::SerialPortError error)
  */
 void modbus_client_t::slot_on_timeout()
 {
-    m_is_busy = false;  /* 清除繁忙标志 */
+    if (retry_transaction("通信超时")) {
+        return;
+    }
+    
     emit signal_error_occurred("通信超时");
-    m_recv_buffer.clear();
     
     if (m_current_function_code == MODBUS_FC_READ_HOLDING_REGISTERS) {
         /* 读取超时不发送完成信号 */
     } else {
         emit signal_write_completed(m_current_start_addr, false);
     }
+    
+    finish_transaction();
+}
+
+/**
+ * @brief 帧间隔定时器槽
+ * @note 接收中：t3.5静默，帧结束；静默期：期满后重发当前事务或发送下一请求
+ */
+void modbus_client_t::slot_on_frame_timer()
+{
+    if (m_rx_state == e_rx_receiving) {
+        handle_frame();
+    } else if (m_rx_state == e_rx_turnaround) {
+        m_rx_state = e_rx_idle;
+        if (m_is_busy) {
+            send_transaction();  /* 重试 */
+        } else {
+            process_queue();
+        }
+    }
 }
 
 /**
@@ -14,6 +14,11 @@
 #include <QVector>
 #include <QByteArray>
 #include <QMutex>
+#include <QQueue>
+#include <QElapsedTimer>
+#include "codec/modbus_codec.h"
+
+class modbus_capture_t;
 
 /* 连接状态枚举 */
 typedef enum {
@@ -35,10 +40,31 @@ typedef struct {
     int retry_count;                /* 重试次数 */
 } serial_config_t;
 
-/* Modbus功能码 */
-#define MODBUS_FC_READ_HOLDING_REGISTERS    0x03
-#define MODBUS_FC_WRITE_SINGLE_REGISTER     0x06
-#define MODBUS_FC_WRITE_MULTIPLE_REGISTERS  0x10
+/* RTU接收状态 */
+typedef enum {
+    e_rx_idle = 0,        /* 空闲 */
+    e_rx_waiting,         /* 已发送请求，等待首字节（受response_timeout约束） */
+    e_rx_receiving,       /* 接收中，字符间隔超过t3.5即帧结束 */
+    e_rx_turnaround       /* 帧结束后的t3.5静默期，期满后才发送下一请求 */
+} rx_state_E;
+
+/* 事务优先级（数值越小越先发送） */
+typedef enum {
+    e_priority_high = 0,    /* 用户写入 */
+    e_priority_normal,      /* 用户读取 */
+    e_priority_low,         /* 后台轮询 */
+    e_priority_count
+} transaction_priority_E;
+
+/* Modbus事务结构体 */
+typedef struct {
+    quint8 function_code;           /* 功能码 */
+    int start_addr;                 /* 起始地址 */
+    quint16 count;                  /* 读取数量（读请求） */
+    QVector<quint16> values;        /* 写入值（写请求） */
+    transaction_priority_E priority;/* 优先级 */
+    int retries_left;               /* 剩余重试次数 */
+} modbus_transaction_t;
 
 /**
  * @brief Modbus RTU客户端类
@@ -58,13 +84,27 @@ public:
     connection_state_E get_connection_state() const;
 
     /* 寄存器读写 - 异步操作 */
-    void read_holding_registers(int start_addr, quint16 count);
-    void write_holding_register(int addr, quint16 value);
-    void write_holding_registers(int start_addr, const QVector<quint16> &values);
+    /* 请求进入事务队列，总线空闲时按优先级依次发送；同优先级按提交顺序 */
+    /* 与队列中相同地址、数量的读请求合并，只执行一次 */
+    void read_holding_registers(int start_addr, quint16 count,
+                                transaction_priority_E priority = e_priority_normal);
+    void write_holding_register(int addr, quint16 value,
+                                transaction_priority_E priority = e_priority_high);
+    void write_holding_registers(int start_addr, const QVector<quint16> &values,
+                                 transaction_priority_E priority = e_priority_high);
+
+    /* 事务队列（清空时被丢弃的写请求发送失败的完成信号） */
+    int pending_count() const;
+    void clear_pending();
 
     /* 配置获取 */
     serial_config_t get_current_config() const;
 
+    /* 抓包（主站侧，收发帧原样写入.axcap文件） */
+    bool start_capture(const QString &file_path);
+    void stop_capture();
+    bool is_capturing() const { return m_capture != nullptr; }
+
 signals:
     /* 连接状态信号 */
     void signal_connection_changed(connection_state_E state);
@@ -78,19 +118,25 @@ private slots:
     void slot_on_ready_read();
     void slot_on_error_occurred(QSerialPort::SerialPortError error);
     void slot_on_timeout();
+    void slot_on_frame_timer();
     void slot_reconnect_timer();
 
 private:
-    /* 协议处理 */
-    QByteArray build_read_request(quint8 slave_addr, quint16 start_addr, quint16 count);
-    QByteArray build_write_single_request(quint8 slave_addr, quint16 addr, quint16 value);
-    QByteArray build_write_multiple_request(quint8 slave_addr, quint16 start_addr, 
-                                             const QVector<quint16> &values);
-    quint16 calc_crc16(const QByteArray &data);
-    bool parse_read_response(const QByteArray &response, QVector<quint16> &values);
-    bool parse_write_response(const QByteArray &response);
+    /* 协议处理（帧编解码见modbus_codec.h） */
+    void handle_frame();
+    void update_frame_timing();
+    int frame_gap_ms() const { return (m_t35_us + 999) / 1000; }  /* t3.5向上取整到定时器精度 */
     void handle_reconnect();
 
+    /* 事务调度 */
+    bool enqueue_transaction(const modbus_transaction_t &transaction);
+    bool evict_low_priority_read(transaction_priority_E priority);
+    void process_queue();
+    void send_transaction();
+    void finish_transaction();
+    bool retry_transaction(const QString &reason);
+    void abort_transactions();
+
 public:
     /* 检查是否正在等待响应 */
     bool is_busy() const { return m_is_busy; }
@@ -102,18 +148,30 @@ private:
     bool m_is_busy;                    /* 请求繁忙标志 */
     
     QTimer *m_timeout_timer;           /* 超时定时器 */
+    QTimer *m_frame_timer;             /* t3.5帧间隔定时器 */
+    QElapsedTimer m_char_timer;        /* 字符间隔计时（t1.5检查） */
+    rx_state_E m_rx_state;             /* RTU接收状态 */
+    bool m_rx_gap_error;               /* 当前帧内出现超过t1.5的字符间隔 */
+    int m_t15_us;                      /* t1.5 (us) */
+    int m_t35_us;                      /* t3.5 (us) */
     QTimer *m_reconnect_timer;         /* 重连定时器 */
     int m_reconnect_attempts;          /* 重连尝试次数 */
     
-    QByteArray m_recv_buffer;          /* 接收缓冲区 */
+    quint8 m_rx_frame[MODBUS_RTU_MAX_ADU];  /* 接收缓冲区（串口数据直接读入） */
+    int m_rx_len;                      /* 已接收字节数 */
     int m_expected_response_len;       /* 期望响应长度 */
     int m_current_start_addr;          /* 当前请求起始地址 */
     quint8 m_current_function_code;    /* 当前功能码 */
+    modbus_transaction_t m_current;    /* 当前事务 */
+    QQueue<modbus_transaction_t> m_queues[e_priority_count];  /* 各优先级待发送事务 */
+    
+    modbus_capture_t *m_capture;       /* 抓包文件（未抓包时为nullptr） */
     
     QRecursiveMutex m_mutex;           /* 线程安全锁（递归） */
 
     static const int MAX_RECONNECT_ATTEMPTS = 3;  /* 最大重连次数 */
     static const int RECONNECT_INTERVAL_MS = 2000;/* 重连间隔(ms) */
+    static const int MAX_PENDING_TRANSACTIONS = 64;/* 待发送事务上限 */
 };
 
 #endif /* MODBUS_CLIENT_H */
@@ -4,6 +4,7 @@
  */
 
 #include "modbus_slave.h"
+#include "log/modbus_capture.h"
 #include <QDebug>
 
 modbus_slave_t::modbus_slave_t(QObject *parent)
@@ -11,7 +12,9 @@ modbus_slave_t::modbus_slave_t(QObject *parent)
     , m_serial_port(nullptr)
     , m_slave_address(1)
     , m_state(e_slave_stopped)
+    , m_rx_len(0)
     , m_frame_timer(nullptr)
+    , m_capture(nullptr)
 {
     m_serial_port = new QSerialPort(this);
     m_frame_timer = new QTimer(this);
@@ -28,6 +31,7 @@ modbus_slave_t::modbus_slave_t(QObject *parent)
 modbus_slave_t::~modbus_slave_t()
 {
     stop_listening();
+    stop_capture();
 }
 
 bool modbus_slave_t::start_listening(const QString &port_name, qint32 baud_rate,
@@ -55,7 +59,7 @@ bool modbus_slave_t::start_listening(const QString &port_name, qint32 baud_rate,
         return false;
     }
 
-    m_recv_buffer.clear();
+    m_rx_len = 0;
     m_state = e_slave_running;
     emit signal_state_changed(m_state);
     return true;
@@ -67,7 +71,7 @@ void modbus_slave_t::stop_listening()
         m_serial_port->close();
     }
     m_frame_timer->stop();
-    m_recv_buffer.clear();
+    m_rx_len = 0;
     m_state = e_slave_stopped;
     emit signal_state_changed(m_state);
 }
@@ -135,9 +139,41 @@ void modbus_slave_t::clear_registers()
     m_registers.clear();
 }
 
+bool modbus_slave_t::start_capture(const QString &file_path)
+{
+    stop_capture();
+    modbus_capture_t *capture = new modbus_capture_t();
+    if (!capture->open(file_path, e_capture_slave)) {
+        delete capture;
+        emit signal_error_occurred(QString("无法创建抓包文件: %1").arg(file_path));
+        return false;
+    }
+    m_capture = capture;
+    return true;
+}
+
+void modbus_slave_t::stop_capture()
+{
+    delete m_capture;
+    m_capture = nullptr;
+}
+
+int modbus_slave_t::inject_request(const quint8 *request, int len)
+{
+    return process_request(request, len);
+}
+
 void modbus_slave_t::slot_on_ready_read()
 {
-    m_recv_buffer.append(m_serial_port->readAll());
+    /* 直接读入接收缓冲区，超出RTU帧最大长度的部分丢弃（该帧必然校验失败） */
+    qint64 n = m_serial_port->read(reinterpret_cast<char *>(m_rx_frame + m_rx_len),
+                                   MODBUS_RTU_MAX_ADU - m_rx_len);
+    if (n > 0) {
+        m_rx_len += static_cast<int>(n);
+    }
+    if (m_rx_len >= MODBUS_RTU_MAX_ADU) {
+        m_serial_port->readAll();
+    }
     m_frame_timer->start(FRAME_TIMEOUT_MS);
 }
 
@@ -155,196 +191,121 @@ void modbus_slave_t::slot_on_serial_error(QSerialPort::SerialPortError error)
 
 void modbus_slave_t::slot_process_frame()
 {
-    if (m_recv_buffer.isEmpty()) {
+    if (m_rx_len == 0) {
         return;
     }
 
-    emit signal_request_received(m_recv_buffer);
-    process_request(m_recv_buffer);
-    m_recv_buffer.clear();
+    if (m_capture) {
+        m_capture->record(e_capture_request, m_rx_frame, m_rx_len);
+    }
+    emit signal_request_received(
+        QByteArray::fromRawData(reinterpret_cast<const char *>(m_rx_frame), m_rx_len));
+
+    int response_len = process_request(m_rx_frame, m_rx_len);
+    m_rx_len = 0;
+
+    if (response_len > 0) {
+        m_serial_port->write(reinterpret_cast<const char *>(m_tx_frame), response_len);
+        if (m_capture) {
+            m_capture->record(e_capture_response, m_tx_frame, response_len);
+        }
+        emit signal_response_sent(
+            QByteArray::fromRawData(reinterpret_cast<const char *>(m_tx_frame), response_len));
+    }
 }
 
-void modbus_slave_t::process_request(const QByteArray &request)
+int modbus_slave_t::process_request(const quint8 *request, int len)
 {
     /* 最小帧长度检查: 地址(1) + 功能码(1) + 数据(至少2) + CRC(2) = 6 */
-    if (request.size() < 6) {
-        return;
+    if (len < 6) {
+        return 0;
     }
 
     /* CRC校验 */
-    if (!verify_crc(request)) {
-        return;
+    if (!modbus_verify_crc(request, len)) {
+        return 0;
     }
 
-    quint8 slave_addr = static_cast<quint8>(request[0]);
-    quint8 function_code = static_cast<quint8>(request[1]);
+    quint8 slave_addr = request[0];
+    quint8 function_code = request[1];
 
     /* 地址匹配检查 */
     if (slave_addr != m_slave_address && slave_addr != 0) {
-        return;
+        return 0;
     }
 
-    QByteArray response;
+    int response_len = 0;
+    modbus_adu_t adu;
 
-    switch (function_code) {
-    case MODBUS_FC_READ_HOLDING_REGISTERS: {
-        if (request.size() < 8) {
-            return;
-        }
-        quint16 start_addr = (static_cast<quint8>(request[2]) << 8) | static_cast<quint8>(request[3]);
-        quint16 count = (static_cast<quint8>(request[4]) << 8) | static_cast<quint8>(request[5]);
-        response = handle_read_holding_registers(start_addr, count);
-        break;
-    }
-    case MODBUS_FC_WRITE_SINGLE_REGISTER: {
-        if (request.size() < 8) {
-            return;
-        }
-        quint16 addr = (static_cast<quint8>(request[2]) << 8) | static_cast<quint8>(request[3]);
-        quint16 value = (static_cast<quint8>(request[4]) << 8) | static_cast<quint8>(request[5]);
-        response = handle_write_single_register(addr, value);
-        break;
-    }
-    case MODBUS_FC_WRITE_MULTIPLE_REGISTERS: {
-        if (request.size() < 9) {
-            return;
-        }
-        quint16 start_addr = (static_cast<quint8>(request[2]) << 8) | static_cast<quint8>(request[3]);
-        quint8 byte_count = static_cast<quint8>(request[6]);
-        if (request.size() < 9 + byte_count) {
-            return;
+    if (modbus_request_length(request, len) == 0) {
+        /* 不支持的功能码 */
+        response_len = build_exception_response(function_code, MODBUS_EX_ILLEGAL_FUNCTION);
+    } else if (!modbus_parse_request(request, len, adu)) {
+        return 0;
+    } else {
+        switch (function_code) {
+        case MODBUS_FC_READ_HOLDING_REGISTERS:
+            response_len = handle_read_holding_registers(adu.addr, adu.count);
+            break;
+        case MODBUS_FC_WRITE_SINGLE_REGISTER:
+            response_len = handle_write_single_register(adu.addr, adu.value);
+            break;
+        default:  /* MODBUS_FC_WRITE_MULTIPLE_REGISTERS */
+            response_len = handle_write_multiple_registers(adu);
+            break;
         }
-        QByteArray data = request.mid(7, byte_count);
-        response = handle_write_multiple_registers(start_addr, data);
-        break;
-    }
-    default:
-        response = build_exception_response(function_code, MODBUS_EX_ILLEGAL_FUNCTION);
-        break;
     }
 
-    if (!response.isEmpty() && slave_addr != 0) {
-        m_serial_port->write(response);
-        emit signal_response_sent(response);
-    }
+    /* 广播请求不响应 */
+    return slave_addr != 0 ? response_len : 0;
 }
 
-QByteArray modbus_slave_t::handle_read_holding_registers(quint16 start_addr, quint16 count)
+int modbus_slave_t::handle_read_holding_registers(quint16 start_addr, quint16 count)
 {
-    /* 检查寄存器范围 */
-    for (quint16 i = 0; i < count; ++i) {
-        if (!m_registers.contains(start_addr + i)) {
-            return build_exception_response(MODBUS_FC_READ_HOLDING_REGISTERS, MODBUS_EX_ILLEGAL_DATA_ADDRESS);
-        }
+    if (count == 0 || count > MODBUS_MAX_READ_REGISTERS) {
+        return build_exception_response(MODBUS_FC_READ_HOLDING_REGISTERS, MODBUS_EX_ILLEGAL_DATA_VALUE);
     }
 
-    QByteArray response;
-    response.append(static_cast<char>(m_slave_address));
-    response.append(static_cast<char>(MODBUS_FC_READ_HOLDING_REGISTERS));
-    response.append(static_cast<char>(count * 2));
-
+    /* 检查寄存器范围并取值 */
+    quint16 values[MODBUS_MAX_READ_REGISTERS];
     for (quint16 i = 0; i < count; ++i) {
-        quint16 value = m_registers[start_addr + i].value;
-        response.append(static_cast<char>((value >> 8) & 0xFF));
-        response.append(static_cast<char>(value & 0xFF));
+        auto it = m_registers.constFind(static_cast<quint16>(start_addr + i));
+        if (it == m_registers.constEnd()) {
+            return build_exception_response(MODBUS_FC_READ_HOLDING_REGISTERS, MODBUS_EX_ILLEGAL_DATA_ADDRESS);
+        }
+        values[i] = it->value;
     }
 
-    quint16 crc = calc_crc16(response);
-    response.append(static_cast<char>(crc & 0xFF));
-    response.append(static_cast<char>((crc >> 8) & 0xFF));
-
-    return response;
+    return modbus_build_read_response(m_tx_frame, sizeof(m_tx_frame), m_slave_address, values, count);
 }
 
-QByteArray modbus_slave_t::handle_write_single_register(quint16 addr, quint16 value)
+int modbus_slave_t::handle_write_single_register(quint16 addr, quint16 value)
 {
     /* 设置寄存器值 */
     set_register(addr, value);
 
     /* 响应与请求相同 */
-    QByteArray response;
-    response.append(static_cast<char>(m_slave_address));
-    response.append(static_cast<char>(MODBUS_FC_WRITE_SINGLE_REGISTER));
-    response.append(static_cast<char>((addr >> 8) & 0xFF));
-    response.append(static_cast<char>(addr & 0xFF));
-    response.append(static_cast<char>((value >> 8) & 0xFF));
-    response.append(static_cast<char>(value & 0xFF));
-
-    quint16 crc = calc_crc16(response);
-    response.append(static_cast<char>(crc & 0xFF));
-    response.append(static_cast<char>((crc >> 8) & 0xFF));
-
-    return response;
+    return modbus_build_write_single(m_tx_frame, sizeof(m_tx_frame), m_slave_address, addr, value);
 }
 
-QByteArray modbus_slave_t::handle_write_multiple_registers(quint16 start_addr, const QByteArray &data)
+int modbus_slave_t::handle_write_multiple_registers(const modbus_adu_t &request)
 {
-    quint16 count = data.size() / 2;
+    if (request.count == 0 || request.count > MODBUS_MAX_WRITE_REGISTERS) {
+        return build_exception_response(MODBUS_FC_WRITE_MULTIPLE_REGISTERS, MODBUS_EX_ILLEGAL_DATA_VALUE);
+    }
 
     /* 写入寄存器 */
-    for (quint16 i = 0; i < count; ++i) {
-        quint16 value = (static_cast<quint8>(data[i * 2]) << 8) | static_cast<quint8>(data[i * 2 + 1]);
-        set_register(start_addr + i, value);
+    for (quint16 i = 0; i < request.count; ++i) {
+        set_register(static_cast<quint16>(request.addr + i), modbus_register(request, i));
     }
 
     /* 构建响应 */
-    QByteArray response;
-    response.append(static_cast<char>(m_slave_address));
-    response.append(static_cast<char>(MODBUS_FC_WRITE_MULTIPLE_REGISTERS));
-    response.append(static_cast<char>((start_addr >> 8) & 0xFF));
-    response.append(static_cast<char>(start_addr & 0xFF));
-    response.append(static_cast<char>((count >> 8) & 0xFF));
-    response.append(static_cast<char>(count & 0xFF));
-
-    quint16 crc = calc_crc16(response);
-    response.append(static_cast<char>(crc & 0xFF));
-    response.append(static_cast<char>((crc >> 8) & 0xFF));
-
-    return response;
+    return modbus_build_write_multiple_response(m_tx_frame, sizeof(m_tx_frame), m_slave_address,
+                                                request.addr, request.count);
 }
 
-QByteArray modbus_slave_t::build_exception_response(quint8 function_code, quint8 exception_code)
+int modbus_slave_t::build_exception_response(quint8 function_code, quint8 exception_code)
 {
-    QByteArray response;
-    response.append(static_cast<char>(m_slave_address));
-    response.append(static_cast<char>(function_code | 0x80));
-    response.append(static_cast<char>(exception_code));
-
-    quint16 crc = calc_crc16(response);
-    response.append(static_cast<char>(crc & 0xFF));
-    response.append(static_cast<char>((crc >> 8) & 0xFF));
-
-    return response;
-}
-
-quint16 modbus_slave_t::calc_crc16(const QByteArray &data)
-{
-    quint16 crc = 0xFFFF;
-
-    for (int i = 0; i < data.size(); ++i) {
-        crc ^= static_cast<quint8>(data[i]);
-        for (int j = 0; j < 8; ++j) {
-            if (crc & 0x0001) {
-                crc = (crc >> 1) ^ 0xA001;
-            } else {
-                crc >>= 1;
-            }
-        }
-    }
-
-    return crc;
-}
-
-bool modbus_slave_t::verify_crc(const QByteArray &data)
-{
-    if (data.size() < 4) {
-        return false;
-    }
-
-    QByteArray data_without_crc = data.left(data.size() - 2);
-    quint16 calc_crc = calc_crc16(data_without_crc);
-    quint16 recv_crc = static_cast<quint8>(data[data.size() - 2]) |
-                       (static_cast<quint8>(data[data.size() - 1]) << 8);
-
-    return calc_crc == recv_crc;
+    return modbus_build_exception(m_tx_frame, sizeof(m_tx_frame), m_slave_address,
+                                  function_code, exception_code);
 }
@@ -12,6 +12,9 @@
 #include <QMap>
 #include <QByteArray>
 #include <QTimer>
+#include "codec/modbus_codec.h"
+
+class modbus_capture_t;
 
 /* 从机状态枚举 */
 typedef enum {
@@ -26,16 +29,6 @@ typedef struct {
     quint16 value;          /* 寄存器值 */
 } register_info_t;
 
-/* Modbus异常码 */
-#define MODBUS_EX_ILLEGAL_FUNCTION      0x01
-#define MODBUS_EX_ILLEGAL_DATA_ADDRESS  0x02
-#define MODBUS_EX_ILLEGAL_DATA_VALUE    0x03
-
-/* Modbus功能码 */
-#define MODBUS_FC_READ_HOLDING_REGISTERS    0x03
-#define MODBUS_FC_WRITE_SINGLE_REGISTER     0x06
-#define MODBUS_FC_WRITE_MULTIPLE_REGISTERS  0x10
-
 /**
  * @brief Modbus RTU从机模拟器类
  * @note 监听串口请求并返回模拟响应
@@ -68,12 +61,21 @@ public:
     QMap<quint16, register_info_t> get_all_registers() const;
     void clear_registers();
 
+    /* 抓包（从机侧，收发帧原样写入.axcap文件） */
+    bool start_capture(const QString &file_path);
+    void stop_capture();
+    bool is_capturing() const { return m_capture != nullptr; }
+
+    /* 不经串口直接处理一帧请求（抓包回放），返回响应帧长度，0表示不响应 */
+    int inject_request(const quint8 *request, int len);
+    const quint8 *response_frame() const { return m_tx_frame; }
+
 signals:
     /* 状态信号 */
     void signal_state_changed(slave_state_E state);
     void signal_error_occurred(const QString &error_msg);
 
-    /* 通信日志信号 */
+    /* 通信日志信号（data引用内部收发缓冲区，仅在槽函数内有效，需保留时请深拷贝） */
     void signal_request_received(const QByteArray &data);
     void signal_response_sent(const QByteArray &data);
 
@@ -86,22 +88,23 @@ private slots:
     void slot_process_frame();
 
 private:
-    /* 协议处理 */
-    void process_request(const QByteArray &request);
-    QByteArray handle_read_holding_registers(quint16 start_addr, quint16 count);
-    QByteArray handle_write_single_register(quint16 addr, quint16 value);
-    QByteArray handle_write_multiple_registers(quint16 start_addr, const QByteArray &data);
-    QByteArray build_exception_response(quint8 function_code, quint8 exception_code);
-    quint16 calc_crc16(const QByteArray &data);
-    bool verify_crc(const QByteArray &data);
+    /* 协议处理（帧编解码见modbus_codec.h，响应写入m_tx_frame，返回帧长度） */
+    int process_request(const quint8 *request, int len);
+    int handle_read_holding_registers(quint16 start_addr, quint16 count);
+    int handle_write_single_register(quint16 addr, quint16 value);
+    int handle_write_multiple_registers(const modbus_adu_t &request);
+    int build_exception_response(quint8 function_code, quint8 exception_code);
 
 private:
     QSerialPort *m_serial_port;             /* 串口对象 */
     quint8 m_slave_address;                 /* 从机地址 */
     slave_state_E m_state;                  /* 从机状态 */
-    QByteArray m_recv_buffer;               /* 接收缓冲区 */
+    quint8 m_rx_frame[MODBUS_RTU_MAX_ADU];  /* 接收缓冲区（串口数据直接读入） */
+    int m_rx_len;                           /* 已接收字节数 */
+    quint8 m_tx_frame[MODBUS_RTU_MAX_ADU];  /* 响应帧缓冲区 */
     QTimer *m_frame_timer;                  /* 帧间隔定时器 */
     QMap<quint16, register_info_t> m_registers;  /* 寄存器映射表 */
+    modbus_capture_t *m_capture;            /* 抓包文件（未抓包时为nullptr） */
 
     static const int FRAME_TIMEOUT_MS = 20; /* 帧间隔超时(ms) */
 };
@@ -143,6 +143,9 @@ void slave_window_t::setup_ui()
     QHBoxLayout *log_btn_layout = new QHBoxLayout();
     m_clear_log_btn = new QPushButton("清除日志", this);
     log_btn_layout->addWidget(m_clear_log_btn);
+    m_capture_btn = new QPushButton("抓包", this);
+    m_capture_btn->setCheckable(true);
+    log_btn_layout->addWidget(m_capture_btn);
     log_btn_layout->addStretch();
     log_layout->addLayout(log_btn_layout);
 
@@ -183,6 +186,8 @@ void slave_window_t::setup_connections()
     /* 日志控制 */
     connect(m_clear_log_btn, &QPushButton::clicked,
             this, &slave_window_t::slot_on_clear_log_clicked);
+    connect(m_capture_btn, &QPushButton::toggled,
+            this, &slave_window_t::slot_on_capture_toggled);
 
     /* 从机地址变更 */
     connect(m_slave_addr_spin, QOverload<int>::of(&QSpinBox::valueChanged),
@@ -489,3 +494,22 @@ void slave_window_t::slot_on_clear_log_clicked()
 {
     m_log_text->clear();
 }
+
+void slave_window_t::slot_on_capture_toggled(bool checked)
+{
+    if (!checked) {
+        m_slave->stop_capture();
+        m_capture_btn->setText("抓包");
+        return;
+    }
+
+    QString file_path = QFileDialog::getSaveFileName(
+        this, "保存抓包文件",
+        QString("slave_%1.axcap").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss")),
+        "抓包文件 (*.axcap);;所有文件 (*)");
+    if (file_path.isEmpty() || !m_slave->start_capture(file_path)) {
+        m_capture_btn->setChecked(false);
+        return;
+    }
+    m_capture_btn->setText("停止抓包");
+}
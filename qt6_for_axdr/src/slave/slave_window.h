@@ -48,6 +48,7 @@ private slots:
 
     /* 日志控制 */
     void slot_on_clear_log_clicked();
+    void slot_on_capture_toggled(bool checked);
 
 private:
     void setup_ui();
@@ -86,6 +87,7 @@ private:
     /* 通信日志 */
     QTextEdit *m_log_text;
     QPushButton *m_clear_log_btn;
+    QPushButton *m_capture_btn;
 
     /* 表格编辑标志 */
     bool m_updating_table;
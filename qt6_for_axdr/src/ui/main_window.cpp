@@ -8,9 +8,13 @@
 #include "pid_config_widget.h"
 #include "motor_config_widget.h"
 #include "slave/slave_window.h"
+#include "log/comm_logger.h"
 
 #include <QVBoxLayout>
 #include <QMessageBox>
+#include <QFileDialog>
+#include <QApplication>
+#include <QDateTime>
 
 main_window_t::main_window_t(QWidget *parent)
     : QMainWindow(parent)
@@ -19,6 +23,7 @@ main_window_t::main_window_t(QWidget *parent)
     , m_tab_widget(nullptr)
     , m_poll_timer(nullptr)
     , m_slave_window(nullptr)
+    , m_capture_action(nullptr)
 {
     /* 创建核心对象 */
     m_modbus_client = new modbus_client_t(this);
@@ -171,6 +176,15 @@ void main_window_t::setup_menu()
     slave_action->setShortcut(QKeySequence("Ctrl+Shift+S"));
     connect(slave_action, &QAction::triggered, this, &main_window_t::slot_open_slave_window);
     tools_menu->addAction(slave_action);
+    
+    QAction *export_action = new QAction("导出通信日志为文本(&E)...", this);
+    connect(export_action, &QAction::triggered, this, &main_window_t::slot_export_comm_log);
+    tools_menu->addAction(export_action);
+    
+    m_capture_action = new QAction("抓包(&C)...", this);
+    m_capture_action->setCheckable(true);
+    connect(m_capture_action, &QAction::toggled, this, &main_window_t::slot_toggle_capture);
+    tools_menu->addAction(m_capture_action);
 }
 
 /**
@@ -188,3 +202,54 @@ void main_window_t::slot_open_slave_window()
     m_slave_window->raise();
     m_slave_window->activateWindow();
 }
+
+/**
+ * @brief 二进制通信日志导出为文本
+ * @note 正在记录的日志也可导出，内容截至最近一次批量写入
+ */
+void main_window_t::slot_export_comm_log()
+{
+    QString log_dir = QApplication::applicationDirPath() + "/../src/log";
+    QString log_path = QFileDialog::getOpenFileName(
+        this, "选择通信日志", log_dir, "通信日志 (*.axlog);;所有文件 (*)");
+    if (log_path.isEmpty()) {
+        return;
+    }
+    
+    QString text_path = QFileDialog::getSaveFileName(
+        this, "导出为文本", log_path.left(log_path.lastIndexOf('.')) + ".txt", "文本文件 (*.txt)");
+    if (text_path.isEmpty()) {
+        return;
+    }
+    
+    if (comm_logger_t::export_text(log_path, text_path)) {
+        update_status_bar(QString("通信日志已导出: %1").arg(text_path));
+    } else {
+        QMessageBox::warning(this, "导出失败", QString("无法导出通信日志: %1").arg(log_path));
+    }
+}
+
+/**
+ * @brief 开始/停止主站侧抓包
+ * @note 抓包文件可用axcap工具离线解析或回放到从机模拟器
+ */
+void main_window_t::slot_toggle_capture(bool checked)
+{
+    if (!checked) {
+        if (m_modbus_client->is_capturing()) {
+            m_modbus_client->stop_capture();
+            update_status_bar("抓包已停止");
+        }
+        return;
+    }
+    
+    QString file_path = QFileDialog::getSaveFileName(
+        this, "保存抓包文件",
+        QString("capture_%1.axcap").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss")),
+        "抓包文件 (*.axcap);;所有文件 (*)");
+    if (file_path.isEmpty() || !m_modbus_client->start_capture(file_path)) {
+        m_capture_action->setChecked(false);
+        return;
+    }
+    update_status_bar(QString("正在抓包: %1").arg(file_path));
+}
@@ -48,6 +48,8 @@ private slots:
     
     /* 菜单槽 */
     void slot_open_slave_window();
+    void slot_export_comm_log();
+    void slot_toggle_capture(bool checked);
 
 private:
     void setup_ui();
@@ -76,6 +78,9 @@ private:
     /* 从机模拟器窗口 */
     slave_window_t *m_slave_window;
     
+    /* 抓包菜单项 */
+    QAction *m_capture_action;
+    
     static const int POLL_INTERVAL_MS = 100;  /* 实时数据轮询间隔 */
 };
 
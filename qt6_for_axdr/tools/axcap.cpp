@@ -0,0 +1,335 @@
+/**
+ * @file axcap.cpp
+ * @brief Modbus RTU抓包离线工具
+ * @note decode: 按请求/响应配对还原为寄存器级事务，寄存器按register_map名称与类型解码
+ * @note replay: 按抓包时序将请求注入modbus_slave_t，可加速回放，可同时监听串口供上位机实时读取
+ * @note 用法: axcap decode <文件.axcap>
+ *             axcap replay <文件.axcap> [倍速(0为不等待)] [串口 [波特率]]
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVector>
+#include "codec/modbus_codec.h"
+#include "log/modbus_capture.h"
+#include "params/register_map.h"
+#include "slave/modbus_slave.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/* 一次事务：请求及其后紧跟的同地址响应 */
+typedef struct {
+    capture_record_t request;
+    capture_record_t response;
+    bool has_response;
+} capture_transaction_t;
+
+/**
+ * @brief 读取抓包文件并配对请求与响应
+ * @param orphan_responses 输出无对应请求的响应帧数
+ */
+static bool load_transactions(const char *path, QVector<capture_transaction_t> &transactions,
+                              int &orphan_responses)
+{
+    modbus_capture_reader_t reader;
+    if (!reader.open(QString::fromLocal8Bit(path))) {
+        std::fprintf(stderr, "无法打开抓包文件: %s\n", path);
+        return false;
+    }
+
+    orphan_responses = 0;
+    capture_record_t record;
+    while (reader.read_next(record)) {
+        if (record.direction == e_capture_request) {
+            capture_transaction_t transaction;
+            transaction.request = record;
+            transaction.has_response = false;
+            transactions.append(transaction);
+            continue;
+        }
+
+        /* 响应归属最近一条尚未应答、地址相同的请求 */
+        if (!transactions.isEmpty() && !transactions.last().has_response &&
+            transactions.last().request.slave_addr == record.slave_addr) {
+            transactions.last().response = record;
+            transactions.last().has_response = true;
+        } else {
+            ++orphan_responses;
+        }
+    }
+    return true;
+}
+
+static void print_hex(const quint8 *data, int len)
+{
+    for (int i = 0; i < len; ++i) {
+        std::printf(i == 0 ? "%02X" : " %02X", data[i]);
+    }
+}
+
+/**
+ * @brief 按寄存器映射打印一段寄存器值
+ * @note float占两个寄存器，仅当起始地址对齐且两个寄存器都在本段内时合并显示
+ */
+static void print_registers(quint16 start_addr, int count, const quint16 *values)
+{
+    for (int i = 0; i < count; ++i) {
+        quint16 addr = (quint16)(start_addr + i);
+        const register_map_entry_t *entry = register_map_find(addr);
+        if (entry && entry->type == e_reg_float && i + 1 < count) {
+            std::printf(" %s=%g", entry->name, register_map_to_float(values[i], values[i + 1]));
+            ++i;
+        } else if (entry && entry->type == e_reg_uint16) {
+            std::printf(" %s=%u", entry->name, values[i]);
+        } else {
+            std::printf(" [0x%04X]=0x%04X", addr, values[i]);
+        }
+    }
+}
+
+static int decode(const char *path)
+{
+    QVector<capture_transaction_t> transactions;
+    int orphan_responses = 0;
+    if (!load_transactions(path, transactions, orphan_responses)) {
+        return 1;
+    }
+
+    int reads = 0, writes = 0, no_response = 0, exceptions = 0, crc_errors = 0;
+    quint64 latency_min = 0, latency_max = 0, latency_sum = 0;
+    int latency_count = 0;
+
+    for (int n = 0; n < transactions.size(); ++n) {
+        const capture_transaction_t &t = transactions[n];
+        std::printf("%12.6f  #%-6d 从机%-3u ", t.request.timestamp_ns * 1e-9, n + 1, t.request.slave_addr);
+
+        modbus_adu_t request;
+        if (!modbus_parse_request(t.request.data, t.request.length, request)) {
+            ++crc_errors;
+            std::printf("请求帧无效: ");
+            print_hex(t.request.data, t.request.length);
+            std::printf("\n");
+            continue;
+        }
+
+        quint16 values[MODBUS_RTU_MAX_ADU / 2];
+        if (request.function_code == MODBUS_FC_READ_HOLDING_REGISTERS) {
+            ++reads;
+            std::printf("读 0x%04X x%-3u", request.addr, request.count);
+        } else {
+            ++writes;
+            std::printf("写 0x%04X x%-3u", request.addr, request.count);
+            if (request.function_code == MODBUS_FC_WRITE_SINGLE_REGISTER) {
+                values[0] = request.value;
+            } else {
+                for (int i = 0; i < request.count; ++i) {
+                    values[i] = modbus_register(request, i);
+                }
+            }
+            print_registers(request.addr, request.count, values);
+        }
+
+        if (!t.has_response) {
+            if (request.slave_addr != 0) {
+                ++no_response;
+                std::printf("  无响应");
+            }
+            std::printf("\n");
+            continue;
+        }
+
+        quint64 latency = t.response.timestamp_ns - t.request.timestamp_ns;
+        latency_min = latency_count == 0 ? latency : qMin(latency_min, latency);
+        latency_max = qMax(latency_max, latency);
+        latency_sum += latency;
+        ++latency_count;
+
+        modbus_adu_t response;
+        if (!modbus_parse_response(t.response.data, t.response.length, response)) {
+            ++crc_errors;
+            std::printf("  响应帧无效: ");
+            print_hex(t.response.data, t.response.length);
+        } else if (response.exception_code != 0) {
+            ++exceptions;
+            std::printf("  异常码0x%02X", response.exception_code);
+        } else if (request.function_code == MODBUS_FC_READ_HOLDING_REGISTERS) {
+            for (int i = 0; i < response.count; ++i) {
+                values[i] = modbus_register(response, i);
+            }
+            print_registers(request.addr, response.count, values);
+        }
+        std::printf("  %.3f ms\n", latency * 1e-6);
+    }
+
+    std::printf("\n事务 %d (读 %d, 写 %d), 无响应 %d, 异常 %d, 无效帧 %d, 未匹配响应 %d\n",
+                (int)transactions.size(), reads, writes, no_response, exceptions, crc_errors,
+                orphan_responses);
+    if (latency_count > 0) {
+        std::printf("响应延时 最小 %.3f ms, 平均 %.3f ms, 最大 %.3f ms\n",
+                    latency_min * 1e-6, latency_sum * 1e-6 / latency_count, latency_max * 1e-6);
+    }
+    return 0;
+}
+
+/**
+ * @brief 抓包回放
+ * @note 抓包中读响应成功的寄存器值在对应请求注入前写入模拟器，
+ *       使模拟器状态随现场变化；写请求由模拟器自身处理
+ */
+class capture_replay_t
+{
+public:
+    capture_replay_t(const QVector<capture_transaction_t> &transactions, double speed,
+                     modbus_slave_t *slave)
+        : m_transactions(transactions)
+        , m_speed(speed)
+        , m_slave(slave)
+        , m_index(0)
+        , m_matched(0)
+        , m_mismatched(0)
+        , m_exceptions(0)
+    {
+    }
+
+    void start()
+    {
+        m_clock.start();
+        step();
+    }
+
+private:
+    void step()
+    {
+        while (m_index < m_transactions.size()) {
+            qint64 due_ns = m_speed > 0 ? (qint64)(m_transactions[m_index].request.timestamp_ns / m_speed) : 0;
+            qint64 wait_ms = (due_ns - m_clock.nsecsElapsed()) / 1000000;
+            if (wait_ms > 0) {
+                QTimer::singleShot((int)qMin<qint64>(wait_ms, 1000), [this]() { step(); });
+                return;
+            }
+            replay(m_transactions[m_index]);
+            ++m_index;
+        }
+
+        std::printf("回放 %d 条请求, 与抓包响应一致 %d, 不一致 %d, 模拟器异常响应 %d, 用时 %.3f s\n",
+                    (int)m_transactions.size(), m_matched, m_mismatched, m_exceptions,
+                    m_clock.nsecsElapsed() * 1e-9);
+        QCoreApplication::quit();
+    }
+
+    void replay(const capture_transaction_t &t)
+    {
+        modbus_adu_t request;
+        if (!modbus_parse_request(t.request.data, t.request.length, request)) {
+            return;
+        }
+        if (request.slave_addr != 0) {
+            m_slave->set_slave_address(request.slave_addr);
+        }
+
+        /* 载入现场读到的寄存器值 */
+        modbus_adu_t response;
+        if (t.has_response && request.function_code == MODBUS_FC_READ_HOLDING_REGISTERS &&
+            modbus_parse_response(t.response.data, t.response.length, response) &&
+            response.exception_code == 0) {
+            for (int i = 0; i < response.count; ++i) {
+                m_slave->set_register((quint16)(request.addr + i), modbus_register(response, i));
+            }
+        }
+
+        int len = m_slave->inject_request(t.request.data, t.request.length);
+        const quint8 *frame = m_slave->response_frame();
+        if (len > 0 && (frame[1] & 0x80)) {
+            ++m_exceptions;
+        }
+
+        int expected_len = t.has_response ? t.response.length : 0;
+        if (len == expected_len && memcmp(frame, t.response.data, len) == 0) {
+            ++m_matched;
+            return;
+        }
+        ++m_mismatched;
+        std::printf("%12.6f  响应不一致\n  抓包:   ", t.request.timestamp_ns * 1e-9);
+        if (expected_len > 0) {
+            print_hex(t.response.data, expected_len);
+        } else {
+            std::printf("无响应");
+        }
+        std::printf("\n  模拟器: ");
+        if (len > 0) {
+            print_hex(frame, len);
+        } else {
+            std::printf("无响应");
+        }
+        std::printf("\n");
+    }
+
+private:
+    const QVector<capture_transaction_t> &m_transactions;
+    double m_speed;                 /* 回放倍速，0为不等待 */
+    modbus_slave_t *m_slave;
+    int m_index;                    /* 下一条待回放事务 */
+    int m_matched;
+    int m_mismatched;
+    int m_exceptions;
+    QElapsedTimer m_clock;
+};
+
+static int replay(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QVector<capture_transaction_t> transactions;
+    int orphan_responses = 0;
+    if (!load_transactions(argv[2], transactions, orphan_responses)) {
+        return 1;
+    }
+
+    double speed = argc > 3 ? std::atof(argv[3]) : 1.0;
+    if (speed < 0) {
+        std::fprintf(stderr, "倍速无效\n");
+        return 1;
+    }
+
+    /* 按映射表预置寄存器，未抓到读响应的地址也可被读取 */
+    modbus_slave_t slave;
+    for (quint16 addr = 0; addr < 0x0200; ++addr) {
+        const register_map_entry_t *entry = register_map_find(addr);
+        if (!entry) {
+            continue;
+        }
+        slave.set_register_with_name(addr, entry->name, 0);
+        if (entry->type == e_reg_float) {
+            slave.set_register_with_name((quint16)(addr + 1), entry->name, 0);
+        }
+    }
+
+    if (argc > 4) {
+        qint32 baud_rate = argc > 5 ? std::atoi(argv[5]) : 115200;
+        if (!slave.start_listening(QString::fromLocal8Bit(argv[4]), baud_rate)) {
+            std::fprintf(stderr, "无法打开串口: %s\n", argv[4]);
+            return 1;
+        }
+    }
+
+    capture_replay_t replayer(transactions, speed, &slave);
+    QTimer::singleShot(0, [&replayer]() { replayer.start(); });
+    return app.exec();
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 3 && std::strcmp(argv[1], "decode") == 0) {
+        return decode(argv[2]);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "replay") == 0) {
+        return replay(argc, argv);
+    }
+
+    std::fprintf(stderr,
+                 "用法: axcap decode <文件.axcap>\n"
+                 "      axcap replay <文件.axcap> [倍速(0为不等待)] [串口 [波特率]]\n");
+    return 1;
+}
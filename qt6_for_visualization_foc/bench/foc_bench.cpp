@@ -0,0 +1,352 @@
+/**
+ * @file foc_bench.cpp
+ * @brief 核心算法与仿真热路径性能基准（Google Benchmark）
+ *
+ * 覆盖：坐标变换、SVPWM、PID、电机模型单步、批量电机模型、
+ * 以及sim_engine完整仿真步（FOC / 六步换向）、各数值类型（double/float/Q31/Q15）的控制通路。
+ * 每项输出单步耗时(time/step, ns)与 steps/s，作为回归基线和优化效果对比依据。
+ *
+ * 构建：cmake -DFOC_BUILD_BENCHMARKS=ON
+ * 运行：foc_bench --benchmark_filter=engine
+ */
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include "core/transform.h"
+#include "core/svpwm.h"
+#include "core/pid_controller.h"
+#include "core/pmsm_model.h"
+#include "core/bldc_model.h"
+#include "core/pmsm_batch_model.h"
+#include "core/fast_trig.h"
+#include "core/sim_engine.h"
+#include "core/sim_pipeline.h"
+#include "core/motor_model_factory.h"
+#include "control/loop_controller.h"
+#include "control/six_step_controller.h"
+
+// 每次迭代执行steps步：输出单步耗时（time/step，按SI前缀显示为ns）与 steps/s
+static void set_step_counters(benchmark::State& state, double steps_per_iter) {
+    const double steps = static_cast<double>(state.iterations()) * steps_per_iter;
+    state.counters["steps/s"] = benchmark::Counter(steps, benchmark::Counter::kIsRate);
+    state.counters["time/step"] = benchmark::Counter(steps,
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// 角度序列按仿真中的方式平滑推进，避免常量折叠
+static constexpr double BENCH_DTHETA = 0.0123;
+
+static double advance_angle(double theta) {
+    theta += BENCH_DTHETA;
+    return theta >= TWO_PI ? theta - TWO_PI : theta;
+}
+
+// ========== 坐标变换 ==========
+
+static void bm_transform_clark(benchmark::State& state) {
+    transform t;
+    double ia = 1.0, ib = -0.5, ic = -0.5;
+    double i_alpha, i_beta;
+    for (auto _ : state) {
+        t.clark(ia, ib, ic, i_alpha, i_beta);
+        benchmark::DoNotOptimize(i_alpha);
+        benchmark::DoNotOptimize(i_beta);
+        ia += 1e-6;
+    }
+    set_step_counters(state, 1);
+}
+BENCHMARK(bm_transform_clark);
+
+static void bm_transform_park(benchmark::State& state) {
+    transform t;
+    double theta = 0.0;
+    double id, iq;
+    for (auto _ : state) {
+        t.park(1.0, 0.5, theta, id, iq);
+        benchmark::DoNotOptimize(id);
+        benchmark::DoNotOptimize(iq);
+        theta = advance_angle(theta);
+    }
+    set_step_counters(state, 1);
+}
+BENCHMARK(bm_transform_park);
+
+// 复用旋转因子（不计三角函数）
+static void bm_transform_park_rotation(benchmark::State& state) {
+    transform t;
+    rotation_t rot = make_rotation(0.3);
+    double id, iq;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rot);
+        t.park(1.0, 0.5, rot, id, iq);
+        benchmark::DoNotOptimize(id);
+        benchmark::DoNotOptimize(iq);
+    }
+    set_step_counters(state, 1);
+}
+BENCHMARK(bm_transform_park_rotation);
+
+static void bm_transform_inv_park(benchmark::State& state) {
+    transform t;
+    double theta = 0.0;
+    double u_alpha, u_beta;
+    for (auto _ : state) {
+        t.inv_park(0.0, 5.0, theta, u_alpha, u_beta);
+        benchmark::DoNotOptimize(u_alpha);
+        benchmark::DoNotOptimize(u_beta);
+        theta = advance_angle(theta);
+    }
+    set_step_counters(state, 1);
+}
+BENCHMARK(bm_transform_inv_park);
+
+static void bm_transform_inv_clark(benchmark::State& state) {
+    transform t;
+    double u_alpha = 3.0, u_beta = 4.0;
+    double ua, ub, uc;
+    for (auto _ : state) {
+        t.inv_clark(u_alpha, u_beta, ua, ub, uc);
+        benchmark::DoNotOptimize(ua);
+        benchmark::DoNotOptimize(ub);
+        benchmark::DoNotOptimize(uc);
+        u_alpha += 1e-6;
+    }
+    set_step_counters(state, 1);
+}
+BENCHMARK(bm_transform_inv_clark);
+
+// sincos：Arg 0=EXACT，1=FAST
+static void bm_make_rotation(benchmark::State& state) {
+    const e_trig_mode mode = state.range(0) ? e_trig_mode::FAST : e_trig_mode::EXACT;
+    double theta = 0.0;
+    for (auto _ : state) {
+        rotation_t rot = make_rotation(theta, mode);
+        benchmark::DoNotOptimize(rot);
+        theta = advance_angle(theta);
+    }
+    set_step_counters(state, 1);
+}
+BENCHMARK(bm_make_rotation)->Arg(0)->Arg(1);
+
+// ========== SVPWM ==========
+
+static void bm_svpwm_calc(benchmark::State& state) {
+    svpwm pwm;
+    double theta = 0.0;
+    double ta, tb, tc;
+    for (auto _ : state) {
+        // 矢量绕圈旋转，覆盖全部六个扇区
+        double u_alpha = 8.0 * std::cos(theta);
+        double u_beta = 8.0 * std::sin(theta);
+        benchmark::DoNotOptimize(u_alpha);
+        benchmark::DoNotOptimize(u_beta);
+        pwm.calc(u_alpha, u_beta, 24.0, ta, tb, tc);
+        benchmark::DoNotOptimize(ta);
+        benchmark::DoNotOptimize(tb);
+        benchmark::DoNotOptimize(tc);
+        theta = advance_angle(theta);
+    }
+    set_step_counters(state, 1);
+}
+BENCHMARK(bm_svpwm_calc);
+
+// ========== PID ==========
+
+static void bm_pid_calc(benchmark::State& state) {
+    pid_controller pid(pid_params_t{12.57, 3770.0, 0.0, 24.0, -24.0, 20.0});
+    double feedback = 0.0;
+    for (auto _ : state) {
+        double out = pid.calc(1.0, feedback, 100e-6);
+        benchmark::DoNotOptimize(out);
+        feedback += 1e-4 * (out - feedback);
+    }
+    set_step_counters(state, 1);
+}
+BENCHMARK(bm_pid_calc);
+
+// 各标量类型的PID计算核（定点类型的输入为标幺值，基值取输出限幅）
+template<typename T>
+static void bm_basic_pid_calc(benchmark::State& state) {
+    using traits = scalar_traits<T>;
+    basic_pid<T> pid;
+    pid.set_params(pid_params_t{12.57, 3770.0, 0.0, 24.0, -24.0, 20.0}, 2.0, 24.0);
+    const T ref = traits::from_double(0.5);
+    double feedback = 0.0;
+    for (auto _ : state) {
+        const T out = pid.calc(ref, traits::from_double(feedback), 100e-6);
+        benchmark::DoNotOptimize(out);
+        feedback += 1e-4 * (traits::to_double(out) - feedback);
+    }
+    set_step_counters(state, 1);
+}
+BENCHMARK_TEMPLATE(bm_basic_pid_calc, double);
+BENCHMARK_TEMPLATE(bm_basic_pid_calc, float);
+BENCHMARK_TEMPLATE(bm_basic_pid_calc, q31_t);
+BENCHMARK_TEMPLATE(bm_basic_pid_calc, q15_t);
+
+// ========== 电机模型 ==========
+
+// Args: {积分方法(0=EULER,1=RK4,2=RK45,3=ZOH), 三角函数模式(0=EXACT,1=FAST)}
+template<typename MODEL>
+static void bm_motor_step(benchmark::State& state) {
+    MODEL motor;
+    motor.set_params(motor_params_t{});
+    integrator_config_t ic;
+    ic.method = static_cast<e_integrator>(state.range(0));
+    motor.set_integrator(ic);
+    motor.set_trig_mode(state.range(1) ? e_trig_mode::FAST : e_trig_mode::EXACT);
+    motor.set_voltage(0.0, 6.0);
+    motor.set_load_torque(0.05);
+    for (auto _ : state) {
+        motor.step(100e-6);
+        benchmark::ClobberMemory();
+    }
+    benchmark::DoNotOptimize(motor.get_state());
+    set_step_counters(state, 1);
+}
+BENCHMARK_TEMPLATE(bm_motor_step, pmsm_model)
+    ->Args({0, 0})->Args({0, 1})->Args({1, 0})->Args({2, 0})->Args({3, 0});
+BENCHMARK_TEMPLATE(bm_motor_step, bldc_model)
+    ->Args({0, 0})->Args({0, 1})->Args({1, 0})->Args({2, 0});
+
+// 批量模型：Arg为电机数量，steps为 电机数×步数
+static void bm_pmsm_batch_step(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    pmsm_batch_model batch(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        batch.set_voltage(i, 0.0, 6.0);
+        batch.set_load_torque(i, 0.05);
+    }
+    for (auto _ : state) {
+        batch.step(100e-6);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(pmsm_batch_model::simd_name());
+    set_step_counters(state, static_cast<double>(count));
+}
+BENCHMARK(bm_pmsm_batch_step)->Arg(64)->Arg(1024)->Arg(16384);
+
+// ========== 完整仿真步 ==========
+
+// 每次迭代执行的仿真步数（run_steps每次调用持锁一次并发布快照）
+static constexpr int ENGINE_BATCH_STEPS = 256;
+
+// Arg: 0=FOC，1=SIX_STEP
+static void bm_engine_step(benchmark::State& state) {
+    const bool six_step = state.range(0) != 0;
+    auto motor = motor_model_factory::create(six_step ? e_motor_type::BLDC : e_motor_type::PMSM);
+    motor->set_params(motor_params_t{});
+
+    loop_controller ctrl;
+    control_target_t target;
+    target.vel_ref = 30.0;
+    ctrl.set_target(target);
+    six_step_controller six_step_ctrl;
+
+    sim_engine engine;
+    engine.set_motor_model(std::move(motor));
+    engine.set_loop_controller(&ctrl);
+    engine.set_six_step_controller(&six_step_ctrl);
+    engine.set_control_mode(six_step ? e_control_mode::SIX_STEP : e_control_mode::FOC);
+    engine.set_config(sim_config_t{});
+    // 在set_config之后设置：set_config按实时倍速所需容量扩大缓冲
+    engine.set_sample_capacity(ENGINE_BATCH_STEPS * 2);
+    engine.set_load_torque(0.05);
+
+    auto* samples = engine.sample_buffer();
+    for (auto _ : state) {
+        engine.run_steps(ENGINE_BATCH_STEPS);
+        samples->clear();
+    }
+    state.SetLabel(six_step ? "SIX_STEP" : "FOC");
+    set_step_counters(state, ENGINE_BATCH_STEPS);
+}
+BENCHMARK(bm_engine_step)->Arg(0)->Arg(1);
+
+// 编译期特化流水线，配置与bm_engine_step相同（每步组装采样点，与引擎写采样缓冲的工作量相当）
+template<typename MODEL, e_control_mode MODE>
+static void bm_pipeline_step(benchmark::State& state) {
+    loop_controller ctrl;
+    control_target_t target;
+    target.vel_ref = 30.0;
+    ctrl.set_target(target);
+    six_step_controller six_step_ctrl;
+
+    sim_pipeline<MODEL, MODE, MODE == e_control_mode::FOC, false> pipe(ctrl, six_step_ctrl);
+    pipe.set_params(motor_params_t{});
+    pipe.set_config(sim_config_t{});
+    pipe.set_load_torque(0.05);
+
+    for (auto _ : state) {
+        pipe.run(ENGINE_BATCH_STEPS, [](const auto& p) {
+            sim_sample_t s = p.sample();
+            benchmark::DoNotOptimize(s);
+        });
+    }
+    set_step_counters(state, ENGINE_BATCH_STEPS);
+}
+BENCHMARK_TEMPLATE(bm_pipeline_step, pmsm_model, e_control_mode::FOC);
+BENCHMARK_TEMPLATE(bm_pipeline_step, bldc_model, e_control_mode::SIX_STEP);
+
+// FOC流水线按控制通路数值类型实例化（电机模型为double，含反馈量化与输出换算）
+template<typename SCALAR>
+static void bm_pipeline_numeric(benchmark::State& state) {
+    loop_controller ctrl;
+    control_target_t target;
+    target.vel_ref = 30.0;
+    ctrl.set_target(target);
+    six_step_controller six_step_ctrl;
+
+    sim_pipeline<pmsm_model, e_control_mode::FOC, true, false, SCALAR> pipe(ctrl, six_step_ctrl);
+    pipe.set_params(motor_params_t{});
+    pipe.set_config(sim_config_t{});
+    pipe.set_load_torque(0.05);
+
+    for (auto _ : state) {
+        pipe.run(ENGINE_BATCH_STEPS, [](const auto& p) {
+            sim_sample_t s = p.sample();
+            benchmark::DoNotOptimize(s);
+        });
+    }
+    set_step_counters(state, ENGINE_BATCH_STEPS);
+}
+BENCHMARK_TEMPLATE(bm_pipeline_numeric, double);
+BENCHMARK_TEMPLATE(bm_pipeline_numeric, float);
+BENCHMARK_TEMPLATE(bm_pipeline_numeric, q31_t);
+BENCHMARK_TEMPLATE(bm_pipeline_numeric, q15_t);
+
+// 开关模型：电机模型按PWM开关边沿分段推进
+// Args: {死区时间(ns)}，每步即一个PWM周期
+static void bm_pipeline_switching(benchmark::State& state) {
+    loop_controller ctrl;
+    control_target_t target;
+    target.vel_ref = 30.0;
+    ctrl.set_target(target);
+    six_step_controller six_step_ctrl;
+
+    sim_config_t cfg;
+    cfg.inverter.mode = e_inverter_mode::SWITCHING;
+    cfg.inverter.dead_time = static_cast<double>(state.range(0)) * 1e-9;
+    sim_pipeline<pmsm_model, e_control_mode::FOC, true, false> pipe(ctrl, six_step_ctrl);
+    pipe.set_params(motor_params_t{});
+    pipe.set_config(cfg);
+    pipe.set_load_torque(0.05);
+
+    for (auto _ : state) {
+        pipe.run(ENGINE_BATCH_STEPS, [](const auto& p) {
+            sim_sample_t s = p.sample();
+            benchmark::DoNotOptimize(s);
+        });
+    }
+    set_step_counters(state, ENGINE_BATCH_STEPS);
+}
+BENCHMARK(bm_pipeline_switching)->Arg(0)->Arg(1000);
+
+int main(int argc, char** argv) {
+    // sim_engine内部使用QTimer，需要事件循环对象存在
+    QCoreApplication app(argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <QFontDatabase>
 #include "ui/foc_visualization_window.h"
 #include "ui/waveform_window.h"
+#include "ui/frame_scheduler.h"
 #include "ui/algorithm_explanation_window.h"
 #include "ui/panels/control_loop_explanation_panel.h"
 #include "ui/panels/pid_config_panel.h"
@@ -17,8 +18,13 @@
 #include "core/sim_engine.h"
 #include "core/motor_model_factory.h"
 #include "core/config_loader.h"
+#include "core/trajectory_file.h"
+#include "core/trajectory_player.h"
 #include "control/loop_controller.h"
 #include "control/six_step_controller.h"
+#include "analysis/pid_tuner.h"
+#include <atomic>
+#include <thread>
 
 int main(int argc, char* argv[])
 {
@@ -62,6 +68,7 @@ int main(int argc, char* argv[])
         motor->set_params(params);
     }
     engine.set_motor_model(std::move(motor));
+    e_motor_type motor_type = e_motor_type::PMSM;
     
     // 创建FOC控制器并设置默认目标
     loop_controller ctrl;
@@ -79,46 +86,79 @@ int main(int argc, char* argv[])
     cfg.dt = 100e-6;  // 100us步长
     cfg.speed_ratio = 1.0;
     engine.set_config(cfg);
+    // 线程模式：仿真在独立线程按墙钟积分，UI只消费快照，绘制慢不影响仿真时间
+    engine.set_threaded(true);
     
-    // 连接仿真引擎信号到窗口更新
-    QObject::connect(&engine, &sim_engine::state_updated, [&](const motor_state_t& state) {
-        // ========== 更新窗口1（可视化面板）==========
+    // 界面按显示刷新率统一更新：每帧读取一次最新快照，只刷新可见且落后的面板
+    frame_scheduler frames(&engine);
+
+    // ========== 窗口1（可视化面板）==========
+    frames.add_view(foc_win.coord_panel(), [&](const sim_snapshot_t& snap) {
+        const motor_state_t& state = snap.state;
         foc_win.coord_panel()->update_alpha_beta(state.i_alpha, state.i_beta);
         foc_win.coord_panel()->update_dq(state.id, state.iq);
         foc_win.coord_panel()->update_abc(state.ia, state.ib, state.ic);
-        
-        auto svpwm_out = engine.get_svpwm_output();
-        foc_win.svpwm_panel_ptr()->update_voltage(state.u_alpha, state.u_beta);
-        foc_win.svpwm_panel_ptr()->update_sector(svpwm_out.sector);
-        foc_win.svpwm_panel_ptr()->update_duty(svpwm_out.ta, svpwm_out.tb, svpwm_out.tc);
-        
-        foc_win.motor_panel()->update_angle(state.theta_e);
-        foc_win.motor_panel()->update_motor_state(state.omega_m, state.te, state.theta_e);
-        
-        // ========== 更新窗口2（波形显示）==========
-        // 电流波形
-        wave_win.update_currents(state.ia, state.ib, state.ic,
-                                 state.i_alpha, state.i_beta,
-                                 state.id, state.iq,
-                                 ctrl.get_id_ref(), ctrl.get_iq_ref());
-        // 电压波形（使用控制器输出的dq电压和坐标变换后的电压）
-        wave_win.update_voltages(state.ud, state.uq,
-                                 state.u_alpha, state.u_beta,
-                                 state.ua, state.ub, state.uc);
-        // PWM占空比
-        wave_win.update_pwm(svpwm_out.ta, svpwm_out.tb, svpwm_out.tc);
-        // 速度波形
-        wave_win.update_velocity(ctrl.get_vel_ref(), state.omega_m);
-        // 位置波形
-        wave_win.update_position(ctrl.get_target().pos_ref, state.theta_m);
     });
-    
-    // ========== 控制工具栏信号连接（从窗口1发出）==========
+    frames.add_view(foc_win.svpwm_panel_ptr(), [&](const sim_snapshot_t& snap) {
+        foc_win.svpwm_panel_ptr()->update_voltage(snap.state.u_alpha, snap.state.u_beta);
+        foc_win.svpwm_panel_ptr()->update_sector(snap.svpwm.sector);
+        foc_win.svpwm_panel_ptr()->update_duty(snap.svpwm.ta, snap.svpwm.tb, snap.svpwm.tc);
+    });
+    frames.add_view(foc_win.motor_panel(), [&](const sim_snapshot_t& snap) {
+        foc_win.motor_panel()->update_angle(snap.state.theta_e);
+        foc_win.motor_panel()->update_motor_state(snap.state.omega_m, snap.state.te, snap.state.theta_e);
+    });
+    // 霍尔指示器仅六步换向模式下可见（FOC模式下位于隐藏的堆叠页，自动跳过）
+    frames.add_view(foc_win.hall_ind(), [&](const sim_snapshot_t& snap) {
+        foc_win.hall_ind()->set_hall_state(snap.hall);
+    });
+
+    // 窗口2（波形显示）每帧直接接收逐步采样，不经过信号
+    frames.add_sample_sink([&](const sim_sample_t* samples, size_t count) {
+        wave_win.append_samples(samples, count);
+    });
+
+    // 轨迹回放：回放期间由回放器代替sim_engine驱动全部面板
+    trajectory_player player;
+    bool replaying = false;
     auto* toolbar = foc_win.toolbar_panel();
+
+    // 轨迹录制：与波形共用每帧取出的逐步采样，窗口不可见时也完整写入
+    // 录制文件须连续且时间单调：采样缓冲丢样或仿真时间回退时结束录制，已写入部分保持有效
+    trajectory_recorder recorder;
+    data_buffer<sim_sample_t>* record_buffer = nullptr;  // 录制开始时的采样缓冲及其丢样计数
+    uint64_t record_dropped = 0;
+    auto stop_recording = [&](const QString& reason) {
+        if (!recorder.is_open()) return;
+        recorder.close();
+        toolbar->stop_recording(reason);
+    };
+    frames.add_sample_sink([&](const sim_sample_t* samples, size_t count) {
+        if (!recorder.is_open()) return;
+        if (!recorder.append(samples, count)) {
+            toolbar->stop_recording("仿真时间回退，录制已结束");
+            return;
+        }
+        // 本帧取出的采样先于任何丢样，写入后再检查
+        data_buffer<sim_sample_t>* buffer = engine.sample_buffer();
+        if (buffer != record_buffer || buffer->dropped() != record_dropped) {
+            stop_recording("采样缓冲溢出，录制已中止（已录制部分完整）");
+        }
+    });
+    frames.add_frame_task([&]() {
+        if (!replaying) return;
+        const bool playing = player.is_playing();
+        toolbar->set_replay_progress(player.progress(), player.snapshot().sim_time);
+        if (!playing && toolbar->is_running()) toolbar->set_running(false);  // 播放到末尾
+    });
+    frames.start();
     
-    // 运行/暂停/复位控制
+    // ========== 控制工具栏信号连接（从窗口1发出）==========
+    // 运行/暂停/复位控制（回放模式下作用于回放器）
     QObject::connect(toolbar, &control_toolbar_panel::run_state_changed, [&](bool running) {
-        if (running) {
+        if (replaying) {
+            player.set_playing(running);
+        } else if (running) {
             engine.start();
         } else {
             engine.pause();
@@ -126,12 +166,83 @@ int main(int argc, char* argv[])
     });
     
     QObject::connect(toolbar, &control_toolbar_panel::reset_requested, [&]() {
+        if (replaying) {
+            player.set_playing(false);
+            player.seek_row(0);
+            wave_win.clear_waveforms();
+            return;
+        }
+        stop_recording("已复位，录制已结束");
         engine.reset();
     });
     
     QObject::connect(toolbar, &control_toolbar_panel::step_requested, [&]() {
+        if (replaying) {
+            player.step();
+            return;
+        }
         engine.step();
     });
+
+    // 单步后退：从检查点恢复（回放模式下后退一行）
+    QObject::connect(toolbar, &control_toolbar_panel::step_back_requested, [&]() {
+        toolbar->set_running(false);
+        if (replaying) {
+            if (player.position() == 0) return;
+            player.set_playing(false);
+            player.seek_row(player.position() - 1);
+            wave_win.clear_waveforms();
+            return;
+        }
+        engine.pause();
+        stop_recording("单步后退，录制已结束");
+        engine.step_back();
+    });
+
+    // 轨迹录制开始/停止
+    QObject::connect(toolbar, &control_toolbar_panel::record_start_requested, [&](const QString& path) {
+        // 丢弃录制开始前积压的采样
+        engine.sample_buffer()->clear();
+        if (!recorder.open(path, engine.get_config().dt)) {
+            toolbar->set_recording(false);
+            return;
+        }
+        record_buffer = engine.sample_buffer();
+        record_dropped = record_buffer->dropped();
+    });
+    QObject::connect(toolbar, &control_toolbar_panel::record_stop_requested, [&]() {
+        recorder.close();
+    });
+
+    // 轨迹回放开始/停止/跳转
+    QObject::connect(toolbar, &control_toolbar_panel::replay_start_requested, [&](const QString& path) {
+        engine.pause();
+        recorder.close();
+        toolbar->set_recording(false);
+        if (!player.open(path)) {
+            toolbar->set_replay_active(false);
+            return;
+        }
+        replaying = true;
+        player.set_speed(engine.get_config().speed_ratio);
+        wave_win.clear_waveforms();
+        frames.set_source([&]() { return player.snapshot(); },
+                          [&](std::vector<sim_sample_t>& out) {
+                              player.advance(out, waveform_window::history_points());
+                          });
+    });
+    QObject::connect(toolbar, &control_toolbar_panel::replay_stop_requested, [&]() {
+        replaying = false;
+        player.close();
+        engine.sample_buffer()->clear();
+        wave_win.clear_waveforms();
+        frames.use_engine();
+    });
+    QObject::connect(toolbar, &control_toolbar_panel::seek_requested, [&](double fraction) {
+        if (!replaying) return;
+        player.seek_fraction(fraction);
+        wave_win.clear_waveforms();
+    });
     
     // 连接步骤高亮信号
     QObject::connect(&engine, &sim_engine::foc_step_changed, 
@@ -141,7 +252,7 @@ int main(int argc, char* argv[])
     QObject::connect(toolbar, &control_toolbar_panel::motor_type_changed, [&](int type) {
         engine.pause();
         motor_params_t new_params = params;
-        e_motor_type motor_type = (type == 0) ? e_motor_type::PMSM : e_motor_type::BLDC;
+        motor_type = (type == 0) ? e_motor_type::PMSM : e_motor_type::BLDC;
         auto new_motor = motor_model_factory::create(motor_type);
         if (new_motor) {
             new_motor->set_params(new_params);
@@ -159,21 +270,20 @@ int main(int argc, char* argv[])
         engine.reset();
     });
     
-    // 连接霍尔状态变化信号
-    QObject::connect(&engine, &sim_engine::hall_state_changed, 
-                     foc_win.hall_ind(), &hall_indicator::set_hall_state);
-    
-    // 仿真速度调节
+    // 仿真速度调节（回放模式下同时作为回放倍速）
     QObject::connect(toolbar, &control_toolbar_panel::speed_ratio_changed, [&](double ratio) {
+        player.set_speed(ratio);
         sim_config_t cfg_new = engine.get_config();
         cfg_new.speed_ratio = ratio;
         engine.set_config(cfg_new);
     });
     
-    // 配置文件加载
+    // 配置文件加载（保留一份用于导出整定结果时补全六步换向等参数）
+    config_data_t loaded_cfg;
     QObject::connect(toolbar, &control_toolbar_panel::config_load_requested, [&](const QString& path) {
         config_data_t cfg = config_loader::load(path);
         if (cfg.valid) {
+            loaded_cfg = cfg;
             engine.pause();
             params = cfg.motor;
             if (auto* m = engine.get_motor_model()) {
@@ -219,16 +329,19 @@ int main(int argc, char* argv[])
     
     // 电流环PID
     QObject::connect(pid_panel, &pid_config_panel::current_pid_changed, [&](double kp, double ki) {
+        auto guard = engine.lock_state();
         ctrl.set_current_pid({kp, ki, 0}, {kp, ki, 0});
     });
     
     // 速度环PID
     QObject::connect(pid_panel, &pid_config_panel::velocity_pid_changed, [&](double kp, double ki) {
+        auto guard = engine.lock_state();
         ctrl.set_velocity_pid({kp, ki, 0});
     });
     
     // 速度目标
     QObject::connect(pid_panel, &pid_config_panel::velocity_target_changed, [&](double vel) {
+        auto guard = engine.lock_state();
         control_target_t t = ctrl.get_target();
         t.vel_ref = vel;
         ctrl.set_target(t);
@@ -236,16 +349,131 @@ int main(int argc, char* argv[])
     
     // 位置环PID
     QObject::connect(pid_panel, &pid_config_panel::position_pid_changed, [&](double kp, double ki, double kd) {
+        auto guard = engine.lock_state();
         ctrl.set_position_pid({kp, ki, kd});
     });
     
     // 位置目标
     QObject::connect(pid_panel, &pid_config_panel::position_target_changed, [&](double pos) {
+        auto guard = engine.lock_state();
         control_target_t t = ctrl.get_target();
         t.pos_ref = pos;
         ctrl.set_target(t);
     });
     
+    // PID自动整定：以当前电机参数、仿真配置和PID为基准，在后台线程并行仿真搜索，
+    // 结果经排队调用回到界面线程，由用户决定应用到控制器或导出为配置文件
+    std::thread tune_thread;
+    std::atomic<bool> tune_cancel{false};
+    std::vector<tune_result_t> tune_results;
+
+    QObject::connect(pid_panel, &pid_config_panel::auto_tune_requested, [&](int loop, int cost) {
+        if (tune_thread.joinable()) tune_thread.join();
+
+        sweep_spec_t spec;
+        control_target_t refs;
+        {
+            auto guard = engine.lock_state();
+            spec.current_pid = ctrl.get_iq_pid();
+            spec.velocity_pid = ctrl.get_vel_pid();
+            spec.position_pid = ctrl.get_pos_pid();
+            refs = ctrl.get_target();
+        }
+        spec.motor_type = motor_type;
+        spec.motor = params;
+        spec.sim = engine.get_config();
+        spec.load_torque = engine.get_load_torque();
+        // 速度控制时iq_ref通常为0，电流环以速度环输出限幅的一半作为阶跃参考
+        if (refs.iq_ref == 0.0) refs.iq_ref = 0.5 * spec.velocity_pid.out_max;
+
+        std::vector<e_sweep_signal> loops;
+        switch (loop) {
+            case 0:  loops = {e_sweep_signal::CURRENT}; break;
+            case 2:  loops = {e_sweep_signal::POSITION}; break;
+            case 3:  loops = {e_sweep_signal::CURRENT, e_sweep_signal::VELOCITY, e_sweep_signal::POSITION}; break;
+            default: loops = {e_sweep_signal::VELOCITY}; break;
+        }
+        tune_options_t opt;
+        opt.cost = static_cast<e_tune_cost>(cost);
+        opt.cancel = &tune_cancel;
+
+        tune_cancel = false;
+        tune_results.clear();
+        pid_panel->set_tune_result_available(false);
+        pid_panel->set_tune_running(true);
+        pid_panel->set_tune_status("整定中...");
+        tune_thread = std::thread([&, spec, loops, refs, opt]() {
+            auto results = pid_tuner::tune_cascade(spec, loops, refs, opt, [&](int evaluations, double best) {
+                QMetaObject::invokeMethod(pid_panel, [&, evaluations, best]() {
+                    pid_panel->set_tune_status(QString("整定中: 仿真%1次, 代价%2").arg(evaluations).arg(best, 0, 'g', 4));
+                }, Qt::QueuedConnection);
+            });
+            QMetaObject::invokeMethod(pid_panel, [&, results]() {
+                tune_results = results;
+                pid_panel->set_tune_running(false);
+                QString status;
+                bool improved = false;
+                for (const auto& r : tune_results) {
+                    improved = improved || r.cost < r.initial_cost;
+                    status += QString("%1: %2 → %3\n")
+                                  .arg(r.signal == e_sweep_signal::CURRENT ? "电流环"
+                                       : r.signal == e_sweep_signal::VELOCITY ? "速度环" : "位置环")
+                                  .arg(r.initial_cost, 0, 'g', 4).arg(r.cost, 0, 'g', 4);
+                }
+                if (tune_results.empty()) status = "目标值为0，无可整定的环";
+                else if (tune_cancel) status += "已停止";
+                pid_panel->set_tune_status(status.trimmed());
+                pid_panel->set_tune_result_available(improved);
+            }, Qt::QueuedConnection);
+        });
+    });
+
+    QObject::connect(pid_panel, &pid_config_panel::tune_cancel_requested, [&]() {
+        tune_cancel = true;
+    });
+
+    // 应用整定结果：只采用优于初始增益的环，经面板回填并下发到控制器
+    QObject::connect(pid_panel, &pid_config_panel::tune_apply_requested, [&]() {
+        for (const auto& r : tune_results) {
+            if (r.cost >= r.initial_cost) continue;
+            switch (r.signal) {
+                case e_sweep_signal::CURRENT:
+                    pid_panel->set_current_pid(r.current_pid.kp, r.current_pid.ki);
+                    break;
+                case e_sweep_signal::VELOCITY:
+                    pid_panel->set_velocity_pid(r.velocity_pid.kp, r.velocity_pid.ki);
+                    break;
+                case e_sweep_signal::POSITION:
+                    pid_panel->set_position_pid(r.position_pid.kp, r.position_pid.ki, r.position_pid.kd);
+                    break;
+            }
+        }
+        pid_panel->set_tune_status("整定结果已应用");
+    });
+
+    // 导出：当前配置 + 整定后的PID
+    QObject::connect(pid_panel, &pid_config_panel::tune_export_requested, [&](const QString& path) {
+        config_data_t out = loaded_cfg;
+        out.motor = params;
+        out.sim = engine.get_config();
+        {
+            auto guard = engine.lock_state();
+            out.current_pid = ctrl.get_iq_pid();
+            out.velocity_pid = ctrl.get_vel_pid();
+            out.position_pid = ctrl.get_pos_pid();
+            out.target = ctrl.get_target();
+        }
+        for (const auto& r : tune_results) {
+            if (r.cost >= r.initial_cost) continue;
+            switch (r.signal) {
+                case e_sweep_signal::CURRENT:  out.current_pid = r.current_pid; break;
+                case e_sweep_signal::VELOCITY: out.velocity_pid = r.velocity_pid; break;
+                case e_sweep_signal::POSITION: out.position_pid = r.position_pid; break;
+            }
+        }
+        pid_panel->set_tune_status(config_loader::save(path, out) ? "整定配置已导出" : "导出失败");
+    });
+
     // 环路使能变化触发框图配置加载
     if (auto* cascade = algo_win.control_panel()->get_cascade_widget()) {
         QObject::connect(pid_panel, &pid_config_panel::loop_preset_changed,
@@ -261,6 +489,7 @@ int main(int argc, char* argv[])
     // 电机参数变化
     QObject::connect(foc_win.params_panel(), &motor_params_panel::params_changed, [&](const motor_params_t& p) {
         params = p;
+        auto guard = engine.lock_state();
         if (auto* m = engine.get_motor_model()) {
             m->set_params(params);
         }
@@ -277,5 +506,8 @@ int main(int argc, char* argv[])
     // 窗口3默认隐藏，通过按钮开启
     // algo_win.show();
 
-    return app.exec();
+    const int ret = app.exec();
+    tune_cancel = true;
+    if (tune_thread.joinable()) tune_thread.join();
+    return ret;
 }
@@ -0,0 +1,411 @@
+/**
+ * @file pid_tuner.cpp
+ * @brief PID自动整定器
+ *
+ * 多起点Nelder–Mead（反射α=1、扩展γ=2、收缩ρ=0.5、全体收缩σ=0.5），在对数增益空间搜索，
+ * 增益恒为正且可跨数量级变化。每轮各单纯形的候选点合并为一批并行仿真：
+ * 常规迭代一次提出四个候选点，按规则只采用其中一个，用多出的仿真换取每轮只需一次同步。
+ */
+#include "pid_tuner.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace {
+
+// 仿真发散或无效时的代价
+constexpr double DIVERGED_COST = 1e6;
+
+// 初始增益为0时的单纯形起点（该增益此前未启用，从1开始搜索；initial_cost仍按0评估）
+constexpr double ZERO_GAIN_START = 1.0;
+
+// 起点扰动范围（对数增益空间，±2.3约为10倍）
+constexpr double START_SPREAD = 2.3;
+
+using point_t = std::vector<double>;
+
+// 单纯形及其所处阶段
+// INIT：评估全部初始顶点；STEP：常规迭代；SHRINK：向最优顶点全体收缩
+struct simplex_t {
+    enum class e_stage { INIT, STEP, SHRINK, DONE };
+
+    std::vector<point_t> x;
+    std::vector<double> f;
+    e_stage stage = e_stage::INIT;
+    std::vector<point_t> pending;       // 本轮待评估点
+    std::vector<double> pending_f;
+};
+
+// 读取增益（与sweep_runner::apply对应）
+double param_value(e_sweep_param param, const sweep_spec_t& spec) {
+    switch (param) {
+        case e_sweep_param::CURRENT_KP: return spec.current_pid.kp;
+        case e_sweep_param::CURRENT_KI: return spec.current_pid.ki;
+        case e_sweep_param::VEL_KP:     return spec.velocity_pid.kp;
+        case e_sweep_param::VEL_KI:     return spec.velocity_pid.ki;
+        case e_sweep_param::POS_KP:     return spec.position_pid.kp;
+        case e_sweep_param::POS_KI:     return spec.position_pid.ki;
+        case e_sweep_param::POS_KD:     return spec.position_pid.kd;
+        default:                        return 0.0;
+    }
+}
+
+class nelder_mead {
+public:
+    nelder_mead(const point_t& lo, const point_t& hi, const tune_options_t& opt)
+        : m_lo(lo), m_hi(hi), m_opt(opt) {}
+
+    // 以start为首顶点建立初始单纯形
+    simplex_t make(const point_t& start) const {
+        simplex_t s;
+        const size_t n = start.size();
+        s.x.push_back(clamp(start));
+        for (size_t i = 0; i < n; ++i) {
+            point_t v = s.x[0];
+            v[i] += m_opt.initial_step;
+            if (v[i] > m_hi[i]) v[i] = s.x[0][i] - m_opt.initial_step;
+            s.x.push_back(clamp(v));
+        }
+        return s;
+    }
+
+    // 提出本轮待评估点（已收敛时转入DONE，不提出）
+    void propose(simplex_t& s) const {
+        s.pending.clear();
+        switch (s.stage) {
+            case simplex_t::e_stage::INIT:
+                s.pending = s.x;
+                break;
+            case simplex_t::e_stage::STEP: {
+                sort(s);
+                if (converged(s)) {
+                    s.stage = simplex_t::e_stage::DONE;
+                    break;
+                }
+                const point_t c = centroid(s);
+                const point_t& xw = s.x.back();
+                s.pending.push_back(along(c, xw, 1.0));     // 反射
+                s.pending.push_back(along(c, xw, 2.0));     // 扩展
+                s.pending.push_back(along(c, xw, 0.5));     // 外收缩
+                s.pending.push_back(along(c, xw, -0.5));    // 内收缩
+                break;
+            }
+            case simplex_t::e_stage::SHRINK:
+                for (size_t i = 1; i < s.x.size(); ++i) {
+                    s.pending.push_back(along(s.x[0], s.x[i], -0.5));
+                }
+                break;
+            case simplex_t::e_stage::DONE:
+                break;
+        }
+    }
+
+    // 按评估结果更新单纯形
+    void update(simplex_t& s) const {
+        switch (s.stage) {
+            case simplex_t::e_stage::INIT:
+                s.f = s.pending_f;
+                s.stage = simplex_t::e_stage::STEP;
+                break;
+            case simplex_t::e_stage::STEP: {
+                const double fr = s.pending_f[0], fe = s.pending_f[1];
+                const double foc = s.pending_f[2], fic = s.pending_f[3];
+                const double f_best = s.f.front();
+                const double f_second = s.f[s.f.size() - 2];
+                const double f_worst = s.f.back();
+                int accept = -1;
+                if (fr < f_best) {
+                    accept = fe < fr ? 1 : 0;
+                } else if (fr < f_second) {
+                    accept = 0;
+                } else if (fr < f_worst) {
+                    if (foc <= fr) accept = 2;
+                } else if (fic < f_worst) {
+                    accept = 3;
+                }
+                if (accept >= 0) {
+                    s.x.back() = s.pending[accept];
+                    s.f.back() = s.pending_f[accept];
+                } else {
+                    s.stage = simplex_t::e_stage::SHRINK;
+                }
+                break;
+            }
+            case simplex_t::e_stage::SHRINK:
+                for (size_t i = 1; i < s.x.size(); ++i) {
+                    s.x[i] = s.pending[i - 1];
+                    s.f[i] = s.pending_f[i - 1];
+                }
+                s.stage = simplex_t::e_stage::STEP;
+                break;
+            case simplex_t::e_stage::DONE:
+                break;
+        }
+    }
+
+private:
+    point_t clamp(point_t v) const {
+        for (size_t i = 0; i < v.size(); ++i) v[i] = std::clamp(v[i], m_lo[i], m_hi[i]);
+        return v;
+    }
+
+    // c + k·(c - x)
+    point_t along(const point_t& c, const point_t& x, double k) const {
+        point_t v(c.size());
+        for (size_t i = 0; i < c.size(); ++i) v[i] = c[i] + k * (c[i] - x[i]);
+        return clamp(v);
+    }
+
+    // 按代价升序排列顶点（代价相同时保持原顺序）
+    static void sort(simplex_t& s) {
+        std::vector<size_t> idx(s.x.size());
+        std::iota(idx.begin(), idx.end(), 0);
+        std::stable_sort(idx.begin(), idx.end(), [&](size_t a, size_t b) { return s.f[a] < s.f[b]; });
+        std::vector<point_t> x;
+        std::vector<double> f;
+        for (size_t i : idx) {
+            x.push_back(s.x[i]);
+            f.push_back(s.f[i]);
+        }
+        s.x = std::move(x);
+        s.f = std::move(f);
+    }
+
+    // 除最差顶点外的形心
+    static point_t centroid(const simplex_t& s) {
+        const size_t n = s.x.size() - 1;
+        point_t c(s.x[0].size(), 0.0);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t k = 0; k < c.size(); ++k) c[k] += s.x[i][k] / n;
+        }
+        return c;
+    }
+
+    bool converged(const simplex_t& s) const {
+        double dx = 0.0, df = 0.0;
+        for (size_t i = 1; i < s.x.size(); ++i) {
+            df = std::max(df, std::abs(s.f[i] - s.f[0]));
+            for (size_t k = 0; k < s.x[i].size(); ++k) {
+                dx = std::max(dx, std::abs(s.x[i][k] - s.x[0][k]));
+            }
+        }
+        return dx <= m_opt.x_tol && df <= m_opt.f_tol;
+    }
+
+    point_t m_lo;
+    point_t m_hi;
+    const tune_options_t& m_opt;
+};
+
+} // namespace
+
+std::vector<e_sweep_param> pid_tuner::tuned_params(e_sweep_signal signal) {
+    switch (signal) {
+        case e_sweep_signal::CURRENT:
+            return {e_sweep_param::CURRENT_KP, e_sweep_param::CURRENT_KI};
+        case e_sweep_signal::VELOCITY:
+            return {e_sweep_param::VEL_KP, e_sweep_param::VEL_KI};
+        case e_sweep_signal::POSITION:
+            return {e_sweep_param::POS_KP, e_sweep_param::POS_KI, e_sweep_param::POS_KD};
+    }
+    return {};
+}
+
+double pid_tuner::cost(e_tune_cost type, const step_metrics_t& m, const sweep_spec_t& spec) {
+    const double ref = std::abs(spec.step_ref);
+    if (!m.valid || ref <= 0.0 || spec.duration <= 0.0) return DIVERGED_COST;
+    // 调节时间归一化到[0, 1)；未稳定时 >= 1 并随稳态误差增大
+    const double settle = m.settling_time >= 0.0 ? m.settling_time / spec.duration
+                                                 : 1.0 + m.ss_error / ref;
+    double c = DIVERGED_COST;
+    switch (type) {
+        case e_tune_cost::ISE:
+            c = m.ise / (ref * ref * spec.duration);
+            break;
+        case e_tune_cost::OVERSHOOT:
+            c = m.overshoot / 100.0 + 0.1 * settle;
+            break;
+        case e_tune_cost::SETTLING_TIME:
+            c = settle;
+            break;
+    }
+    return std::isfinite(c) ? std::min(c, DIVERGED_COST) : DIVERGED_COST;
+}
+
+tune_result_t pid_tuner::tune(const sweep_spec_t& spec, const tune_options_t& opt,
+                              const progress_fn& progress) {
+    tune_result_t result;
+    result.signal = spec.signal;
+    result.params = tuned_params(spec.signal);
+    result.current_pid = spec.current_pid;
+    result.velocity_pid = spec.velocity_pid;
+    result.position_pid = spec.position_pid;
+    result.cost = DIVERGED_COST;
+    if (spec.step_ref == 0.0 || spec.duration <= 0.0 || spec.sim.dt <= 0.0) return result;
+
+    // 目标函数的仿真任务：只扫描被整定的增益
+    sweep_spec_t base = spec;
+    base.axes.clear();
+    for (e_sweep_param p : result.params) {
+        sweep_axis_t axis;
+        axis.param = p;
+        base.axes.push_back(axis);
+    }
+
+    // 对数增益空间的起点与边界（g0为用户的实际增益，可含0）
+    const size_t n = result.params.size();
+    point_t g0(n), x0(n), lo(n), hi(n);
+    const double log_span = std::log(std::max(opt.span, 1.0));
+    for (size_t i = 0; i < n; ++i) {
+        g0[i] = param_value(result.params[i], spec);
+        x0[i] = std::log(g0[i] > 0.0 ? g0[i] : ZERO_GAIN_START);
+        lo[i] = x0[i] - log_span;
+        hi[i] = x0[i] + log_span;
+    }
+
+    nelder_mead nm(lo, hi, opt);
+    std::vector<simplex_t> simplices;
+    std::mt19937 rng(opt.seed);
+    std::uniform_real_distribution<double> spread(-START_SPREAD, START_SPREAD);
+    for (int k = 0; k < std::max(1, opt.starts); ++k) {
+        point_t start = x0;
+        if (k > 0) {
+            for (double& v : start) v += spread(rng);
+        }
+        simplices.push_back(nm.make(start));
+    }
+
+    auto to_gains = [](const point_t& x) {
+        point_t g(x.size());
+        for (size_t i = 0; i < x.size(); ++i) g[i] = std::exp(x[i]);
+        return g;
+    };
+
+    thread_pool pool(opt.threads);
+    std::vector<point_t> batch;
+    std::vector<step_metrics_t> metrics;
+    std::vector<double> costs;
+    double best = DIVERGED_COST;
+    bool first = true;
+
+    // 实际增益单独评估一次作为initial_cost与初始最优点，与首轮候选点并行
+    step_metrics_t initial_metrics;
+    pool.submit([&] { initial_metrics = sweep_runner::run_case(base, g0); });
+    auto take_initial = [&] {
+        result.initial_cost = cost(opt.cost, initial_metrics, base);
+        result.values = g0;
+        result.metrics = initial_metrics;
+        best = result.initial_cost;
+        ++result.evaluations;
+    };
+
+    while (true) {
+        // 收集各单纯形本轮的候选点
+        batch.clear();
+        for (auto& s : simplices) {
+            nm.propose(s);
+            batch.insert(batch.end(), s.pending.begin(), s.pending.end());
+        }
+        if (batch.empty()) {
+            result.converged = true;
+            break;
+        }
+        if (!first && result.evaluations + static_cast<int>(batch.size()) > opt.max_evaluations) break;
+        if (opt.cancel && opt.cancel->load()) break;
+
+        // 并行仿真
+        metrics.assign(batch.size(), step_metrics_t{});
+        costs.assign(batch.size(), DIVERGED_COST);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            pool.submit([&, i] {
+                metrics[i] = sweep_runner::run_case(base, to_gains(batch[i]));
+                costs[i] = cost(opt.cost, metrics[i], base);
+            });
+        }
+        pool.wait_idle();
+        if (first) take_initial();
+        result.evaluations += static_cast<int>(batch.size());
+        ++result.iterations;
+
+        // 按批内顺序记录最优点（只采用严格优于实际增益的点）
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (costs[i] < best) {
+                best = costs[i];
+                result.values = to_gains(batch[i]);
+                result.metrics = metrics[i];
+            }
+        }
+        first = false;
+
+        // 分发结果
+        size_t offset = 0;
+        for (auto& s : simplices) {
+            const size_t count = s.pending.size();
+            s.pending_f.assign(costs.begin() + offset, costs.begin() + offset + count);
+            offset += count;
+            nm.update(s);
+        }
+        if (progress) progress(result.evaluations, best);
+    }
+    if (first) {
+        // 首轮前被取消：仍给出实际增益的代价
+        pool.wait_idle();
+        take_initial();
+    }
+
+    result.cost = best;
+    motor_params_t motor = spec.motor;
+    for (size_t i = 0; i < n && i < result.values.size(); ++i) {
+        sweep_runner::apply(result.params[i], result.values[i], motor,
+                            result.current_pid, result.velocity_pid, result.position_pid);
+    }
+    return result;
+}
+
+std::vector<tune_result_t> pid_tuner::tune_cascade(const sweep_spec_t& spec,
+                                                   const std::vector<e_sweep_signal>& loops,
+                                                   const control_target_t& refs,
+                                                   const tune_options_t& opt,
+                                                   const progress_fn& progress) {
+    std::vector<tune_result_t> results;
+    sweep_spec_t base = spec;
+    for (e_sweep_signal signal : loops) {
+        if (opt.cancel && opt.cancel->load()) break;
+        base.signal = signal;
+        switch (signal) {
+            case e_sweep_signal::CURRENT:  base.step_ref = refs.iq_ref; break;
+            case e_sweep_signal::VELOCITY: base.step_ref = refs.vel_ref; break;
+            case e_sweep_signal::POSITION: base.step_ref = refs.pos_ref; break;
+        }
+        if (base.step_ref == 0.0) continue;
+        tune_result_t r = tune(base, opt, progress);
+        // 只采用优于初始增益的结果，外环以此为基准
+        if (r.cost < r.initial_cost) {
+            base.current_pid = r.current_pid;
+            base.velocity_pid = r.velocity_pid;
+            base.position_pid = r.position_pid;
+        }
+        results.push_back(std::move(r));
+    }
+    return results;
+}
+
+// 名称表（与e_tune_cost顺序一致）
+static const char* const TUNE_COST_NAMES[] = {"ise", "overshoot", "settling"};
+
+bool pid_tuner::parse_cost(const std::string& name, e_tune_cost& cost) {
+    constexpr int n = sizeof(TUNE_COST_NAMES) / sizeof(TUNE_COST_NAMES[0]);
+    for (int i = 0; i < n; ++i) {
+        if (name == TUNE_COST_NAMES[i]) {
+            cost = static_cast<e_tune_cost>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* pid_tuner::cost_name(e_tune_cost cost) {
+    return TUNE_COST_NAMES[static_cast<int>(cost)];
+}
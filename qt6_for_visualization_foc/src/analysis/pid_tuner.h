@@ -0,0 +1,81 @@
+#ifndef ANALYSIS_PID_TUNER_H
+#define ANALYSIS_PID_TUNER_H
+
+#include "sweep_runner.h"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 整定目标函数
+enum class e_tune_cost {
+    ISE,            // 误差平方积分（按ref²·时长归一化）
+    OVERSHOOT,      // 超调量为主，调节时间为次要项（避免增益趋于零时超调为零的平凡解）
+    SETTLING_TIME   // 调节时间（按时长归一化），未稳定时按稳态误差追加惩罚
+};
+
+// 整定选项
+struct tune_options_t {
+    e_tune_cost cost = e_tune_cost::ISE;
+    int starts = 4;                 // 并行多起点个数（第一个起点为当前增益，其余在其附近随机扰动）
+    int max_evaluations = 400;      // 单环仿真次数上限
+    double x_tol = 1e-3;            // 单纯形尺寸收敛阈值（对数增益空间）
+    double f_tol = 1e-6;            // 单纯形顶点代价差收敛阈值
+    double initial_step = 0.7;      // 初始单纯形边长（对数增益空间，0.7约为2倍）
+    double span = 1000.0;           // 搜索范围：初始增益的[1/span, span]倍
+    unsigned threads = 0;           // 线程数，0为全部核心
+    unsigned seed = 1;              // 起点扰动的随机种子（结果与线程数无关）
+    const std::atomic<bool>* cancel = nullptr;  // 置位时在本轮评估结束后停止
+};
+
+// 单环整定结果
+struct tune_result_t {
+    e_sweep_signal signal = e_sweep_signal::VELOCITY;
+    std::vector<e_sweep_param> params;  // 整定的增益（tuned_params(signal)）
+    std::vector<double> values;         // 最优增益
+    pid_params_t current_pid;           // 整定后的完整PID参数（未整定的环保持输入值）
+    pid_params_t velocity_pid;
+    pid_params_t position_pid;
+    step_metrics_t metrics;             // 最优点的阶跃响应指标
+    double cost = 0.0;
+    double initial_cost = 0.0;          // 实际初始增益（含为0的增益）的代价
+    int evaluations = 0;                // 仿真次数
+    int iterations = 0;                 // 单纯形迭代轮数
+    bool converged = false;             // 全部单纯形收敛（否则为达到次数上限或被取消）
+};
+
+// PID自动整定器
+// 以sweep_runner::run_case的阶跃响应仿真为目标函数，在对数增益空间做多起点Nelder–Mead搜索：
+// - 每轮为每个单纯形同时提出反射、扩展、外收缩、内收缩四个候选点（收缩全体时为n个顶点），
+//   所有单纯形的候选点作为一批在工作窃取线程池中并行仿真，再按标准Nelder–Mead规则各自更新
+// - 批内顺序固定，结果只取决于spec、选项与种子，与线程数无关
+// 整定的环由spec.signal决定（spec.axes被忽略）：电流环Kp/Ki（id、iq相同）、速度环Kp/Ki、位置环Kp/Ki/Kd
+class pid_tuner {
+public:
+    // 进度回调（在调用tune的线程中每轮调用一次）：累计仿真次数、当前最优代价
+    using progress_fn = std::function<void(int evaluations, double best_cost)>;
+
+    // 单环整定
+    static tune_result_t tune(const sweep_spec_t& spec, const tune_options_t& opt,
+                              const progress_fn& progress = nullptr);
+
+    // 级联整定：按loops顺序（应由内到外）依次整定，每环结果作为下一环的基准参数
+    // refs提供各环阶跃参考值（iq_ref / vel_ref / pos_ref），为0的环跳过
+    static std::vector<tune_result_t> tune_cascade(const sweep_spec_t& spec,
+                                                   const std::vector<e_sweep_signal>& loops,
+                                                   const control_target_t& refs,
+                                                   const tune_options_t& opt,
+                                                   const progress_fn& progress = nullptr);
+
+    // 阶跃响应指标 -> 代价（越小越好，仿真发散时为很大的常数）
+    static double cost(e_tune_cost type, const step_metrics_t& m, const sweep_spec_t& spec);
+
+    // 各环整定的增益
+    static std::vector<e_sweep_param> tuned_params(e_sweep_signal signal);
+
+    // 名称与枚举互转（命令行使用）
+    static bool parse_cost(const std::string& name, e_tune_cost& cost);
+    static const char* cost_name(e_tune_cost cost);
+};
+
+#endif // ANALYSIS_PID_TUNER_H
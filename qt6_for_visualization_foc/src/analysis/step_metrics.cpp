@@ -0,0 +1,57 @@
+#include "step_metrics.h"
+#include <cmath>
+
+step_metrics_calc::step_metrics_calc(double ref, double duration, double band, double ss_window)
+    : m_ref(ref)
+    , m_band(band)
+    , m_ss_start(duration * (1.0 - ss_window)) {
+}
+
+void step_metrics_calc::push(double t, double y, double dt) {
+    if (!std::isfinite(y)) {
+        m_finite = false;
+        return;
+    }
+    m_last_y = y;
+
+    double e = m_ref - y;
+    m_ise += e * e * dt;
+
+    // 按参考方向归一化，负向阶跃同样适用
+    double sign = (m_ref >= 0.0) ? 1.0 : -1.0;
+    double y_n = y * sign;
+    double ref_n = std::abs(m_ref);
+
+    if (m_t10 < 0.0 && y_n >= 0.1 * ref_n) m_t10 = t;
+    if (m_t90 < 0.0 && y_n >= 0.9 * ref_n) m_t90 = t;
+    if (y_n > m_peak) m_peak = y_n;
+
+    if (std::abs(e) > m_band * ref_n) m_last_outside = t;
+
+    if (t >= m_ss_start) {
+        m_ss_sum += std::abs(e);
+        ++m_ss_count;
+    }
+}
+
+step_metrics_t step_metrics_calc::finish() const {
+    step_metrics_t m;
+    m.valid = m_finite;
+    if (!m_finite) return m;
+
+    double ref_n = std::abs(m_ref);
+    if (m_t10 >= 0.0 && m_t90 >= 0.0) {
+        m.rise_time = m_t90 - m_t10;
+    }
+    if (ref_n > 0.0 && m_peak > ref_n) {
+        m.overshoot = (m_peak - ref_n) / ref_n * 100.0;
+    }
+    // 末尾仍在误差带外视为未稳定
+    if (m_last_outside < m_ss_start) {
+        m.settling_time = m_last_outside;
+    }
+    m.ss_error = (m_ss_count > 0) ? m_ss_sum / m_ss_count : 0.0;
+    m.ise = m_ise;
+    m.final_value = m_last_y;
+    return m;
+}
@@ -0,0 +1,41 @@
+#ifndef ANALYSIS_STEP_METRICS_H
+#define ANALYSIS_STEP_METRICS_H
+
+// 阶跃响应指标
+struct step_metrics_t {
+    double rise_time     = -1.0;    // 上升时间：10%→90%参考值 (s)，未达到时为-1
+    double overshoot     = 0.0;     // 超调量 (%)
+    double settling_time = -1.0;    // 调节时间：此后始终保持在误差带内 (s)，未稳定时为-1
+    double ss_error      = 0.0;     // 稳态误差：末尾窗口内|ref - y|均值
+    double ise           = 0.0;     // 误差平方积分 ∫e²dt
+    double final_value   = 0.0;     // 末值
+    bool valid           = false;   // 仿真是否完成且数值有效
+};
+
+// 阶跃响应指标流式计算器
+// 逐点输入(t, y)，无需保存整条轨迹；参考值为从0出发的阶跃幅值
+class step_metrics_calc {
+public:
+    // ref: 阶跃参考值; duration: 总时长; band: 调节误差带(相对值); ss_window: 稳态窗口占比
+    step_metrics_calc(double ref, double duration, double band = 0.02, double ss_window = 0.1);
+
+    void push(double t, double y, double dt);
+    step_metrics_t finish() const;
+
+private:
+    double m_ref;
+    double m_band;
+    double m_ss_start;          // 稳态窗口起始时间
+
+    double m_t10 = -1.0;        // 首次达到10%的时间
+    double m_t90 = -1.0;        // 首次达到90%的时间
+    double m_peak = 0.0;        // 响应峰值（按参考方向）
+    double m_last_outside = 0.0;// 最后一次超出误差带的时间
+    double m_ise = 0.0;
+    double m_ss_sum = 0.0;
+    long m_ss_count = 0;
+    double m_last_y = 0.0;
+    bool m_finite = true;
+};
+
+#endif // ANALYSIS_STEP_METRICS_H
@@ -0,0 +1,103 @@
+#ifndef ANALYSIS_SWEEP_RUNNER_H
+#define ANALYSIS_SWEEP_RUNNER_H
+
+#include "core/types.h"
+#include "step_metrics.h"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 可扫描参数
+enum class e_sweep_param {
+    CURRENT_KP,     // 电流环Kp（id/iq相同）
+    CURRENT_KI,     // 电流环Ki
+    VEL_KP,         // 速度环Kp
+    VEL_KI,         // 速度环Ki
+    POS_KP,         // 位置环Kp
+    POS_KI,         // 位置环Ki
+    POS_KD,         // 位置环Kd
+    RS,             // 定子电阻
+    LD,             // d轴电感
+    LQ,             // q轴电感
+    L,              // Ld与Lq同时设置
+    PSI_F,          // 永磁体磁链
+    J,              // 转动惯量
+    B               // 阻尼系数
+};
+
+// 阶跃响应观测量
+enum class e_sweep_signal {
+    CURRENT,        // iq跟踪iq_ref（关闭速度环、位置环）
+    VELOCITY,       // omega_m跟踪vel_ref（关闭位置环）
+    POSITION        // theta_e跟踪pos_ref（三环全开）
+};
+
+// 参数扫描范围：[min, max]等分count个点，count为1时取min
+struct sweep_range_t {
+    double min = 0.0;
+    double max = 0.0;
+    int count = 1;
+    bool log_scale = false;     // 对数等比分布（增益跨数量级时使用）
+
+    double value(int i) const;
+};
+
+// 单个扫描维度
+struct sweep_axis_t {
+    e_sweep_param param = e_sweep_param::VEL_KP;
+    sweep_range_t range;
+};
+
+// 扫描任务描述：基准配置 + 扫描维度
+struct sweep_spec_t {
+    e_motor_type motor_type = e_motor_type::PMSM;
+    motor_params_t motor;
+    pid_params_t current_pid;
+    pid_params_t velocity_pid;
+    pid_params_t position_pid;
+    sim_config_t sim;
+    double load_torque = 0.0;   // 负载转矩 (N·m)
+
+    e_sweep_signal signal = e_sweep_signal::VELOCITY;
+    double step_ref = 100.0;    // 阶跃参考值（单位随观测量）
+    double duration = 0.5;      // 单次仿真时长 (s)
+    double settle_band = 0.02;  // 调节误差带（相对参考值）
+
+    std::vector<sweep_axis_t> axes;
+};
+
+// 单个扫描点结果
+struct sweep_result_t {
+    std::vector<double> values;     // 各维度取值（与axes顺序一致）
+    step_metrics_t metrics;
+};
+
+// 参数扫描器
+// 将多维网格展开为独立仿真任务，在工作窃取线程池中并行执行
+class sweep_runner {
+public:
+    // 进度回调（在工作线程中调用，需线程安全）：已完成数、总数
+    using progress_fn = std::function<void(size_t done, size_t total)>;
+
+    // 展开网格：返回每个扫描点各维度取值
+    static std::vector<std::vector<double>> expand(const sweep_spec_t& spec);
+
+    // 运行扫描，threads为0时使用全部核心
+    static std::vector<sweep_result_t> run(const sweep_spec_t& spec, unsigned threads = 0,
+                                           const progress_fn& progress = nullptr);
+
+    // 运行单个扫描点（values与spec.axes一一对应）
+    static step_metrics_t run_case(const sweep_spec_t& spec, const std::vector<double>& values);
+
+    // 参数名与枚举互转（命令行使用）
+    static bool parse_param(const std::string& name, e_sweep_param& param);
+    static const char* param_name(e_sweep_param param);
+
+    // 将一组扫描取值应用到参数结构
+    static void apply(e_sweep_param param, double value, motor_params_t& motor,
+                      pid_params_t& current_pid, pid_params_t& velocity_pid,
+                      pid_params_t& position_pid);
+};
+
+#endif // ANALYSIS_SWEEP_RUNNER_H
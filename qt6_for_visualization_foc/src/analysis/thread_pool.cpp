@@ -0,0 +1,97 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace {
+// 当前线程所属的线程池及队列下标（非工作线程为nullptr）
+thread_local const thread_pool* t_pool = nullptr;
+thread_local unsigned t_index = 0;
+}
+
+thread_pool::thread_pool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        m_queues.push_back(std::make_unique<task_queue_t>());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        m_threads.emplace_back(&thread_pool::worker_main, this, i);
+    }
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> lk(m_wake_mtx);
+        m_stop = true;
+    }
+    m_wake_cv.notify_all();
+    for (auto& t : m_threads) {
+        t.join();
+    }
+}
+
+void thread_pool::submit(std::function<void()> task) {
+    unsigned index = (t_pool == this)
+                     ? t_index
+                     : static_cast<unsigned>(m_next_queue.fetch_add(1) % m_queues.size());
+    m_pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lk(m_queues[index]->mtx);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    m_queued.fetch_add(1);
+    // 持锁通知，避免工作线程检查条件与进入等待之间丢失唤醒
+    {
+        std::lock_guard<std::mutex> lk(m_wake_mtx);
+    }
+    m_wake_cv.notify_one();
+}
+
+void thread_pool::wait_idle() {
+    std::unique_lock<std::mutex> lk(m_wake_mtx);
+    m_idle_cv.wait(lk, [this] { return m_pending.load() == 0; });
+}
+
+bool thread_pool::try_pop(unsigned index, std::function<void()>& task) {
+    auto& q = *m_queues[index];
+    std::lock_guard<std::mutex> lk(q.mtx);
+    if (q.tasks.empty()) return false;
+    task = std::move(q.tasks.back());
+    q.tasks.pop_back();
+    m_queued.fetch_sub(1);
+    return true;
+}
+
+bool thread_pool::try_steal(unsigned thief, std::function<void()>& task) {
+    const size_t n = m_queues.size();
+    for (size_t k = 1; k < n; ++k) {
+        auto& q = *m_queues[(thief + k) % n];
+        std::lock_guard<std::mutex> lk(q.mtx);
+        if (q.tasks.empty()) continue;
+        task = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        m_queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void thread_pool::worker_main(unsigned index) {
+    t_pool = this;
+    t_index = index;
+    std::function<void()> task;
+    while (true) {
+        if (try_pop(index, task) || try_steal(index, task)) {
+            task();
+            task = nullptr;
+            if (m_pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lk(m_wake_mtx);
+                m_idle_cv.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(m_wake_mtx);
+        m_wake_cv.wait(lk, [this] { return m_stop || m_queued.load() > 0; });
+        if (m_stop && m_queued.load() == 0) return;
+    }
+}
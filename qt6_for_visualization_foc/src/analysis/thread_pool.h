@@ -0,0 +1,57 @@
+#ifndef ANALYSIS_THREAD_POOL_H
+#define ANALYSIS_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 工作窃取线程池
+// - 每个工作线程拥有独立任务队列：本线程从队尾取（LIFO，缓存友好），
+//   空闲线程从其他队列队首窃取（FIFO，优先拿走较早提交的大任务）
+// - 外部线程提交的任务轮询分配到各队列；工作线程内提交的任务放入本线程队列
+// - 适合大量相互独立、耗时不均的仿真任务
+class thread_pool {
+public:
+    // threads为0时使用硬件并发数
+    explicit thread_pool(unsigned threads = 0);
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // 提交任务
+    void submit(std::function<void()> task);
+
+    // 阻塞等待所有已提交任务执行完毕
+    void wait_idle();
+
+    unsigned size() const { return static_cast<unsigned>(m_threads.size()); }
+
+private:
+    struct task_queue_t {
+        std::mutex mtx;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void worker_main(unsigned index);
+    bool try_pop(unsigned index, std::function<void()>& task);
+    bool try_steal(unsigned thief, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<task_queue_t>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_wake_mtx;
+    std::condition_variable m_wake_cv;      // 有新任务
+    std::condition_variable m_idle_cv;      // 全部任务完成
+    std::atomic<size_t> m_queued{0};        // 队列中等待的任务数
+    std::atomic<size_t> m_pending{0};       // 未完成任务数（等待+执行中）
+    std::atomic<size_t> m_next_queue{0};    // 外部提交的轮询位置
+    bool m_stop = false;
+};
+
+#endif // ANALYSIS_THREAD_POOL_H
@@ -0,0 +1,281 @@
+#ifndef CONTROL_BASIC_LOOP_CONTROLLER_H
+#define CONTROL_BASIC_LOOP_CONTROLLER_H
+
+#include "core/types.h"
+#include "core/scalar_traits.h"
+#include "core/pid_controller.h"
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
+// 三环控制器动态状态（仿真检查点保存/恢复用；PID参数与目标值不在其中）
+struct loop_state_t {
+    pid_state_t id_pid;
+    pid_state_t iq_pid;
+    pid_state_t vel_pid;
+    pid_state_t pos_pid;
+    double iq_ref_internal = 0.0;
+    double vel_ref_internal = 0.0;
+    control_target_t output;
+};
+
+// 控制通路标量类型的反馈量（相当于固件中ADC/编码器采样后的定标值）
+// double控制通路直接使用motor_state_t
+template<typename T>
+struct basic_feedback_t {
+    T theta_e{};
+    T omega_m{};
+    T id{};
+    T iq{};
+};
+
+// 三环级联计算核（按标量类型实例化，double实例即loop_controller的计算）
+// 位置环 -> 速度环 -> 电流环，各环输出作为下一环输入；PER_UNIT类型的信号与参数按
+// per_unit_base_t标幺化：位置环 角度->速度，速度环 速度->电流，电流环 电流->电压
+// STATE为motor_state_t（double）或basic_feedback_t<T>
+template<typename T>
+class basic_loop_controller {
+public:
+    using traits = scalar_traits<T>;
+
+    // 标幺化基值（仅PER_UNIT类型生效），修改后按新基值重新折算参数与目标
+    void set_base(const per_unit_base_t& base) {
+        if constexpr (traits::PER_UNIT) {
+            m_base = base;
+            set_current_pid(m_id_pid.params(), m_iq_pid.params());
+            set_velocity_pid(m_vel_pid.params());
+            set_position_pid(m_pos_pid.params());
+            set_target(m_target);
+        }
+    }
+    const per_unit_base_t& base() const { return m_base; }
+
+    // 环路启用/禁用
+    void set_current_loop_enabled(bool en) { m_current_enabled = en; }
+    void set_velocity_loop_enabled(bool en) { m_velocity_enabled = en; }
+    void set_position_loop_enabled(bool en) { m_position_enabled = en; }
+    bool is_current_loop_enabled() const { return m_current_enabled; }
+    bool is_velocity_loop_enabled() const { return m_velocity_enabled; }
+    bool is_position_loop_enabled() const { return m_position_enabled; }
+
+    // PID参数（物理单位）
+    void set_current_pid(const pid_params_t& id_pid, const pid_params_t& iq_pid) {
+        m_id_pid.set_params(id_pid, m_base.current, m_base.voltage);
+        m_iq_pid.set_params(iq_pid, m_base.current, m_base.voltage);
+    }
+    void set_velocity_pid(const pid_params_t& pid) { m_vel_pid.set_params(pid, m_base.speed, m_base.current); }
+    void set_position_pid(const pid_params_t& pid) { m_pos_pid.set_params(pid, m_base.angle, m_base.speed); }
+    const pid_params_t& id_pid() const { return m_id_pid.params(); }
+    const pid_params_t& iq_pid() const { return m_iq_pid.params(); }
+    const pid_params_t& vel_pid() const { return m_vel_pid.params(); }
+    const pid_params_t& pos_pid() const { return m_pos_pid.params(); }
+
+    // 目标值（物理单位）
+    void set_target(const control_target_t& target) {
+        m_target = target;
+        m_id_ref = traits::from_double(target.id_ref / m_base.current);
+        m_iq_ref = traits::from_double(target.iq_ref / m_base.current);
+        m_vel_ref = traits::from_double(target.vel_ref / m_base.speed);
+        m_pos_ref = traits::from_double(target.pos_ref / m_base.angle);
+    }
+    const control_target_t& target() const { return m_target; }
+
+    // 从另一标量类型的控制器复制参数、环路开关与目标（内部状态不复制）
+    template<typename U>
+    void copy_config(const basic_loop_controller<U>& src) {
+        m_current_enabled = src.is_current_loop_enabled();
+        m_velocity_enabled = src.is_velocity_loop_enabled();
+        m_position_enabled = src.is_position_loop_enabled();
+        set_current_pid(src.id_pid(), src.iq_pid());
+        set_velocity_pid(src.vel_pid());
+        set_position_pid(src.pos_pid());
+        set_target(src.target());
+    }
+
+    // 采样量化：物理单位状态 -> 控制通路反馈量
+    basic_feedback_t<T> quantize(const motor_state_t& st) const {
+        basic_feedback_t<T> fb;
+        fb.theta_e = traits::from_double(st.theta_e / m_base.angle);
+        fb.omega_m = traits::from_double(st.omega_m / m_base.speed);
+        fb.id = traits::from_double(st.id / m_base.current);
+        fb.iq = traits::from_double(st.iq / m_base.current);
+        return fb;
+    }
+
+    // 内部参考值与保持输出（控制通路标量）
+    T iq_ref() const { return m_iq_ref_internal; }
+    T vel_ref() const { return m_vel_ref_internal; }
+    T ud() const { return m_out_ud; }
+    T uq() const { return m_out_uq; }
+
+    // 保持输出（物理单位；id_ref/iq_ref字段为ud/uq电压）
+    control_target_t output() const {
+        control_target_t out;
+        out.id_ref = traits::to_double(m_out_ud) * m_base.voltage;
+        out.iq_ref = traits::to_double(m_out_uq) * m_base.voltage;
+        out.vel_ref = traits::to_double(m_out_vel_ref) * m_base.speed;
+        out.pos_ref = traits::to_double(m_out_pos_ref) * m_base.angle;
+        return out;
+    }
+
+    // 各环单独执行（多速率调度），环路开关为编译期参数
+    template<bool POSITION, typename STATE>
+    void update_position_t(const STATE& state, double dt) {
+        if constexpr (POSITION) {
+            m_vel_ref_internal = m_pos_pid.calc(m_pos_ref, state.theta_e, dt);
+        }
+    }
+
+    template<bool POSITION, bool VELOCITY, typename STATE>
+    void update_velocity_t(const STATE& state, double dt) {
+        // 当前速度参考值（来自位置环或直接设定）
+        const T vel_ref = POSITION ? m_vel_ref_internal : m_vel_ref;
+        m_vel_ref_internal = vel_ref;
+
+        if constexpr (VELOCITY) {
+            m_iq_ref_internal = m_vel_pid.calc(vel_ref, state.omega_m, dt);
+        }
+    }
+
+    template<bool VELOCITY, bool CURRENT, typename STATE>
+    void update_current_t(const STATE& state, double dt) {
+        // 当前iq参考值（来自速度环或直接设定）
+        const T iq_ref = VELOCITY ? m_iq_ref_internal : m_iq_ref;
+        m_iq_ref_internal = iq_ref;
+
+        T ud{}, uq{};
+        if constexpr (CURRENT) {
+            // id通常控制为0（表贴式PMSM）
+            ud = m_id_pid.calc(m_id_ref, state.id, dt);
+            uq = m_iq_pid.calc(iq_ref, state.iq, dt);
+        }
+
+        // 输出dq轴电压
+        m_out_ud = ud;
+        m_out_uq = uq;
+        m_out_vel_ref = m_vel_ref_internal;
+        m_out_pos_ref = m_pos_ref;
+    }
+
+    // 各环单独执行，按运行期环路开关转调编译期版本
+    template<typename STATE>
+    void update_position(const STATE& state, double dt) {
+        if (m_position_enabled) {
+            update_position_t<true>(state, dt);
+        }
+    }
+
+    template<typename STATE>
+    void update_velocity(const STATE& state, double dt) {
+        if (m_position_enabled) {
+            m_velocity_enabled ? update_velocity_t<true, true>(state, dt)
+                               : update_velocity_t<true, false>(state, dt);
+        } else {
+            m_velocity_enabled ? update_velocity_t<false, true>(state, dt)
+                               : update_velocity_t<false, false>(state, dt);
+        }
+    }
+
+    template<typename STATE>
+    void update_current(const STATE& state, double dt) {
+        if (m_velocity_enabled) {
+            m_current_enabled ? update_current_t<true, true>(state, dt)
+                              : update_current_t<true, false>(state, dt);
+        } else {
+            m_current_enabled ? update_current_t<false, true>(state, dt)
+                              : update_current_t<false, false>(state, dt);
+        }
+    }
+
+    // 保存/恢复内部状态（物理单位）
+    loop_state_t save_state() const {
+        loop_state_t st;
+        st.id_pid = m_id_pid.save_state();
+        st.iq_pid = m_iq_pid.save_state();
+        st.vel_pid = m_vel_pid.save_state();
+        st.pos_pid = m_pos_pid.save_state();
+        st.iq_ref_internal = traits::to_double(m_iq_ref_internal) * m_base.current;
+        st.vel_ref_internal = traits::to_double(m_vel_ref_internal) * m_base.speed;
+        st.output = output();
+        return st;
+    }
+
+    void restore_state(const loop_state_t& st) {
+        m_id_pid.restore_state(st.id_pid);
+        m_iq_pid.restore_state(st.iq_pid);
+        m_vel_pid.restore_state(st.vel_pid);
+        m_pos_pid.restore_state(st.pos_pid);
+        m_iq_ref_internal = traits::from_double(st.iq_ref_internal / m_base.current);
+        m_vel_ref_internal = traits::from_double(st.vel_ref_internal / m_base.speed);
+        m_out_ud = traits::from_double(st.output.id_ref / m_base.voltage);
+        m_out_uq = traits::from_double(st.output.iq_ref / m_base.voltage);
+        m_out_vel_ref = traits::from_double(st.output.vel_ref / m_base.speed);
+        m_out_pos_ref = traits::from_double(st.output.pos_ref / m_base.angle);
+    }
+
+    // 复位PID内部状态与保持输出
+    void reset() {
+        m_id_pid.reset();
+        m_iq_pid.reset();
+        m_vel_pid.reset();
+        m_pos_pid.reset();
+        m_out_ud = T{};
+        m_out_uq = T{};
+        m_out_vel_ref = T{};
+        m_out_pos_ref = T{};
+    }
+
+    // 清零内部参考值
+    void reset_refs() {
+        m_iq_ref_internal = T{};
+        m_vel_ref_internal = T{};
+    }
+
+private:
+    per_unit_base_t m_base;
+
+    bool m_current_enabled = true;
+    bool m_velocity_enabled = true;
+    bool m_position_enabled = false;
+
+    basic_pid<T> m_id_pid;
+    basic_pid<T> m_iq_pid;
+    basic_pid<T> m_vel_pid;
+    basic_pid<T> m_pos_pid;
+
+    // 目标值（物理单位原值与控制通路标量）
+    control_target_t m_target;
+    T m_id_ref{};
+    T m_iq_ref{};
+    T m_vel_ref{};
+    T m_pos_ref{};
+
+    // 内部计算的参考值（多速率模式下即各外环的保持输出）
+    T m_iq_ref_internal{};
+    T m_vel_ref_internal{};
+
+    // 电流环保持输出
+    T m_out_ud{};
+    T m_out_uq{};
+    T m_out_vel_ref{};
+    T m_out_pos_ref{};
+};
+
+// 由控制参数推算标幺化基值：电压取母线电压，电流、速度取对应外环输出限幅与目标的两倍，
+// 角度取2π（电角度[0, 2π)映射到[0, 1)）；留出两倍裕量以容纳超调
+inline per_unit_base_t suggest_per_unit_base(const pid_params_t& vel_pid, const pid_params_t& pos_pid,
+                                             const control_target_t& target, double udc) {
+    auto span = [](std::initializer_list<double> values) {
+        double m = 0.0;
+        for (double v : values) m = std::max(m, std::abs(v));
+        return m > 0.0 ? 2.0 * m : 1.0;
+    };
+    per_unit_base_t base;
+    base.voltage = udc;
+    base.current = span({vel_pid.out_max, vel_pid.out_min, target.iq_ref, target.id_ref});
+    base.speed = span({pos_pid.out_max, pos_pid.out_min, target.vel_ref});
+    base.angle = TWO_PI;
+    return base;
+}
+
+#endif // CONTROL_BASIC_LOOP_CONTROLLER_H
@@ -2,23 +2,24 @@
 #define CONTROL_LOOP_CONTROLLER_H
 
 #include "core/types.h"
-#include "core/pid_controller.h"
+#include "basic_loop_controller.h"
 #include "i_loop_controller.h"
 
 // 三环控制器实现
 // 支持电流环、速度环、位置环级联控制
+// 级联计算由basic_loop_controller<double>完成，本类提供运行期接口与默认参数
 class loop_controller : public i_loop_controller {
 public:
     loop_controller();
 
     // 环路启用/禁用
-    void set_current_loop_enabled(bool en) override { m_current_enabled = en; }
-    void set_velocity_loop_enabled(bool en) override { m_velocity_enabled = en; }
-    void set_position_loop_enabled(bool en) override { m_position_enabled = en; }
+    void set_current_loop_enabled(bool en) override { m_core.set_current_loop_enabled(en); }
+    void set_velocity_loop_enabled(bool en) override { m_core.set_velocity_loop_enabled(en); }
+    void set_position_loop_enabled(bool en) override { m_core.set_position_loop_enabled(en); }
 
-    bool is_current_loop_enabled() const { return m_current_enabled; }
-    bool is_velocity_loop_enabled() const { return m_velocity_enabled; }
-    bool is_position_loop_enabled() const { return m_position_enabled; }
+    bool is_current_loop_enabled() const { return m_core.is_current_loop_enabled(); }
+    bool is_velocity_loop_enabled() const { return m_core.is_velocity_loop_enabled(); }
+    bool is_position_loop_enabled() const { return m_core.is_position_loop_enabled(); }
 
     // 设置PID参数
     void set_current_pid(const pid_params_t& id_pid, const pid_params_t& iq_pid) override;
@@ -26,23 +27,55 @@ public:
     void set_position_pid(const pid_params_t& pid) override;
 
     // 获取PID参数
-    pid_params_t get_id_pid() const { return m_id_pid.get_params(); }
-    pid_params_t get_iq_pid() const { return m_iq_pid.get_params(); }
-    pid_params_t get_vel_pid() const { return m_vel_pid.get_params(); }
-    pid_params_t get_pos_pid() const { return m_pos_pid.get_params(); }
+    pid_params_t get_id_pid() const { return m_core.id_pid(); }
+    pid_params_t get_iq_pid() const { return m_core.iq_pid(); }
+    pid_params_t get_vel_pid() const { return m_core.vel_pid(); }
+    pid_params_t get_pos_pid() const { return m_core.pos_pid(); }
 
     // 设置目标值
-    void set_target(const control_target_t& target) override { m_target = target; }
-    control_target_t get_target() const { return m_target; }
+    void set_target(const control_target_t& target) override { m_core.set_target(target); }
+    control_target_t get_target() const { return m_core.target(); }
     
     // 获取内部计算的参考值（用于UI显示）
-    double get_id_ref() const { return m_target.id_ref; }
-    double get_iq_ref() const { return m_iq_ref_internal; }
-    double get_vel_ref() const { return m_vel_ref_internal; }
+    double get_id_ref() const { return m_core.target().id_ref; }
+    double get_iq_ref() const { return m_core.iq_ref(); }
+    double get_vel_ref() const { return m_core.vel_ref(); }
 
-    // 计算控制输出
+    // 计算控制输出（三环同周期执行）
     control_target_t calc(const motor_state_t& state, double dt) override;
 
+    // 多速率执行：各环可按不同周期单独更新，输出保持至该环下次执行（零阶保持）
+    // 同一时刻需按 位置环 -> 速度环 -> 电流环 顺序调用；dt为该环自身的执行周期
+    void update_position(const motor_state_t& state, double dt) { m_core.update_position(state, dt); }
+    void update_velocity(const motor_state_t& state, double dt) { m_core.update_velocity(state, dt); }
+    void update_current(const motor_state_t& state, double dt) { m_core.update_current(state, dt); }
+
+    // 编译期环路配置版本：环路开关作为模板参数，sim_pipeline按具体类型调用时整体内联展开
+    // 运行期版本按成员开关转调到对应实例，两者计算完全一致
+    template<bool POSITION>
+    void update_position_t(const motor_state_t& state, double dt) {
+        m_core.update_position_t<POSITION>(state, dt);
+    }
+    template<bool POSITION, bool VELOCITY>
+    void update_velocity_t(const motor_state_t& state, double dt) {
+        m_core.update_velocity_t<POSITION, VELOCITY>(state, dt);
+    }
+    template<bool VELOCITY, bool CURRENT>
+    void update_current_t(const motor_state_t& state, double dt) {
+        m_core.update_current_t<VELOCITY, CURRENT>(state, dt);
+    }
+
+    // 当前保持的控制输出（id_ref/iq_ref字段为ud/uq电压，与calc一致）
+    control_target_t get_output() const { return m_core.output(); }
+
+    // 保存/恢复内部状态（仿真检查点）
+    loop_state_t save_state() const { return m_core.save_state(); }
+    void restore_state(const loop_state_t& st) { m_core.restore_state(st); }
+
+    // 级联计算核（sim_pipeline直接调用，其他标量类型的控制通路从中复制配置）
+    basic_loop_controller<double>& core() { return m_core; }
+    const basic_loop_controller<double>& core() const { return m_core; }
+
     // 复位所有控制器（仅内部状态）
     void reset() override;
     
@@ -50,20 +83,7 @@ public:
     void reset_to_default();
 
 private:
-    bool m_current_enabled = true;
-    bool m_velocity_enabled = true;
-    bool m_position_enabled = false;
-
-    pid_controller m_id_pid;
-    pid_controller m_iq_pid;
-    pid_controller m_vel_pid;
-    pid_controller m_pos_pid;
-
-    control_target_t m_target;
-    
-    // 内部计算的参考值（用于UI显示）
-    double m_iq_ref_internal = 0.0;
-    double m_vel_ref_internal = 0.0;
+    basic_loop_controller<double> m_core;
 };
 
 #endif // CONTROL_LOOP_CONTROLLER_H
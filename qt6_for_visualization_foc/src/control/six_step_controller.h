@@ -3,6 +3,12 @@
 
 #include "core/types.h"
 
+// 六步换向控制器动态状态（仿真检查点保存/恢复用）
+struct six_step_state_t {
+    double duty = 0.5;
+    double integral = 0.0;
+};
+
 // BLDC六步换向控制器
 // 根据转子位置（霍尔信号或反电动势过零检测）确定导通相
 class six_step_controller {
@@ -30,6 +36,10 @@ public:
     // 设置速度环PI参数
     void set_speed_pid(double kp, double ki) { m_kp = kp; m_ki = ki; }
     
+    // 保存/恢复内部状态（仿真检查点）
+    six_step_state_t save_state() const { return {m_duty, m_integral}; }
+    void restore_state(const six_step_state_t& st) { m_duty = st.duty; m_integral = st.integral; }
+
     // 复位
     void reset();
 
@@ -1,4 +1,5 @@
 #include "bldc_model.h"
+#include "fast_trig.h"
 #include <cmath>
 
 bldc_model::bldc_model() {
@@ -9,15 +10,6 @@ void bldc_model::set_params(const motor_params_t& params) {
     m_params = params;
 }
 
-void bldc_model::set_voltage(double ud, double uq) {
-    m_state.ud = ud;
-    m_state.uq = uq;
-}
-
-void bldc_model::set_load_torque(double tl) {
-    m_state.tl = tl;
-}
-
 // 梯形波反电动势系数计算
 // 返回值范围[-1, 1]，表示该相反电动势相对于最大值的比例
 double bldc_model::calc_bemf_coeff(double theta_e, int phase) const {
@@ -53,6 +45,19 @@ double bldc_model::calc_bemf_coeff(double theta_e, int phase) const {
 // BLDC电机仿真步进
 // 使用dq轴模型，但反电动势采用梯形波
 void bldc_model::step(double dt) {
+    switch (m_integrator.method) {
+        case e_integrator::RK4:
+        case e_integrator::RK45:
+        case e_integrator::ZOH:     // 梯形波反电动势无精确离散形式，按RK4处理
+            step_ode(dt);
+            break;
+        default:
+            step_euler(dt);
+            break;
+    }
+}
+
+void bldc_model::step_euler(double dt) {
     // 电流微分方程（简化模型，使用等效电感）
     // 假设Ld≈Lq=L，Rs为定子电阻
     double L = (m_params.ld + m_params.lq) / 2.0;
@@ -86,6 +91,51 @@ void bldc_model::step(double dt) {
     // 计算αβ和abc电流
     calc_alpha_beta_currents();
     calc_abc_currents();
+    ++m_stats.accepted;
+    ++m_stats.rhs_evals;
+}
+
+// 高阶积分：一次step内ud/uq/tl保持不变，四个状态量联立积分
+void bldc_model::step_ode(double dt) {
+    ode_state_t x = { m_state.id, m_state.iq, m_state.omega_m, m_state.theta_e };
+    auto f = [this](const ode_state_t& s) { return derivative(s); };
+    if (m_integrator.method == e_integrator::RK45) {
+        if (!ode_solver::rk45(x, dt, m_rk45_h, m_integrator, m_stats, f)) {
+            ++m_stats.failed;
+        }
+    } else {
+        ode_solver::rk4(x, dt, m_integrator, m_stats, f);
+    }
+
+    m_state.id = x[0];
+    m_state.iq = x[1];
+    m_state.omega_m = x[2];
+    m_state.theta_e = x[3];
+    calc_torque();
+    m_state.omega_e = m_params.pole_pairs * m_state.omega_m;
+
+    // 角度归一化
+    m_state.theta_e = std::fmod(m_state.theta_e, TWO_PI);
+    if (m_state.theta_e < 0) m_state.theta_e += TWO_PI;
+    m_state.theta_m = m_state.theta_e / m_params.pole_pairs;
+
+    calc_alpha_beta_currents();
+    calc_abc_currents();
+}
+
+bldc_model::ode_state_t bldc_model::derivative(const ode_state_t& x) const {
+    const double L = (m_params.ld + m_params.lq) / 2.0;
+    const double id = x[0];
+    const double iq = x[1];
+    const double omega_m = x[2];
+    const double omega_e = m_params.pole_pairs * omega_m;
+    const double te = 1.5 * m_params.pole_pairs * m_params.psi_f * iq;
+    return {
+        (m_state.ud - m_params.rs * id + omega_e * L * iq) / L,
+        (m_state.uq - m_params.rs * iq - omega_e * (L * id + m_params.psi_f)) / L,
+        (te - m_state.tl - m_params.b * omega_m) / m_params.j,
+        omega_e
+    };
 }
 
 motor_state_t bldc_model::get_state() const {
@@ -98,6 +148,28 @@ motor_params_t bldc_model::get_params() const {
 
 void bldc_model::reset() {
     m_state = motor_state_t{};
+    m_stats = integrator_stats_t{};
+    m_rk45_h = 0.0;
+    m_rotation = rotation_t{};
+}
+
+void bldc_model::restore_state(const motor_checkpoint_t& cp) {
+    m_state = cp.state;
+    m_rotation = cp.rotation;
+    m_rk45_h = cp.rk45_h;
+}
+
+void bldc_model::set_integrator(const integrator_config_t& cfg) {
+    m_integrator = cfg;
+    m_rk45_h = 0.0;
+}
+
+integrator_config_t bldc_model::get_integrator() const {
+    return m_integrator;
+}
+
+integrator_stats_t bldc_model::get_integrator_stats() const {
+    return m_stats;
 }
 
 // BLDC电磁转矩计算
@@ -108,8 +180,9 @@ void bldc_model::calc_torque() {
 
 // 逆Park变换
 void bldc_model::calc_alpha_beta_currents() {
-    double cos_t = std::cos(m_state.theta_e);
-    double sin_t = std::sin(m_state.theta_e);
+    m_rotation = make_rotation(m_state.theta_e, m_trig_mode);
+    const double cos_t = m_rotation.cos_t;
+    const double sin_t = m_rotation.sin_t;
     m_state.i_alpha = m_state.id * cos_t - m_state.iq * sin_t;
     m_state.i_beta  = m_state.id * sin_t + m_state.iq * cos_t;
     
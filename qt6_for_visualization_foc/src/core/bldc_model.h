@@ -2,23 +2,46 @@
 #define CORE_BLDC_MODEL_H
 
 #include "i_motor_model.h"
+#include "ode_solver.h"
 #include "types.h"
 
 // BLDC无刷直流电机模型
 // 采用梯形波反电动势模型，支持FOC矢量控制
-class bldc_model : public i_motor_model {
+class bldc_model final : public i_motor_model {
 public:
     bldc_model();
 
     void set_params(const motor_params_t& params) override;
-    void set_voltage(double ud, double uq) override;
-    void set_load_torque(double tl) override;
+    void set_voltage(double ud, double uq) override { m_state.ud = ud; m_state.uq = uq; }
+    void set_load_torque(double tl) override { m_state.tl = tl; }
     void step(double dt) override;
     motor_state_t get_state() const override;
     motor_params_t get_params() const override;
     void reset() override;
+    void set_integrator(const integrator_config_t& cfg) override;
+    integrator_config_t get_integrator() const override;
+    integrator_stats_t get_integrator_stats() const override;
+    void set_trig_mode(e_trig_mode mode) override { m_trig_mode = mode; }
+    rotation_t get_rotation() const override { return m_rotation; }
+    motor_checkpoint_t save_state() const override { return {m_state, m_rotation, m_rk45_h}; }
+    void restore_state(const motor_checkpoint_t& cp) override;
+
+    // 按引用读取状态（按具体类型调用时避免motor_state_t整体拷贝，sim_pipeline使用）
+    const motor_state_t& state() const { return m_state; }
 
 private:
+    // 状态向量 [id, iq, omega_m, theta_e]
+    using ode_state_t = ode_vec_t<4>;
+
+    // 欧拉法单步（原模型实现）
+    void step_euler(double dt);
+
+    // RK4/RK45单步
+    void step_ode(double dt);
+
+    // 状态方程右端（电压、负载取当前值）
+    ode_state_t derivative(const ode_state_t& x) const;
+
     // 计算梯形波反电动势系数（基于电角度）
     double calc_bemf_coeff(double theta_e, int phase) const;
     
@@ -36,6 +59,13 @@ private:
     
     // 梯形波参数
     double m_flat_top = 2.094;  // 平顶区角度（120°=2π/3）
+
+    integrator_config_t m_integrator;
+    integrator_stats_t m_stats;
+    double m_rk45_h = 0.0;      // RK45建议子步长（跨step保留）
+
+    e_trig_mode m_trig_mode = e_trig_mode::EXACT;
+    rotation_t m_rotation;      // 当前电角度的旋转因子
 };
 
 #endif // CORE_BLDC_MODEL_H
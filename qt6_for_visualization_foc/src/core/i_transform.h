@@ -1,6 +1,8 @@
 #ifndef CORE_I_TRANSFORM_H
 #define CORE_I_TRANSFORM_H
 
+#include "types.h"
+
 // 坐标变换接口
 class i_transform {
 public:
@@ -21,6 +23,12 @@ public:
     // 逆Park变换: dq -> αβ
     virtual void inv_park(double ud, double uq, double theta,
                           double& u_alpha, double& u_beta) = 0;
+
+    // Park/逆Park变换（复用已计算的旋转因子，不再计算三角函数）
+    virtual void park(double i_alpha, double i_beta, const rotation_t& rot,
+                      double& id, double& iq) = 0;
+    virtual void inv_park(double ud, double uq, const rotation_t& rot,
+                          double& u_alpha, double& u_beta) = 0;
 };
 
 #endif // CORE_I_TRANSFORM_H
@@ -0,0 +1,68 @@
+/**
+ * @file inverter_model.cpp
+ * @brief 三相两电平逆变器开关模型
+ *
+ * 中心对齐PWM的开关边沿与死区处理，见inverter_model.h。
+ * 相电压（对电机中性点）由三相开关状态S∈{0,1}决定：
+ *   ua = Udc·(2Sa - Sb - Sc)/3，uα = ua，uβ = Udc·(Sb - Sc)/√3
+ */
+#include "inverter_model.h"
+#include <algorithm>
+
+void inverter_model::start_period(double ta, double tb, double tc, double period) {
+    m_state.duty[0] = ta;
+    m_state.duty[1] = tb;
+    m_state.duty[2] = tc;
+    m_state.period = period;
+    m_state.tau = 0.0;
+    update_events();
+}
+
+void inverter_model::update_events() {
+    const double period = m_state.period;
+    const double td = m_cfg.dead_time > 0.0 ? m_cfg.dead_time : 0.0;
+    m_event_count = 0;
+    for (int k = 0; k < 3; ++k) {
+        const double d = m_state.duty[k];
+        double* e = m_edges[k];
+        e[0] = 0.5 * (1.0 - d) * period;
+        e[1] = e[0] + td;
+        e[2] = 0.5 * (1.0 + d) * period;
+        e[3] = e[2] + td;
+        // 占空比0或1时该相不开关，也就没有死区
+        if (d <= 0.0 || d >= 1.0) continue;
+        for (double t : {e[0], e[1], e[2], e[3]}) {
+            if (t > 0.0 && t < period) m_events[m_event_count++] = t;
+        }
+    }
+    std::sort(m_events, m_events + m_event_count);
+    m_event_count = static_cast<int>(std::unique(m_events, m_events + m_event_count) - m_events);
+}
+
+double inverter_model::next_event(double tau) const {
+    const double* end = m_events + m_event_count;
+    const double* it = std::upper_bound(m_events, end, tau);
+    return it != end ? *it : m_state.period;
+}
+
+void inverter_model::phase_voltage(const motor_state_t& st, double tau,
+                                   double& u_alpha, double& u_beta) const {
+    const double current[3] = {st.ia, st.ib, st.ic};
+    int s[3];
+    for (int k = 0; k < 3; ++k) {
+        const double d = m_state.duty[k];
+        const double* e = m_edges[k];
+        if (d >= 1.0) {
+            s[k] = 1;
+        } else if (d <= 0.0 || tau < e[0] || tau >= e[3]) {
+            s[k] = 0;
+        } else if (tau >= e[1] && tau < e[2]) {
+            s[k] = 1;
+        } else {
+            // 死区：上下管均关断，续流二极管导通
+            s[k] = current[k] < 0.0 ? 1 : 0;
+        }
+    }
+    u_alpha = m_udc * (2 * s[0] - s[1] - s[2]) / 3.0;
+    u_beta = m_udc * (s[1] - s[2]) * ONE_DIV_SQRT3;
+}
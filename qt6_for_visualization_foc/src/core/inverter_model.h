@@ -0,0 +1,107 @@
+#ifndef CORE_INVERTER_MODEL_H
+#define CORE_INVERTER_MODEL_H
+
+#include "types.h"
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// 三相两电平逆变器开关模型（事件驱动）
+// 每个PWM周期锁存SVPWM占空比，按中心对齐（七段式）比较得到各相开关边沿：
+//   上升沿 t_r = (1-d)/2·T，下降沿 t_f = (1+d)/2·T
+// 死区td内上下管均关断，相电压由续流二极管决定：电流流出(i>0)接负母线，流入接正母线，
+// 因此各相在 t_r、t_r+td、t_f、t_f+td 处可能切换。一个周期内至多12个事件时刻，
+// 电机模型在相邻事件之间以恒定开关状态推进（段长即精确事件间隔），而非按微秒级细分步长过采样。
+// 死区内的相电流方向取段起点的值（段内过零及零电流箝位不再细分）。
+// 段长随占空比变化，ZOH积分器每段都要重算离散矩阵，开关模型宜配合EULER/RK4使用
+class inverter_model {
+public:
+    void set_config(const inverter_config_t& cfg) { m_cfg = cfg; update_events(); }
+    const inverter_config_t& config() const { return m_cfg; }
+    void set_udc(double udc) { m_udc = udc; }
+
+    // 新PWM周期起点：锁存占空比与周期
+    void start_period(double ta, double tb, double tc, double period);
+
+    // 推进电机模型h秒（可跨越周期边界，未锁存新占空比时按原占空比重复下一周期）
+    // MODEL为具体电机类型或i_motor_model，需提供set_voltage/step与state()或get_state()
+    template<typename MODEL>
+    void advance(MODEL& model, double h);
+
+    // 保存/恢复动态状态（仿真检查点）
+    inverter_state_t save_state() const { return m_state; }
+    void restore_state(const inverter_state_t& st) { m_state = st; update_events(); }
+    void reset() { m_state = inverter_state_t{}; m_segments = 0; update_events(); }
+
+    // 自上次reset起电机模型推进的段数
+    uint64_t segment_count() const { return m_segments; }
+
+private:
+    // 读取电机状态（具体类型按引用，接口类型按值）
+    template<typename MODEL, typename = void>
+    struct has_state : std::false_type {};
+    template<typename MODEL>
+    struct has_state<MODEL, std::void_t<decltype(std::declval<const MODEL&>().state())>> : std::true_type {};
+
+    template<typename MODEL>
+    static decltype(auto) read_state(const MODEL& model) {
+        if constexpr (has_state<MODEL>::value) return model.state();
+        else return model.get_state();
+    }
+
+    // 按占空比与死区计算各相边沿并合并为有序事件表
+    void update_events();
+
+    // tau之后的下一个事件时刻（无则为周期终点）
+    double next_event(double tau) const;
+
+    // 周期内tau时刻（段起点）的开关状态对应的αβ电压
+    void phase_voltage(const motor_state_t& st, double tau, double& u_alpha, double& u_beta) const;
+
+    inverter_config_t m_cfg;
+    inverter_state_t m_state;
+    double m_udc = 24.0;
+
+    double m_edges[3][4] = {};      // 各相 t_r, t_r+td, t_f, t_f+td
+    double m_events[12] = {};       // (0, T)内的有序事件时刻
+    int m_event_count = 0;
+    uint64_t m_segments = 0;
+};
+
+template<typename MODEL>
+void inverter_model::advance(MODEL& model, double h) {
+    const double period = m_state.period;
+    if (period <= 0.0) {
+        // 尚未锁存占空比（仿真起点前）：电压保持不变
+        model.step(h);
+        ++m_segments;
+        return;
+    }
+    // 周期终点容差，吸收tau累加的舍入误差
+    const double eps = 1e-9 * period;
+    while (h > eps) {
+        const double next = next_event(m_state.tau);
+        const bool to_event = next - m_state.tau <= h;
+        const double seg = to_event ? next - m_state.tau : h;
+
+        double u_alpha, u_beta;
+        {
+            const auto& st = read_state(model);
+            phase_voltage(st, m_state.tau, u_alpha, u_beta);
+            // 段中点电角度下的Park变换，段内转子转过的角度按二阶精度计入
+            const double theta = st.theta_e + 0.5 * st.omega_e * seg;
+            const double sin_t = std::sin(theta);
+            const double cos_t = std::cos(theta);
+            model.set_voltage(u_alpha * cos_t + u_beta * sin_t, -u_alpha * sin_t + u_beta * cos_t);
+        }
+        model.step(seg);
+        ++m_segments;
+
+        h -= seg;
+        m_state.tau = to_event ? next : m_state.tau + seg;
+        if (m_state.tau >= period - eps) m_state.tau = 0.0;
+    }
+}
+
+#endif // CORE_INVERTER_MODEL_H
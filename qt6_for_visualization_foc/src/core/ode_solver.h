@@ -0,0 +1,143 @@
+#ifndef CORE_ODE_SOLVER_H
+#define CORE_ODE_SOLVER_H
+
+#include "types.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+// 定长状态向量
+template<std::size_t N>
+using ode_vec_t = std::array<double, N>;
+
+// 常微分方程数值积分器
+// 针对电机模型的自治系统 dx/dt = f(x)：一次step内电压、负载视为常量（零阶保持）
+// f 为可调用对象：ode_vec_t<N> f(const ode_vec_t<N>& x)
+class ode_solver {
+public:
+    // 经典四阶龙格-库塔：span按h_max拆分为等长子步（h_max为0时单步）
+    template<std::size_t N, typename F>
+    static void rk4(ode_vec_t<N>& x, double span, const integrator_config_t& cfg,
+                    integrator_stats_t& stats, F&& f) {
+        int n = 1;
+        if (cfg.h_max > 0.0 && span > cfg.h_max) {
+            n = static_cast<int>(std::ceil(span / cfg.h_max));
+        }
+        const double h = span / n;
+        for (int s = 0; s < n; ++s) {
+            ode_vec_t<N> k1 = f(x);
+            ode_vec_t<N> k2 = f(axpy(x, 0.5 * h, k1));
+            ode_vec_t<N> k3 = f(axpy(x, 0.5 * h, k2));
+            ode_vec_t<N> k4 = f(axpy(x, h, k3));
+            for (std::size_t i = 0; i < N; ++i) {
+                x[i] += h / 6.0 * (k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i]);
+            }
+        }
+        stats.accepted += n;
+        stats.rhs_evals += 4LL * n;
+    }
+
+    // Dormand–Prince 5(4) 自适应积分：在[0, span]上积分
+    // h: 建议子步长（输入/输出，跨调用保留以避免每次从小步长重新试探）
+    // 返回false表示达到max_substeps上限：剩余区间改用定步长RK4（按h_max拆分）补完，
+    // x仍到达span终点，但该段不受误差控制
+    template<std::size_t N, typename F>
+    static bool rk45(ode_vec_t<N>& x, double span, double& h, const integrator_config_t& cfg,
+                     integrator_stats_t& stats, F&& f) {
+        // Butcher表（Dormand & Prince, 1980）
+        constexpr double a21 = 1.0 / 5.0;
+        constexpr double a31 = 3.0 / 40.0,       a32 = 9.0 / 40.0;
+        constexpr double a41 = 44.0 / 45.0,      a42 = -56.0 / 15.0,      a43 = 32.0 / 9.0;
+        constexpr double a51 = 19372.0 / 6561.0, a52 = -25360.0 / 2187.0, a53 = 64448.0 / 6561.0,
+                         a54 = -212.0 / 729.0;
+        constexpr double a61 = 9017.0 / 3168.0,  a62 = -355.0 / 33.0,     a63 = 46732.0 / 5247.0,
+                         a64 = 49.0 / 176.0,     a65 = -5103.0 / 18656.0;
+        constexpr double b1 = 35.0 / 384.0,      b3 = 500.0 / 1113.0,     b4 = 125.0 / 192.0,
+                         b5 = -2187.0 / 6784.0,  b6 = 11.0 / 84.0;
+        // 误差系数：五阶解 - 四阶解
+        constexpr double e1 = 71.0 / 57600.0,    e3 = -71.0 / 16695.0,    e4 = 71.0 / 1920.0,
+                         e5 = -17253.0 / 339200.0, e6 = 22.0 / 525.0,     e7 = -1.0 / 40.0;
+
+        if (span <= 0.0) return true;
+        const double h_cap = (cfg.h_max > 0.0) ? std::min(cfg.h_max, span) : span;
+        if (!(h > 0.0)) h = h_cap;
+        h = std::clamp(h, std::min(cfg.h_min, h_cap), h_cap);
+
+        ode_vec_t<N> k1 = f(x);
+        ++stats.rhs_evals;
+        ode_vec_t<N> y, k2, k3, k4, k5, k6, k7;
+        double t = 0.0;
+        int substeps = 0;
+        while (t < span) {
+            if (substeps++ >= cfg.max_substeps) {
+                rk4(x, span - t, cfg, stats, f);
+                return false;
+            }
+            const bool truncated = (h >= span - t);
+            const double step = truncated ? span - t : h;
+
+            for (std::size_t i = 0; i < N; ++i) y[i] = x[i] + step * a21 * k1[i];
+            k2 = f(y);
+            for (std::size_t i = 0; i < N; ++i) y[i] = x[i] + step * (a31 * k1[i] + a32 * k2[i]);
+            k3 = f(y);
+            for (std::size_t i = 0; i < N; ++i) y[i] = x[i] + step * (a41 * k1[i] + a42 * k2[i] + a43 * k3[i]);
+            k4 = f(y);
+            for (std::size_t i = 0; i < N; ++i) {
+                y[i] = x[i] + step * (a51 * k1[i] + a52 * k2[i] + a53 * k3[i] + a54 * k4[i]);
+            }
+            k5 = f(y);
+            for (std::size_t i = 0; i < N; ++i) {
+                y[i] = x[i] + step * (a61 * k1[i] + a62 * k2[i] + a63 * k3[i] + a64 * k4[i] + a65 * k5[i]);
+            }
+            k6 = f(y);
+            for (std::size_t i = 0; i < N; ++i) {
+                y[i] = x[i] + step * (b1 * k1[i] + b3 * k3[i] + b4 * k4[i] + b5 * k5[i] + b6 * k6[i]);
+            }
+            k7 = f(y);
+            stats.rhs_evals += 6;
+
+            // 加权RMS误差范数
+            double err = 0.0;
+            for (std::size_t i = 0; i < N; ++i) {
+                double ei = step * (e1 * k1[i] + e3 * k3[i] + e4 * k4[i] + e5 * k5[i] + e6 * k6[i] + e7 * k7[i]);
+                double sc = cfg.atol + cfg.rtol * std::max(std::abs(x[i]), std::abs(y[i]));
+                err += (ei / sc) * (ei / sc);
+            }
+            err = std::sqrt(err / N);
+
+            // 步长调整：安全系数0.9，单次缩放限制在[0.2, 5]
+            double factor = 5.0;
+            if (!std::isfinite(err)) {
+                factor = 0.2;
+            } else if (err > 0.0) {
+                factor = std::clamp(0.9 * std::pow(err, -0.2), 0.2, 5.0);
+            }
+
+            if ((std::isfinite(err) && err <= 1.0) || step <= cfg.h_min) {
+                x = y;
+                k1 = k7;    // FSAL：末级斜率即下一子步首级斜率
+                t = truncated ? span : t + step;
+                ++stats.accepted;
+                // 为对齐span而截短的子步不应缩小后续建议步长
+                h = truncated ? std::max(h, step * factor) : step * factor;
+            } else {
+                ++stats.rejected;
+                h = step * std::min(factor, 1.0);
+            }
+            h = std::clamp(h, std::min(cfg.h_min, h_cap), h_cap);
+        }
+        return true;
+    }
+
+private:
+    // x + a*k
+    template<std::size_t N>
+    static ode_vec_t<N> axpy(const ode_vec_t<N>& x, double a, const ode_vec_t<N>& k) {
+        ode_vec_t<N> r;
+        for (std::size_t i = 0; i < N; ++i) r[i] = x[i] + a * k[i];
+        return r;
+    }
+};
+
+#endif // CORE_ODE_SOLVER_H
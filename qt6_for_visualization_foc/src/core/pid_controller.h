@@ -3,27 +3,118 @@
 
 #include "types.h"
 #include "i_pid_controller.h"
+#include "scalar_traits.h"
+#include <algorithm>
+
+// PID计算核（按标量类型实例化，double实例即pid_controller的计算）
+// - 浮点类型：位置式PID，积分 ∫e·dt 与微分 Δe/dt 按调用时的dt计算
+// - 定点类型：与固件相同的离散形式，Ki、Kd/dt预先折算为"系数+移位"，
+//   积分在accum_t（Q31）中累加，三项求和在wide_t中进行后统一限幅
+// in_base/out_base为输入误差与输出的标幺化基值（浮点类型取1，参数即物理单位）
+template<typename T>
+class basic_pid {
+public:
+    using traits = scalar_traits<T>;
+    using accum_t = typename traits::accum_t;
+    using wide_t = typename traits::wide_t;
+
+    basic_pid() { set_params(pid_params_t{}); }
+
+    void set_params(const pid_params_t& params, double in_base = 1.0, double out_base = 1.0) {
+        m_params = params;
+        m_in_base = in_base;
+        m_out_base = out_base;
+        const double scale = in_base / out_base;
+        m_kp = traits::gain(params.kp * scale);
+        m_ki = scalar_traits<accum_t>::gain(params.ki * scale);
+        m_kd = traits::gain(params.kd * scale);
+        m_out_min = traits::from_double(params.out_min / out_base);
+        m_out_max = traits::from_double(params.out_max / out_base);
+        m_integral_max = scalar_traits<accum_t>::from_double(params.integral_max / in_base);
+        m_gain_dt = 0.0;
+    }
+    const pid_params_t& params() const { return m_params; }
+
+    T calc(T target, T feedback, double dt) {
+        const T error = target - feedback;
+        if constexpr (traits::PER_UNIT) {
+            if (dt != m_gain_dt) update_gains(dt);
+            m_integral = std::clamp(m_integral + fixed_cast<accum_t>(error) * m_dt,
+                                    -m_integral_max, m_integral_max);
+            const wide_t p = traits::widen(error * m_kp);
+            const wide_t i = traits::widen(fixed_cast<T>(m_integral * m_ki));
+            const wide_t d = traits::widen((error - m_prev_error) * m_kd_dt);
+            m_prev_error = error;
+            return traits::narrow(std::clamp(p + i + d, traits::widen(m_out_min), traits::widen(m_out_max)));
+        } else {
+            const T dt_t = traits::from_double(dt);
+            m_integral += error * dt_t;
+            m_integral = std::clamp(m_integral, -m_integral_max, m_integral_max);
+            const T derivative = (error - m_prev_error) / dt_t;
+            m_prev_error = error;
+            const T output = m_kp * error + m_ki * m_integral + m_kd * derivative;
+            return std::clamp(output, m_out_min, m_out_max);
+        }
+    }
+
+    void reset() { m_integral = accum_t{}; m_prev_error = T{}; }
+
+    // 内部状态（物理单位）
+    double integral() const { return scalar_traits<accum_t>::to_double(m_integral) * m_in_base; }
+    double prev_error() const { return traits::to_double(m_prev_error) * m_in_base; }
+    pid_state_t save_state() const { return {integral(), prev_error()}; }
+    void restore_state(const pid_state_t& st) {
+        m_integral = scalar_traits<accum_t>::from_double(st.integral / m_in_base);
+        m_prev_error = traits::from_double(st.prev_error / m_in_base);
+    }
+
+private:
+    // 定点：随dt变化的系数（dt不变时只计算一次）
+    void update_gains(double dt) {
+        m_gain_dt = dt;
+        m_dt = scalar_traits<accum_t>::gain(dt);
+        m_kd_dt = traits::gain(m_params.kd * (m_in_base / m_out_base) / dt);
+    }
+
+    pid_params_t m_params;
+    double m_in_base = 1.0;
+    double m_out_base = 1.0;
+    typename traits::gain_t m_kp{};
+    typename scalar_traits<accum_t>::gain_t m_ki{};
+    typename traits::gain_t m_kd{};
+    T m_out_min{};
+    T m_out_max{};
+    accum_t m_integral_max{};
+    accum_t m_integral{};
+    T m_prev_error{};
+    double m_gain_dt = 0.0;
+    typename scalar_traits<accum_t>::gain_t m_dt{};
+    typename traits::gain_t m_kd_dt{};
+};
 
 // PID控制器实现
 // 支持积分限幅和输出限幅
+// calc在头文件中内联定义，按具体类型调用时（loop_controller、sim_pipeline）可被编译器展开
 class pid_controller : public i_pid_controller {
 public:
     pid_controller() = default;
-    explicit pid_controller(const pid_params_t& params) : m_params(params) {}
+    explicit pid_controller(const pid_params_t& params) { m_core.set_params(params); }
 
-    void set_params(const pid_params_t& params) override { m_params = params; }
-    double calc(double target, double feedback, double dt) override;
-    void reset() override { m_integral = 0.0; m_prev_error = 0.0; }
-    pid_params_t get_params() const override { return m_params; }
+    void set_params(const pid_params_t& params) override { m_core.set_params(params); }
+    double calc(double target, double feedback, double dt) override { return m_core.calc(target, feedback, dt); }
+    void reset() override { m_core.reset(); }
+    pid_params_t get_params() const override { return m_core.params(); }
 
     // 获取内部状态（用于调试）
-    double get_integral() const { return m_integral; }
-    double get_last_error() const { return m_prev_error; }
+    double get_integral() const { return m_core.integral(); }
+    double get_last_error() const { return m_core.prev_error(); }
+
+    // 保存/恢复内部状态（仿真检查点）
+    pid_state_t save_state() const { return m_core.save_state(); }
+    void restore_state(const pid_state_t& st) { m_core.restore_state(st); }
 
 private:
-    pid_params_t m_params;
-    double m_integral = 0.0;
-    double m_prev_error = 0.0;
+    basic_pid<double> m_core;
 };
 
 #endif // CORE_PID_CONTROLLER_H
@@ -0,0 +1,289 @@
+/**
+ * @file pmsm_batch_model.cpp
+ * @brief PMSM批量模型（SoA + SIMD）
+ *
+ * 与pmsm_model相同的dq轴电压方程、运动方程（欧拉法）和逆Park/逆Clark变换，
+ * 按SIMD宽度一次处理多台电机：
+ * - AVX2: 每次4台（需以 -mavx2 编译，见CMake选项FOC_ENABLE_AVX2）
+ * - SSE4.1: 每次2台
+ * - 其他平台: 标量循环（SoA布局仍便于编译器自动向量化）
+ * sin/cos与单机模型FAST模式共用fast_sincos<S>内核（见fast_trig.h，绝对误差≤3e-16）。
+ */
+#include "pmsm_batch_model.h"
+#include "fast_trig.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+// SIMD操作封装：内核以模板形式只写一份，按编译指令集选择实现
+// 接口与fast_trig.h的scalar_simd一致，sin/cos与单机模型共用fast_sincos<S>内核
+#if defined(__AVX2__) || defined(__SSE4_1__)
+// 象限判断（浮点运算，避免整数SIMD依赖）：n = k mod 4
+template<typename S>
+struct float_quadrant_ops {
+    template<typename V>
+    static V to_quadrant(V k) {
+        return S::sub(k, S::mul(S::set1(4.0), S::floor(S::mul(k, S::set1(0.25)))));
+    }
+    template<typename V>
+    static V quadrant_odd(V n) {
+        return S::cmp_eq(S::sub(n, S::mul(S::set1(2.0), S::floor(S::mul(n, S::set1(0.5))))), S::set1(1.0));
+    }
+    // n=2,3时sin取负；n=1,2时cos取负
+    template<typename V>
+    static V quadrant_sin_neg(V n) { return S::cmp_ge(n, S::set1(2.0)); }
+    template<typename V>
+    static V quadrant_cos_neg(V n) {
+        return S::cmp_eq(S::floor(S::mul(S::add(n, S::set1(1.0)), S::set1(0.5))), S::set1(1.0));
+    }
+};
+#endif
+
+#if defined(__AVX2__)
+struct batch_simd : float_quadrant_ops<batch_simd> {
+    using vec = __m256d;
+    using mask = __m256d;
+    static constexpr std::size_t WIDTH = 4;
+    static constexpr const char* NAME = "AVX2";
+    static vec load(const double* p) { return _mm256_load_pd(p); }
+    static void store(double* p, vec v) { _mm256_store_pd(p, v); }
+    static vec set1(double x) { return _mm256_set1_pd(x); }
+    static vec add(vec a, vec b) { return _mm256_add_pd(a, b); }
+    static vec sub(vec a, vec b) { return _mm256_sub_pd(a, b); }
+    static vec mul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+    static vec round(vec a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static vec floor(vec a) { return _mm256_floor_pd(a); }
+    static mask cmp_eq(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static mask cmp_ge(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+    static mask cmp_lt(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    // mask为真取b，否则取a
+    static vec blend(vec a, vec b, mask m) { return _mm256_blendv_pd(a, b, m); }
+};
+#elif defined(__SSE4_1__)
+struct batch_simd : float_quadrant_ops<batch_simd> {
+    using vec = __m128d;
+    using mask = __m128d;
+    static constexpr std::size_t WIDTH = 2;
+    static constexpr const char* NAME = "SSE4.1";
+    static vec load(const double* p) { return _mm_load_pd(p); }
+    static void store(double* p, vec v) { _mm_store_pd(p, v); }
+    static vec set1(double x) { return _mm_set1_pd(x); }
+    static vec add(vec a, vec b) { return _mm_add_pd(a, b); }
+    static vec sub(vec a, vec b) { return _mm_sub_pd(a, b); }
+    static vec mul(vec a, vec b) { return _mm_mul_pd(a, b); }
+    static vec round(vec a) { return _mm_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static vec floor(vec a) { return _mm_floor_pd(a); }
+    static mask cmp_eq(vec a, vec b) { return _mm_cmpeq_pd(a, b); }
+    static mask cmp_ge(vec a, vec b) { return _mm_cmpge_pd(a, b); }
+    static mask cmp_lt(vec a, vec b) { return _mm_cmplt_pd(a, b); }
+    static vec blend(vec a, vec b, mask m) { return _mm_blendv_pd(a, b, m); }
+};
+#else
+using batch_simd = scalar_simd;
+#endif
+
+pmsm_batch_model::pmsm_batch_model(std::size_t count) {
+    resize(count);
+}
+
+const char* pmsm_batch_model::simd_name() {
+    return batch_simd::NAME;
+}
+
+std::size_t pmsm_batch_model::simd_width() {
+    return batch_simd::WIDTH;
+}
+
+std::vector<batch_array_t*> pmsm_batch_model::state_arrays() {
+    return {
+        &m_state.theta_e, &m_state.theta_m, &m_state.omega_e, &m_state.omega_m,
+        &m_state.id, &m_state.iq, &m_state.ud, &m_state.uq,
+        &m_state.ia, &m_state.ib, &m_state.ic,
+        &m_state.i_alpha, &m_state.i_beta, &m_state.u_alpha, &m_state.u_beta,
+        &m_state.ua, &m_state.ub, &m_state.uc,
+        &m_state.te, &m_state.tl
+    };
+}
+
+void pmsm_batch_model::resize(std::size_t count) {
+    const std::size_t width = batch_simd::WIDTH;
+    const std::size_t n = (count + width - 1) / width * width;
+    for (batch_array_t* a : state_arrays()) {
+        a->resize(n, 0.0);
+    }
+    for (batch_array_t* a : {
+             &m_params.rs, &m_params.ld, &m_params.lq, &m_params.psi_f, &m_params.b,
+             &m_params.inv_ld, &m_params.inv_lq, &m_params.inv_j,
+             &m_params.pole_pairs, &m_params.inv_pole_pairs, &m_params.torque_k }) {
+        a->resize(n, 0.0);
+    }
+
+    // 新增电机及补齐通道使用默认参数，保证补齐通道数值有限
+    const std::size_t old = m_raw_params.size();
+    m_raw_params.resize(n);
+    for (std::size_t i = old; i < n; ++i) {
+        write_params(i, motor_params_t{});
+    }
+    m_count = count;
+}
+
+void pmsm_batch_model::write_params(std::size_t i, const motor_params_t& params) {
+    m_raw_params[i] = params;
+    m_params.rs[i] = params.rs;
+    m_params.ld[i] = params.ld;
+    m_params.lq[i] = params.lq;
+    m_params.psi_f[i] = params.psi_f;
+    m_params.b[i] = params.b;
+    m_params.inv_ld[i] = 1.0 / params.ld;
+    m_params.inv_lq[i] = 1.0 / params.lq;
+    m_params.inv_j[i] = 1.0 / params.j;
+    m_params.pole_pairs[i] = params.pole_pairs;
+    m_params.inv_pole_pairs[i] = 1.0 / params.pole_pairs;
+    m_params.torque_k[i] = 1.5 * params.pole_pairs;
+}
+
+void pmsm_batch_model::set_params(std::size_t i, const motor_params_t& params) {
+    if (i < m_count) write_params(i, params);
+}
+
+void pmsm_batch_model::set_params_all(const motor_params_t& params) {
+    for (std::size_t i = 0; i < m_count; ++i) write_params(i, params);
+}
+
+motor_params_t pmsm_batch_model::get_params(std::size_t i) const {
+    return m_raw_params[i];
+}
+
+void pmsm_batch_model::set_voltage(std::size_t i, double ud, double uq) {
+    m_state.ud[i] = ud;
+    m_state.uq[i] = uq;
+}
+
+void pmsm_batch_model::set_load_torque(std::size_t i, double tl) {
+    m_state.tl[i] = tl;
+}
+
+// 批量步进：方程与pmsm_model::step逐项对应
+// （theta_m取更新前的theta_e，与单机模型保持一致）
+void pmsm_batch_model::step(double dt) {
+    using S = batch_simd;
+    using vec = S::vec;
+    pmsm_batch_state_t& st = m_state;
+    const batch_params_t& pr = m_params;
+    const vec v_dt = S::set1(dt);
+    const vec v_two_pi = S::set1(TWO_PI);
+    const vec v_zero = S::set1(0.0);
+    const vec v_half = S::set1(-0.5);
+    const vec v_s32 = S::set1(SQRT3_DIV_2);
+
+    const std::size_t n = padded();
+    for (std::size_t i = 0; i < n; i += S::WIDTH) {
+        const vec rs = S::load(&pr.rs[i]);
+        const vec ld = S::load(&pr.ld[i]);
+        const vec lq = S::load(&pr.lq[i]);
+        const vec psi_f = S::load(&pr.psi_f[i]);
+
+        vec id = S::load(&st.id[i]);
+        vec iq = S::load(&st.iq[i]);
+        const vec ud = S::load(&st.ud[i]);
+        const vec uq = S::load(&st.uq[i]);
+        const vec omega_e_old = S::load(&st.omega_e[i]);
+
+        // 电流微分方程
+        // did/dt = (ud - rs*id + omega_e*lq*iq) / ld
+        // diq/dt = (uq - rs*iq - omega_e*(ld*id + psi_f)) / lq
+        const vec did_dt = S::mul(S::add(S::sub(ud, S::mul(rs, id)), S::mul(S::mul(omega_e_old, lq), iq)),
+                                  S::load(&pr.inv_ld[i]));
+        const vec diq_dt = S::mul(S::sub(S::sub(uq, S::mul(rs, iq)),
+                                         S::mul(omega_e_old, S::add(S::mul(ld, id), psi_f))),
+                                  S::load(&pr.inv_lq[i]));
+        id = S::add(id, S::mul(did_dt, v_dt));
+        iq = S::add(iq, S::mul(diq_dt, v_dt));
+
+        // 电磁转矩: te = 1.5*p*(psi_f*iq + (ld-lq)*id*iq)
+        const vec te = S::mul(S::load(&pr.torque_k[i]),
+                              S::add(S::mul(psi_f, iq), S::mul(S::mul(S::sub(ld, lq), id), iq)));
+
+        // 运动方程: domega_m/dt = (te - tl - b*omega_m) / j
+        vec omega_m = S::load(&st.omega_m[i]);
+        const vec domega_m_dt = S::mul(S::sub(S::sub(te, S::load(&st.tl[i])),
+                                              S::mul(S::load(&pr.b[i]), omega_m)),
+                                       S::load(&pr.inv_j[i]));
+        omega_m = S::add(omega_m, S::mul(domega_m_dt, v_dt));
+        const vec omega_e = S::mul(S::load(&pr.pole_pairs[i]), omega_m);
+
+        vec theta_e = S::load(&st.theta_e[i]);
+        const vec theta_m = S::mul(theta_e, S::load(&pr.inv_pole_pairs[i]));
+        theta_e = S::add(theta_e, S::mul(omega_e, v_dt));
+
+        // 角度归一化到[0, 2π)（单步增量远小于2π，一次修正即可）
+        theta_e = S::blend(theta_e, S::sub(theta_e, v_two_pi), S::cmp_ge(theta_e, v_two_pi));
+        theta_e = S::blend(theta_e, S::add(theta_e, v_two_pi), S::cmp_lt(theta_e, v_zero));
+
+        // 逆Park变换: dq -> αβ
+        vec sin_t, cos_t;
+        fast_sincos<S>(theta_e, sin_t, cos_t);
+        const vec i_alpha = S::sub(S::mul(id, cos_t), S::mul(iq, sin_t));
+        const vec i_beta = S::add(S::mul(id, sin_t), S::mul(iq, cos_t));
+        const vec u_alpha = S::sub(S::mul(ud, cos_t), S::mul(uq, sin_t));
+        const vec u_beta = S::add(S::mul(ud, sin_t), S::mul(uq, cos_t));
+
+        // 逆Clark变换: αβ -> abc
+        const vec i_a_half = S::mul(v_half, i_alpha);
+        const vec i_b_s32 = S::mul(v_s32, i_beta);
+        const vec u_a_half = S::mul(v_half, u_alpha);
+        const vec u_b_s32 = S::mul(v_s32, u_beta);
+
+        S::store(&st.id[i], id);
+        S::store(&st.iq[i], iq);
+        S::store(&st.te[i], te);
+        S::store(&st.omega_m[i], omega_m);
+        S::store(&st.omega_e[i], omega_e);
+        S::store(&st.theta_m[i], theta_m);
+        S::store(&st.theta_e[i], theta_e);
+        S::store(&st.i_alpha[i], i_alpha);
+        S::store(&st.i_beta[i], i_beta);
+        S::store(&st.u_alpha[i], u_alpha);
+        S::store(&st.u_beta[i], u_beta);
+        S::store(&st.ia[i], i_alpha);
+        S::store(&st.ib[i], S::add(i_a_half, i_b_s32));
+        S::store(&st.ic[i], S::sub(i_a_half, i_b_s32));
+        S::store(&st.ua[i], u_alpha);
+        S::store(&st.ub[i], S::add(u_a_half, u_b_s32));
+        S::store(&st.uc[i], S::sub(u_a_half, u_b_s32));
+    }
+}
+
+motor_state_t pmsm_batch_model::get_state(std::size_t i) const {
+    motor_state_t s;
+    s.theta_e = m_state.theta_e[i];
+    s.theta_m = m_state.theta_m[i];
+    s.omega_e = m_state.omega_e[i];
+    s.omega_m = m_state.omega_m[i];
+    s.id = m_state.id[i];
+    s.iq = m_state.iq[i];
+    s.ud = m_state.ud[i];
+    s.uq = m_state.uq[i];
+    s.ia = m_state.ia[i];
+    s.ib = m_state.ib[i];
+    s.ic = m_state.ic[i];
+    s.i_alpha = m_state.i_alpha[i];
+    s.i_beta = m_state.i_beta[i];
+    s.u_alpha = m_state.u_alpha[i];
+    s.u_beta = m_state.u_beta[i];
+    s.ua = m_state.ua[i];
+    s.ub = m_state.ub[i];
+    s.uc = m_state.uc[i];
+    s.te = m_state.te[i];
+    s.tl = m_state.tl[i];
+    return s;
+}
+
+void pmsm_batch_model::reset() {
+    for (batch_array_t* a : state_arrays()) {
+        std::fill(a->begin(), a->end(), 0.0);
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef CORE_PMSM_BATCH_MODEL_H
+#define CORE_PMSM_BATCH_MODEL_H
+
+#include "types.h"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// 64字节对齐分配器（SoA数组按缓存行对齐，便于AVX2对齐加载）
+template<typename T>
+struct aligned_allocator {
+    using value_type = T;
+    static constexpr std::size_t ALIGN = 64;
+
+    aligned_allocator() = default;
+    template<typename U>
+    aligned_allocator(const aligned_allocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        std::size_t bytes = (n * sizeof(T) + ALIGN - 1) / ALIGN * ALIGN;
+        void* p = ::operator new(bytes, std::align_val_t(ALIGN));
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(ALIGN));
+    }
+
+    template<typename U>
+    bool operator==(const aligned_allocator<U>&) const { return true; }
+    template<typename U>
+    bool operator!=(const aligned_allocator<U>&) const { return false; }
+};
+
+using batch_array_t = std::vector<double, aligned_allocator<double>>;
+
+// 批量电机状态（SoA布局：每个字段一个数组，下标为电机编号）
+// 字段含义与motor_state_t一致
+struct pmsm_batch_state_t {
+    batch_array_t theta_e, theta_m, omega_e, omega_m;
+    batch_array_t id, iq, ud, uq;
+    batch_array_t ia, ib, ic;
+    batch_array_t i_alpha, i_beta, u_alpha, u_beta;
+    batch_array_t ua, ub, uc;
+    batch_array_t te, tl;
+};
+
+// PMSM批量模型
+// N台电机以SoA布局存储，一次step调用推进全部电机：
+// - 方程与pmsm_model::step（欧拉法）及calc_alpha_beta_currents/calc_abc_currents一致
+// - 编译期按指令集选择AVX2(4路)/SSE4.1(2路)/标量内核，无虚函数调用
+// - 适用于参数离散的电机群蒙特卡洛容差分析
+class pmsm_batch_model {
+public:
+    explicit pmsm_batch_model(std::size_t count = 0);
+
+    // 设置电机数量（保留已有电机的参数与状态，新增电机使用默认参数）
+    void resize(std::size_t count);
+    std::size_t size() const { return m_count; }
+
+    // 参数设置
+    void set_params(std::size_t i, const motor_params_t& params);
+    void set_params_all(const motor_params_t& params);
+    motor_params_t get_params(std::size_t i) const;
+
+    // 输入设置
+    void set_voltage(std::size_t i, double ud, double uq);
+    void set_load_torque(std::size_t i, double tl);
+
+    // 推进全部电机一步
+    void step(double dt);
+
+    // 获取单台电机状态（从SoA收集为AoS）
+    motor_state_t get_state(std::size_t i) const;
+
+    // SoA状态直接访问（批量控制器可直接写ud/uq/tl数组）
+    const pmsm_batch_state_t& state() const { return m_state; }
+    pmsm_batch_state_t& state() { return m_state; }
+
+    // 复位全部电机状态
+    void reset();
+
+    // 当前编译启用的SIMD内核名称
+    static const char* simd_name();
+
+    // SIMD宽度（数组按此宽度补齐）
+    static std::size_t simd_width();
+
+private:
+    // 补齐后的数组长度
+    std::size_t padded() const { return m_state.id.size(); }
+
+    // 预计算参数（避免内核中的除法）
+    struct batch_params_t {
+        batch_array_t rs, ld, lq, psi_f, b;
+        batch_array_t inv_ld, inv_lq, inv_j;
+        batch_array_t pole_pairs, inv_pole_pairs;
+        batch_array_t torque_k;         // 1.5 * pole_pairs
+    };
+
+    void write_params(std::size_t i, const motor_params_t& params);
+
+    // 全部状态数组（resize/reset统一处理）
+    std::vector<batch_array_t*> state_arrays();
+
+    std::size_t m_count = 0;
+    pmsm_batch_state_t m_state;
+    batch_params_t m_params;
+    std::vector<motor_params_t> m_raw_params;
+};
+
+#endif // CORE_PMSM_BATCH_MODEL_H
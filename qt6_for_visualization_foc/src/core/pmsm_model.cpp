@@ -4,10 +4,13 @@
  * 
  * 基于dq旋转坐标系建立PMSM电压方程和运动方程：
  * - 电压方程采用磁链解耦模型
- * - 使用欧拉法进行数值积分
+ * - 数值积分可选欧拉法、RK4、自适应RK45（Dormand–Prince），
+ *   或电流方程ZOH精确离散（步长可取到PWM周期量级仍保持稳定）
  * - 支持凸极(Ld≠Lq)和表贴式(Ld≈Lq)电机
  */
 #include "pmsm_model.h"
+#include "fast_trig.h"
+#include <algorithm>
 #include <cmath>
 
 pmsm_model::pmsm_model() {
@@ -16,15 +19,7 @@ pmsm_model::pmsm_model() {
 
 void pmsm_model::set_params(const motor_params_t& params) {
     m_params = params;
-}
-
-void pmsm_model::set_voltage(double ud, double uq) {
-    m_state.ud = ud;
-    m_state.uq = uq;
-}
-
-void pmsm_model::set_load_torque(double tl) {
-    m_state.tl = tl;
+    m_zoh.valid = false;
 }
 
 // PMSM dq轴电压方程:
@@ -36,6 +31,21 @@ void pmsm_model::set_load_torque(double tl) {
 // omega_e = p * omega_m
 // dtheta_e/dt = omega_e
 void pmsm_model::step(double dt) {
+    switch (m_integrator.method) {
+        case e_integrator::RK4:
+        case e_integrator::RK45:
+            step_ode(dt);
+            break;
+        case e_integrator::ZOH:
+            step_zoh(dt);
+            break;
+        default:
+            step_euler(dt);
+            break;
+    }
+}
+
+void pmsm_model::step_euler(double dt) {
     // 电流微分方程（欧拉法求解）
     // did/dt = (ud - rs*id + omega_e*lq*iq) / ld
     // diq/dt = (uq - rs*iq - omega_e*(ld*id + psi_f)) / lq
@@ -67,6 +77,182 @@ void pmsm_model::step(double dt) {
     // 计算αβ电流和三相电流
     calc_alpha_beta_currents();
     calc_abc_currents();
+    ++m_stats.accepted;
+    ++m_stats.rhs_evals;
+}
+
+// 高阶积分：一次step内ud/uq/tl保持不变，四个状态量联立积分
+void pmsm_model::step_ode(double dt) {
+    ode_state_t x = { m_state.id, m_state.iq, m_state.omega_m, m_state.theta_e };
+    auto f = [this](const ode_state_t& s) { return derivative(s); };
+    if (m_integrator.method == e_integrator::RK4) {
+        ode_solver::rk4(x, dt, m_integrator, m_stats, f);
+    } else {
+        if (!ode_solver::rk45(x, dt, m_rk45_h, m_integrator, m_stats, f)) {
+            ++m_stats.failed;
+        }
+    }
+
+    m_state.id = x[0];
+    m_state.iq = x[1];
+    m_state.omega_m = x[2];
+    m_state.theta_e = x[3];
+    calc_torque();
+    m_state.omega_e = m_params.pole_pairs * m_state.omega_m;
+
+    // 角度归一化到[0, 2π)
+    m_state.theta_e = std::fmod(m_state.theta_e, TWO_PI);
+    if (m_state.theta_e < 0) m_state.theta_e += TWO_PI;
+    m_state.theta_m = m_state.theta_e / m_params.pole_pairs;
+
+    calc_alpha_beta_currents();
+    calc_abc_currents();
+}
+
+// 4×4矩阵指数（缩放-平方 + 12阶泰勒），仅用于ZOH离散
+using mat4_t = double[4][4];
+
+static void mat4_mul(const mat4_t a, const mat4_t b, mat4_t out) {
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            double sum = 0.0;
+            for (int k = 0; k < 4; ++k) sum += a[i][k] * b[k][j];
+            out[i][j] = sum;
+        }
+    }
+}
+
+static void mat4_expm(const mat4_t m, mat4_t out) {
+    // 缩放到无穷范数 ≤ 0.5，泰勒截断误差远小于double精度
+    double norm = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        double row = 0.0;
+        for (int j = 0; j < 4; ++j) row += std::abs(m[i][j]);
+        norm = std::max(norm, row);
+    }
+    int squarings = 0;
+    double scale = 1.0;
+    while (norm * scale > 0.5 && squarings < 64) {
+        scale *= 0.5;
+        ++squarings;
+    }
+
+    mat4_t a, term, tmp;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            a[i][j] = m[i][j] * scale;
+            term[i][j] = (i == j) ? 1.0 : 0.0;
+            out[i][j] = term[i][j];
+        }
+    }
+    for (int k = 1; k <= 12; ++k) {
+        mat4_mul(term, a, tmp);
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                term[i][j] = tmp[i][j] / k;
+                out[i][j] += term[i][j];
+            }
+        }
+    }
+    for (int s = 0; s < squarings; ++s) {
+        mat4_mul(out, out, tmp);
+        std::copy(&tmp[0][0], &tmp[0][0] + 16, &out[0][0]);
+    }
+}
+
+// 电流方程在一个步长内视omega_e为常数即为线性定常系统：
+//   di/dt = A·i + B·v,  A = [-rs/ld, omega_e·lq/ld; -omega_e·ld/lq, -rs/lq],  B = diag(1/ld, 1/lq)
+//   v = [ud, uq - omega_e·psi_f]（反电动势并入输入，取步首实际转速）
+// 增广矩阵 M = [A B; 0 0]·dt 的指数 e^M = [phi gamma; 0 I]，一次求得 phi = e^(A·dt) 与 gamma = ∫e^(A·s)ds·B
+void pmsm_model::update_zoh(double omega_e, double dt) {
+    const double ld = m_params.ld;
+    const double lq = m_params.lq;
+    mat4_t m = {};
+    m[0][0] = -m_params.rs / ld * dt;
+    m[0][1] = omega_e * lq / ld * dt;
+    m[1][0] = -omega_e * ld / lq * dt;
+    m[1][1] = -m_params.rs / lq * dt;
+    m[0][2] = dt / ld;
+    m[1][3] = dt / lq;
+
+    mat4_t e;
+    mat4_expm(m, e);
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            m_zoh.phi[i][j] = e[i][j];
+            m_zoh.gamma[i][j] = e[i][j + 2];
+        }
+    }
+    m_zoh.omega_e = omega_e;
+    m_zoh.dt = dt;
+    m_zoh.valid = true;
+    ++m_stats.discretizations;
+}
+
+// ZOH单步：电流按精确离散更新（任意步长下无数值不稳定）
+// 电流方程使用的转速取步内中点的预估值（由步首转矩外推），机械方程取步首/步末电磁转矩平均
+// 并精确积分阻尼项，电角度按梯形积分，机电耦合整体为二阶精度
+void pmsm_model::step_zoh(double dt) {
+    const double omega_m0 = m_state.omega_m;
+    const double te0 = 1.5 * m_params.pole_pairs
+                       * (m_params.psi_f * m_state.iq + (m_params.ld - m_params.lq) * m_state.id * m_state.iq);
+    const double omega_mid = m_params.pole_pairs
+                             * (omega_m0 + 0.5 * dt * (te0 - m_state.tl - m_params.b * omega_m0) / m_params.j);
+
+    // 离散矩阵所用转速按容差量化：矩阵只取决于当前转速本身而与历史无关（检查点恢复后结果逐位一致），
+    // 转速在同一量化格内变化时沿用缓存
+    const double tol = m_integrator.zoh_omega_tol;
+    const double omega_grid = (tol > 0.0) ? std::round(omega_mid / tol) * tol : omega_mid;
+    if (!m_zoh.valid || m_zoh.dt != dt || m_zoh.omega_e != omega_grid) {
+        update_zoh(omega_grid, dt);
+    }
+
+    // 反电动势用未量化的中点转速；量化造成的dq交叉耦合残差按步首电流折算为保持输入
+    const double id0 = m_state.id;
+    const double iq0 = m_state.iq;
+    const double d_omega = omega_mid - omega_grid;
+    const double vd = m_state.ud + d_omega * m_params.lq * iq0;
+    const double vq = m_state.uq - omega_mid * m_params.psi_f - d_omega * m_params.ld * id0;
+    m_state.id = m_zoh.phi[0][0] * id0 + m_zoh.phi[0][1] * iq0 + m_zoh.gamma[0][0] * vd + m_zoh.gamma[0][1] * vq;
+    m_state.iq = m_zoh.phi[1][0] * id0 + m_zoh.phi[1][1] * iq0 + m_zoh.gamma[1][0] * vd + m_zoh.gamma[1][1] * vq;
+    calc_torque();
+
+    // J·domega_m/dt = te - tl - b·omega_m，te取步内平均
+    const double omega_e0 = m_state.omega_e;
+    const double te_avg = 0.5 * (te0 + m_state.te);
+    if (m_params.b > 0.0) {
+        const double decay = std::exp(-m_params.b / m_params.j * dt);
+        const double omega_inf = (te_avg - m_state.tl) / m_params.b;
+        m_state.omega_m = omega_inf + (omega_m0 - omega_inf) * decay;
+    } else {
+        m_state.omega_m = omega_m0 + (te_avg - m_state.tl) / m_params.j * dt;
+    }
+    m_state.omega_e = m_params.pole_pairs * m_state.omega_m;
+    m_state.theta_e += 0.5 * (omega_e0 + m_state.omega_e) * dt;
+
+    // 角度归一化到[0, 2π)
+    m_state.theta_e = std::fmod(m_state.theta_e, TWO_PI);
+    if (m_state.theta_e < 0) m_state.theta_e += TWO_PI;
+    m_state.theta_m = m_state.theta_e / m_params.pole_pairs;
+
+    calc_alpha_beta_currents();
+    calc_abc_currents();
+    ++m_stats.accepted;
+}
+
+pmsm_model::ode_state_t pmsm_model::derivative(const ode_state_t& x) const {
+    const double id = x[0];
+    const double iq = x[1];
+    const double omega_m = x[2];
+    const double omega_e = m_params.pole_pairs * omega_m;
+    const double te = 1.5 * m_params.pole_pairs
+                      * (m_params.psi_f * iq + (m_params.ld - m_params.lq) * id * iq);
+    return {
+        (m_state.ud - m_params.rs * id + omega_e * m_params.lq * iq) / m_params.ld,
+        (m_state.uq - m_params.rs * iq - omega_e * (m_params.ld * id + m_params.psi_f)) / m_params.lq,
+        (te - m_state.tl - m_params.b * omega_m) / m_params.j,
+        omega_e
+    };
 }
 
 motor_state_t pmsm_model::get_state() const {
@@ -79,6 +265,29 @@ motor_params_t pmsm_model::get_params() const {
 
 void pmsm_model::reset() {
     m_state = motor_state_t{};
+    m_stats = integrator_stats_t{};
+    m_rk45_h = 0.0;
+    m_rotation = rotation_t{};
+}
+
+void pmsm_model::restore_state(const motor_checkpoint_t& cp) {
+    m_state = cp.state;
+    m_rotation = cp.rotation;
+    m_rk45_h = cp.rk45_h;
+}
+
+void pmsm_model::set_integrator(const integrator_config_t& cfg) {
+    m_integrator = cfg;
+    m_rk45_h = 0.0;
+    m_zoh.valid = false;
+}
+
+integrator_config_t pmsm_model::get_integrator() const {
+    return m_integrator;
+}
+
+integrator_stats_t pmsm_model::get_integrator_stats() const {
+    return m_stats;
 }
 
 // 电磁转矩: te = 1.5*pole_pairs*(psi_f*iq + (ld-lq)*id*iq)
@@ -90,8 +299,9 @@ void pmsm_model::calc_torque() {
 
 // 逆Park变换: dq -> αβ
 void pmsm_model::calc_alpha_beta_currents() {
-    double cos_t = std::cos(m_state.theta_e);
-    double sin_t = std::sin(m_state.theta_e);
+    m_rotation = make_rotation(m_state.theta_e, m_trig_mode);
+    const double cos_t = m_rotation.cos_t;
+    const double sin_t = m_rotation.sin_t;
     m_state.i_alpha = m_state.id * cos_t - m_state.iq * sin_t;
     m_state.i_beta  = m_state.id * sin_t + m_state.iq * cos_t;
 
@@ -3,24 +3,53 @@
 
 #include "types.h"
 #include "i_motor_model.h"
+#include "ode_solver.h"
 
 // PMSM永磁同步电机数学模型
 // 基于dq轴旋转坐标系建模
-class pmsm_model : public i_motor_model {
+class pmsm_model final : public i_motor_model {
 public:
     pmsm_model();
     ~pmsm_model() override = default;
 
     // i_motor_model接口实现
     void set_params(const motor_params_t& params) override;
-    void set_voltage(double ud, double uq) override;
-    void set_load_torque(double TL) override;
+    void set_voltage(double ud, double uq) override { m_state.ud = ud; m_state.uq = uq; }
+    void set_load_torque(double tl) override { m_state.tl = tl; }
     void step(double dt) override;
     motor_state_t get_state() const override;
     motor_params_t get_params() const override;
     void reset() override;
+    void set_integrator(const integrator_config_t& cfg) override;
+    integrator_config_t get_integrator() const override;
+    integrator_stats_t get_integrator_stats() const override;
+    void set_trig_mode(e_trig_mode mode) override { m_trig_mode = mode; }
+    rotation_t get_rotation() const override { return m_rotation; }
+    motor_checkpoint_t save_state() const override { return {m_state, m_rotation, m_rk45_h}; }
+    void restore_state(const motor_checkpoint_t& cp) override;
+
+    // 按引用读取状态（按具体类型调用时避免motor_state_t整体拷贝，sim_pipeline使用）
+    const motor_state_t& state() const { return m_state; }
 
 private:
+    // 状态向量 [id, iq, omega_m, theta_e]
+    using ode_state_t = ode_vec_t<4>;
+
+    // 欧拉法单步（原模型实现）
+    void step_euler(double dt);
+
+    // RK4/RK45单步
+    void step_ode(double dt);
+
+    // ZOH精确离散单步
+    void step_zoh(double dt);
+
+    // 按给定电角速度与步长重新计算ZOH离散矩阵
+    void update_zoh(double omega_e, double dt);
+
+    // 状态方程右端（电压、负载取当前值）
+    ode_state_t derivative(const ode_state_t& x) const;
+
     // 计算电磁转矩
     void calc_torque();
 
@@ -32,6 +61,24 @@ private:
 
     motor_params_t m_params;
     motor_state_t m_state;
+
+    integrator_config_t m_integrator;
+    integrator_stats_t m_stats;
+    double m_rk45_h = 0.0;      // RK45建议子步长（跨step保留）
+
+    // dq电流方程ZOH离散：i[k+1] = phi·i[k] + gamma·[ud, uq - omega_e·psi_f]
+    // 系统矩阵只与omega_e、参数和步长有关，按量化后的omega_e缓存
+    struct zoh_cache_t {
+        double phi[2][2] = {};
+        double gamma[2][2] = {};
+        double omega_e = 0.0;
+        double dt = 0.0;
+        bool valid = false;
+    };
+    zoh_cache_t m_zoh;
+
+    e_trig_mode m_trig_mode = e_trig_mode::EXACT;
+    rotation_t m_rotation;      // 当前电角度的旋转因子
 };
 
 #endif // CORE_PMSM_MODEL_H
@@ -0,0 +1,92 @@
+#ifndef CORE_RING_BUFFER_H
+#define CORE_RING_BUFFER_H
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// 定长环形队列（单线程使用，跨线程传递数据请用data_buffer）
+// - 容量在reset时一次性分配，push/pop不再分配内存
+// - 镜像存储：每个元素同时写入下标i与i+capacity，
+//   任意时刻队列内容在内存中都是一段连续区间，data()可直接按数组遍历
+// - 队列满时push_back覆盖最旧元素
+template<typename T>
+class ring_buffer {
+public:
+    explicit ring_buffer(size_t capacity = 0) { reset(capacity); }
+
+    // 重新分配容量并清空
+    void reset(size_t capacity) {
+        m_capacity = capacity;
+        m_storage.assign(capacity * 2, T());
+        m_head = 0;
+        m_size = 0;
+    }
+
+    // 尾部追加，满时丢弃队首
+    void push_back(const T& value) {
+        if (m_capacity == 0) return;
+        size_t pos = m_head + m_size;
+        if (pos >= m_capacity) pos -= m_capacity;
+        m_storage[pos] = value;
+        m_storage[pos + m_capacity] = value;
+        if (m_size < m_capacity) {
+            ++m_size;
+        } else if (++m_head == m_capacity) {
+            m_head = 0;
+        }
+    }
+
+    // 批量追加count个元素（超出容量时仅保留最后capacity个）
+    void append(const T* values, size_t count) {
+        if (count > m_capacity) {
+            values += count - m_capacity;
+            count = m_capacity;
+        }
+        for (size_t i = 0; i < count; ++i) push_back(values[i]);
+    }
+
+    void pop_front(size_t count = 1) {
+        assert(count <= m_size);
+        m_head += count;
+        if (m_head >= m_capacity) m_head -= m_capacity;
+        m_size -= count;
+    }
+
+    void pop_back() {
+        assert(m_size > 0);
+        --m_size;
+    }
+
+    // 最后一个元素的可写引用（镜像两份需同步，修改后调用commit_back）
+    T& back() { return m_storage[m_head + m_size - 1]; }
+    const T& back() const { return m_storage[m_head + m_size - 1]; }
+    void commit_back() {
+        size_t pos = m_head + m_size - 1;
+        if (pos >= m_capacity) {
+            m_storage[pos - m_capacity] = m_storage[pos];
+        } else {
+            m_storage[pos + m_capacity] = m_storage[pos];
+        }
+    }
+
+    const T& front() const { return m_storage[m_head]; }
+    const T& operator[](size_t i) const { return m_storage[m_head + i]; }
+
+    // 连续区间首地址，有效长度为size()
+    const T* data() const { return m_storage.data() + m_head; }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+    bool full() const { return m_size == m_capacity; }
+    void clear() { m_head = 0; m_size = 0; }
+
+private:
+    std::vector<T> m_storage;   // 2 * capacity，后半为前半的镜像
+    size_t m_capacity = 0;
+    size_t m_head = 0;          // 队首下标，始终 < capacity
+    size_t m_size = 0;
+};
+
+#endif // CORE_RING_BUFFER_H
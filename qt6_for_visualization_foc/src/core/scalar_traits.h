@@ -0,0 +1,56 @@
+#ifndef CORE_SCALAR_TRAITS_H
+#define CORE_SCALAR_TRAITS_H
+
+#include "fixed_point.h"
+#include <type_traits>
+
+// 控制通路标量类型特性
+// 控制通路（basic_transform / basic_svpwm / basic_pid / basic_loop_controller）以标量类型为模板参数：
+// - double：参考实现，与界面程序的运行期类逐位一致
+// - float：单精度，物理单位
+// - q31_t / q15_t：定点，与驱动器固件一致，信号按per_unit_base_t标幺化到[-1, 1)
+// 各特性：
+// - PER_UNIT：信号是否需要标幺化
+// - wide_t：求和用的扩展类型（定点为同小数位的加宽整数部分，可表示1.0及以上）
+// - accum_t：积分器累加类型（Q15使用Q31累加，与固件的32位积分器一致）
+// - gain_t：系数类型（定点为尾数+移位，可表示大于1的增益）
+template<typename T>
+struct scalar_traits {
+    static_assert(std::is_floating_point_v<T>, "未支持的标量类型");
+    static constexpr bool PER_UNIT = false;
+    using wide_t = T;
+    using accum_t = T;
+    using gain_t = T;
+
+    static constexpr T from_double(double v) { return static_cast<T>(v); }
+    static constexpr double to_double(T v) { return static_cast<double>(v); }
+    static constexpr gain_t gain(double g) { return static_cast<T>(g); }
+    static constexpr wide_t widen(T v) { return v; }
+    static constexpr T narrow(wide_t v) { return v; }
+};
+
+template<int FRAC, typename RAW, typename WIDE>
+struct scalar_traits<fixed_point<FRAC, RAW, WIDE>> {
+    using value_t = fixed_point<FRAC, RAW, WIDE>;
+    static constexpr bool PER_UNIT = true;
+    using wide_t = fixed_point<FRAC, WIDE, WIDE>;
+    using accum_t = q31_t;
+    using gain_t = fixed_gain<value_t>;
+
+    static constexpr value_t from_double(double v) { return value_t::from_double(v); }
+    static constexpr double to_double(value_t v) { return v.to_double(); }
+    static constexpr gain_t gain(double g) { return gain_t::from_double(g); }
+    static constexpr wide_t widen(value_t v) { return fixed_cast<wide_t>(v); }
+    static constexpr value_t narrow(wide_t v) { return fixed_cast<value_t>(v); }
+};
+
+// 标幺化基值（PER_UNIT类型使用；物理量 = 标幺值 × 基值）
+// 浮点类型取全1，即直接使用物理单位
+struct per_unit_base_t {
+    double current  = 1.0;      // 电流基值 (A)
+    double voltage  = 1.0;      // 电压基值 (V)
+    double speed    = 1.0;      // 机械角速度基值 (rad/s)
+    double angle    = 1.0;      // 电角度基值 (rad)
+};
+
+#endif // CORE_SCALAR_TRAITS_H
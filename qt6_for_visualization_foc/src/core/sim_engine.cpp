@@ -1,8 +1,11 @@
 #include "sim_engine.h"
-#include "control/loop_controller.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 
 sim_engine::sim_engine(QObject* parent) : QObject(parent) {
+    m_samples = std::make_unique<data_buffer<sim_sample_t>>(SAMPLE_BUFFER_SIZE);
+    m_checkpoints.reset(static_cast<size_t>(std::max(0, m_config.checkpoint_count)));
     m_timer = new QTimer(this);
     connect(m_timer, &QTimer::timeout, this, &sim_engine::run_loop);
 }
@@ -12,80 +15,366 @@ sim_engine::~sim_engine() {
 }
 
 void sim_engine::set_config(const sim_config_t& cfg) {
+    {
+        auto guard = lock_state();
+        apply_config(cfg);
+        if (required_sample_capacity(m_config) <= m_samples->capacity()) return;
+    }
+    // 步长变小或倍速变大后采样缓冲容纳不下一帧的步数：扩容
+    // 缓冲只能在停止状态下替换，运行中先暂停再恢复（与set_threaded相同）
+    bool was_running = m_config.running;
+    if (was_running) pause();
+    set_sample_capacity(required_sample_capacity(m_config));
+    if (was_running) start();
+}
+
+size_t sim_engine::required_sample_capacity(const sim_config_t& cfg) {
+    if (!(cfg.dt > 0.0) || !(cfg.speed_ratio > 0.0)) return 0;
+    double steps = std::ceil(SAMPLE_BUFFER_SECONDS * cfg.speed_ratio / cfg.dt);
+    return static_cast<size_t>(std::min(steps, static_cast<double>(SAMPLE_BUFFER_MAX)));
+}
+
+// 应用配置（调用方需持有m_mutex）
+void sim_engine::apply_config(const sim_config_t& cfg) {
+    // 运行状态由start/pause管理，不随配置覆盖
+    bool running = m_config.running;
+    if (cfg.checkpoint_count != m_config.checkpoint_count) {
+        m_checkpoints.reset(static_cast<size_t>(std::max(0, cfg.checkpoint_count)));
+    }
     m_config = cfg;
-    // 根据仿真步长和速度倍率计算定时器间隔
-    // UI刷新频率约60Hz，每次定时器触发执行多步仿真
+    m_config.running = running;
+    if (m_motor) {
+        m_motor->set_integrator(m_config.integrator);
+        m_motor->set_trig_mode(m_config.trig_mode);
+    }
+    m_inverter.set_config(m_config.inverter);
+    m_inverter.set_udc(m_udc);
+    // 单线程模式的推进定时器约60Hz，每次触发执行多步仿真（线程模式不使用）
     int interval_ms = 16;  // ~60Hz
     m_timer->setInterval(interval_ms);
 }
 
+sim_config_t sim_engine::get_config() const {
+    auto guard = lock_state();
+    return m_config;
+}
+
+// 切换线程模式：运行中切换时先暂停再以新模式重新启动
+void sim_engine::set_threaded(bool en) {
+    if (m_threaded == en) return;
+    bool was_running = m_config.running;
+    if (was_running) pause();
+    m_threaded = en;
+    if (was_running) start();
+}
+
+void sim_engine::set_sample_capacity(size_t capacity) {
+    auto guard = lock_state();
+    m_samples = std::make_unique<data_buffer<sim_sample_t>>(capacity);
+}
+
 void sim_engine::set_motor_model(std::unique_ptr<i_motor_model> model) {
+    auto guard = lock_state();
     m_motor = std::move(model);
+    // 旧模型的检查点不能恢复到新模型
+    m_checkpoints.clear();
+    if (m_motor) {
+        m_motor->set_integrator(m_config.integrator);
+        m_motor->set_trig_mode(m_config.trig_mode);
+    }
+}
+
+svpwm_output_t sim_engine::get_svpwm_output() const {
+    auto guard = lock_state();
+    return m_snapshot.svpwm;
+}
+
+hall_state_t sim_engine::get_hall_state() const {
+    auto guard = lock_state();
+    return m_snapshot.hall;
+}
+
+sim_snapshot_t sim_engine::get_snapshot() const {
+    auto guard = lock_state();
+    return m_snapshot;
+}
+
+integrator_stats_t sim_engine::get_integrator_stats() const {
+    auto guard = lock_state();
+    return m_motor ? m_motor->get_integrator_stats() : integrator_stats_t{};
+}
+
+void sim_engine::set_load_torque(double tl) {
+    auto guard = lock_state();
+    m_load_torque = tl;
 }
 
 void sim_engine::start() {
     if (!m_motor) return;
     m_config.running = true;
-    m_timer->start();
+    // 线程模式由工作线程推进，UI经frame_scheduler轮询get_snapshot()，不需要定时器
+    if (m_threaded) {
+        start_worker();
+    } else {
+        m_timer->start();
+    }
 }
 
 void sim_engine::stop() {
+    stop_worker();
     m_config.running = false;
     m_timer->stop();
 }
 
 void sim_engine::pause() {
+    stop_worker();
     m_config.running = false;
     m_timer->stop();
 }
 
 void sim_engine::step() {
     if (!m_motor) return;
-    m_config.single_step = true;
-    execute_one_step();
-    m_config.single_step = false;
+    {
+        auto guard = lock_state();
+        m_config.single_step = true;
+        execute_one_step();
+        m_config.single_step = false;
+        publish_snapshot();
+    }
+
+    // 单步模式：显示SVPWM步骤（矢量调制是FOC的核心可视化步骤）
+    emit foc_step_changed(e_foc_step::SVPWM);
+    emit step_completed(m_step_index, QString("Step %1").arg(m_step_index));
+}
+
+void sim_engine::step_back() {
+    if (!m_motor) return;
+    int target;
+    {
+        auto guard = lock_state();
+        target = m_step_index - 1;
+    }
+    if (target < 0 || !seek_step(target)) return;
+    emit step_completed(target, QString("Step %1").arg(target));
+}
+
+bool sim_engine::seek_step(int step_index) {
+    if (!m_motor || step_index < 0) return false;
+    {
+        auto guard = lock_state();
+        if (step_index < m_step_index) {
+            // 最后一个 step_index <= 目标 的检查点（检查点在连续存储中按步数递增）
+            const sim_checkpoint_t* first = m_checkpoints.data();
+            const sim_checkpoint_t* last = first + m_checkpoints.size();
+            const sim_checkpoint_t* it = std::upper_bound(first, last, step_index,
+                [](int step, const sim_checkpoint_t& cp) { return step < cp.step_index; });
+            if (it == first) return false;
+            const sim_checkpoint_t cp = *(it - 1);
+            // 丢弃更晚的检查点：恢复后用户可能修改参数，之后的轨迹不再成立
+            while (m_checkpoints.size() > static_cast<size_t>(it - first)) {
+                m_checkpoints.pop_back();
+            }
+            restore_checkpoint(cp);
+            m_record_samples = false;
+        }
+        while (m_step_index < step_index) {
+            execute_one_step();
+        }
+        m_record_samples = true;
+        publish_snapshot();
+    }
+    return true;
+}
+
+size_t sim_engine::checkpoint_count() const {
+    auto guard = lock_state();
+    return m_checkpoints.size();
+}
+
+int sim_engine::earliest_step() const {
+    auto guard = lock_state();
+    return m_checkpoints.size() > 0 ? m_checkpoints.front().step_index : m_step_index;
+}
+
+// 保存当前步执行前的状态（调用方需持有m_mutex）
+void sim_engine::save_checkpoint() {
+    sim_checkpoint_t cp;
+    cp.step_index = m_step_index;
+    cp.sim_time = m_sim_time;
+    cp.motor = m_motor->save_state();
+    if (m_loop_ctrl) cp.loop = m_loop_ctrl->save_state();
+    if (m_six_step_ctrl) cp.six_step = m_six_step_ctrl->save_state();
+    cp.svpwm = m_svpwm_out;
+    cp.u_alpha_cmd = m_u_alpha_cmd;
+    cp.u_beta_cmd = m_u_beta_cmd;
+    cp.hall = m_hall_state;
+    cp.inverter = m_inverter.save_state();
+    m_checkpoints.push_back(cp);
+}
+
+// 恢复检查点（调用方需持有m_mutex）
+void sim_engine::restore_checkpoint(const sim_checkpoint_t& cp) {
+    m_step_index = cp.step_index;
+    m_sim_time = cp.sim_time;
+    m_motor->restore_state(cp.motor);
+    if (m_loop_ctrl) m_loop_ctrl->restore_state(cp.loop);
+    if (m_six_step_ctrl) m_six_step_ctrl->restore_state(cp.six_step);
+    m_svpwm_out = cp.svpwm;
+    m_u_alpha_cmd = cp.u_alpha_cmd;
+    m_u_beta_cmd = cp.u_beta_cmd;
+    m_hall_state = cp.hall;
+    m_inverter.restore_state(cp.inverter);
 }
 
 void sim_engine::reset() {
     stop();
-    if (m_motor) {
-        m_motor->reset();
-    }
-    if (m_six_step_ctrl) {
-        m_six_step_ctrl->reset();
+    {
+        auto guard = lock_state();
+        if (m_motor) {
+            m_motor->reset();
+        }
+        if (m_six_step_ctrl) {
+            m_six_step_ctrl->reset();
+        }
+        m_step_index = 0;
+        m_sim_time = 0.0;
+        m_svpwm_out = svpwm_output_t{};
+        m_u_alpha_cmd = 0.0;
+        m_u_beta_cmd = 0.0;
+        m_hall_state = hall_state_t{};
+        m_inverter.reset();
+        m_samples->clear();
+        m_checkpoints.clear();
+        publish_snapshot();
     }
-    m_step_index = 0;
-    m_svpwm_out = svpwm_output_t{};
-    m_hall_state = hall_state_t{};
-    emit state_updated(m_motor ? m_motor->get_state() : motor_state_t{});
 }
 
+// 单线程模式的仿真推进（线程模式下定时器不启动）
 void sim_engine::run_loop() {
-    if (!m_config.running || !m_motor) return;
+    if (!m_config.running || !m_motor || m_threaded) return;
 
     // 每帧执行多步仿真以达到实时效果
     // 16ms内执行 16ms / dt * speed_ratio 步
     int steps_per_frame = static_cast<int>(0.016 / m_config.dt * m_config.speed_ratio);
     steps_per_frame = std::max(1, std::min(steps_per_frame, 10000));
-    
-    // 每帧发射多次状态更新以避免波形欠采样
-    // 目标: 每帧至少8个采样点，确保波形平滑
-    int emit_interval = std::max(1, steps_per_frame / 8);
 
-    for (int i = 0; i < steps_per_frame && m_config.running; ++i) {
+    // 波形数据逐步写入采样缓冲，面板由frame_scheduler每帧读取最新快照
+    auto guard = lock_state();
+    for (int i = 0; i < steps_per_frame; ++i) {
         execute_one_step();
-        // 每隔emit_interval步发射一次波形数据
-        if ((i + 1) % emit_interval == 0) {
-            emit state_updated(m_motor->get_state());
+    }
+    publish_snapshot();
+}
+
+void sim_engine::run_steps(int count) {
+    if (!m_motor) return;
+    auto guard = lock_state();
+    for (int i = 0; i < count; ++i) {
+        execute_one_step();
+    }
+    publish_snapshot();
+}
+
+void sim_engine::start_worker() {
+    if (m_worker.joinable()) return;
+    m_worker_running.store(true, std::memory_order_release);
+    m_worker = std::thread(&sim_engine::worker_loop, this);
+}
+
+void sim_engine::stop_worker() {
+    m_worker_running.store(false, std::memory_order_release);
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+// 仿真线程主循环
+// 以墙钟时间为基准累计待仿真时间（sim_debt += wall_dt * speed_ratio），
+// 每个节拍按步长消化积压，节拍按绝对截止时间休眠，因此UI绘制变慢、
+// 线程调度抖动都不会让仿真时间产生累计漂移
+void sim_engine::worker_loop() {
+    using clock = std::chrono::steady_clock;
+    // 仿真线程节拍
+    constexpr auto TICK = std::chrono::milliseconds(1);
+    // 最大允许积压（墙钟秒）：CPU跟不上倍率时丢弃超出部分，避免追赶螺旋
+    constexpr double MAX_LAG = 0.05;
+    // 每次持锁最多执行的步数，保证UI线程读取快照的等待时间有界
+    constexpr int STEPS_PER_LOCK = 256;
+
+    auto last = clock::now();
+    auto deadline = last + TICK;
+    double sim_debt = 0.0;  // 待执行的仿真时间 (s)
+
+    while (m_worker_running.load(std::memory_order_acquire)) {
+        auto now = clock::now();
+        double wall_dt = std::chrono::duration<double>(now - last).count();
+        last = now;
+
+        bool pending = true;
+        {
+            auto guard = lock_state();
+            sim_debt += wall_dt * m_config.speed_ratio;
+            sim_debt = std::min(sim_debt, MAX_LAG * m_config.speed_ratio);
         }
+        while (pending && m_worker_running.load(std::memory_order_relaxed)) {
+            auto guard = lock_state();
+            if (!m_motor) break;
+            for (int k = 0; k < STEPS_PER_LOCK && sim_debt >= m_config.dt; ++k) {
+                execute_one_step();
+                sim_debt -= m_config.dt;
+            }
+            pending = sim_debt >= m_config.dt;
+            publish_snapshot();
+        }
+
+        std::this_thread::sleep_until(deadline);
+        deadline += TICK;
+        // 过载时重新对齐节拍，积压由sim_debt补偿
+        now = clock::now();
+        if (deadline < now) deadline = now + TICK;
     }
 }
 
+// 发布快照（调用方需持有m_mutex）
+void sim_engine::publish_snapshot() {
+    if (m_motor) {
+        m_snapshot.state = m_motor->get_state();
+    } else {
+        m_snapshot.state = motor_state_t{};
+    }
+    m_snapshot.svpwm = m_svpwm_out;
+    // 电压矢量幅值/角度仅用于显示，每次发布计算一次
+    m_snapshot.svpwm.mag = std::sqrt(m_u_alpha_cmd * m_u_alpha_cmd + m_u_beta_cmd * m_u_beta_cmd);
+    m_snapshot.svpwm.angle = std::atan2(m_u_beta_cmd, m_u_alpha_cmd);
+    if (m_snapshot.svpwm.angle < 0) m_snapshot.svpwm.angle += TWO_PI;
+    m_snapshot.hall = m_hall_state;
+    fill_ref(m_snapshot.ref);
+    m_snapshot.step_index = m_step_index;
+    m_snapshot.sim_time = m_sim_time;
+}
+
+// 读取控制器内部参考值（调用方需持有m_mutex）
+void sim_engine::fill_ref(control_target_t& ref) const {
+    if (!m_loop_ctrl) return;
+    ref.id_ref = m_loop_ctrl->get_id_ref();
+    ref.iq_ref = m_loop_ctrl->get_iq_ref();
+    ref.vel_ref = m_loop_ctrl->get_vel_ref();
+    ref.pos_ref = m_loop_ctrl->get_target().pos_ref;
+}
+
+// 执行一步仿真（调用方需持有m_mutex）
 void sim_engine::execute_one_step() {
     if (!m_motor) return;
     
     bool detailed = m_config.single_step;  // 单步模式发送详细步骤
 
+    // 按间隔保存检查点（checkpoint_count为0时不保存；恢复后重新仿真时已有的检查点不重复保存）
+    const int cp_interval = m_config.checkpoint_interval;
+    if (cp_interval > 0 && m_checkpoints.capacity() > 0 && m_step_index % cp_interval == 0 &&
+        (m_checkpoints.size() == 0 || m_checkpoints.back().step_index < m_step_index)) {
+        save_checkpoint();
+    }
+
     // 设置负载转矩
     m_motor->set_load_torque(m_load_torque);
     
@@ -99,49 +388,78 @@ void sim_engine::execute_one_step() {
         execute_foc_step(state, detailed);
     }
 
-    // 步骤7: 电机模型更新
-    m_motor->step(m_config.dt);
+    // 步骤7: 电机模型更新（开关模型按PWM开关边沿分段推进）
+    if (m_config.inverter.mode == e_inverter_mode::SWITCHING &&
+        m_control_mode == e_control_mode::FOC) {
+        m_inverter.advance(*m_motor, m_config.dt);
+    } else {
+        m_motor->step(m_config.dt);
+    }
 
     m_step_index++;
-
-    // 单步模式：显示SVPWM步骤（矢量调制是FOC的核心可视化步骤）
-    if (m_config.single_step) {
-        emit foc_step_changed(e_foc_step::SVPWM);
-        emit step_completed(m_step_index, QString("Step %1").arg(m_step_index));
-        emit state_updated(m_motor->get_state());
-    }
+    m_sim_time += m_config.dt;
+
+    // 写入采样缓冲（持锁执行，保证任一时刻只有一个生产者）
+    if (!m_record_samples) return;
+    sim_sample_t sample;
+    sample.t = m_sim_time;
+    sample.state = m_motor->get_state();
+    sample.svpwm = m_svpwm_out;
+    fill_ref(sample.ref);
+    m_samples->push(sample);
 }
 
 // FOC矢量控制执行
+// 多速率调度：各环按分频系数在仿真步上抽取执行，未执行的步保持上次输出
+// 电流环周期即PWM周期，电压与SVPWM占空比仅在电流环执行时更新
 void sim_engine::execute_foc_step(motor_state_t& state, bool /*detailed*/) {
-    // 控制环计算（包含Clark、Park变换）
+    const int current_div = std::max(1, m_config.loop_rates.current_div);
+    const int velocity_div = std::max(1, m_config.loop_rates.velocity_div);
+    const int position_div = std::max(1, m_config.loop_rates.position_div);
+    const bool pwm_update = (m_step_index % current_div) == 0;
+
+    // 控制环计算（外环先于内环，同一时刻内环使用外环最新输出）
     double ud = 0.0, uq = 0.0;
     if (m_loop_ctrl) {
-        control_target_t target = m_loop_ctrl->calc(state, m_config.dt);
+        if (m_step_index % position_div == 0) {
+            m_loop_ctrl->update_position(state, position_div * m_config.dt);
+        }
+        if (m_step_index % velocity_div == 0) {
+            m_loop_ctrl->update_velocity(state, velocity_div * m_config.dt);
+        }
+        if (!pwm_update) return;
+        m_loop_ctrl->update_current(state, current_div * m_config.dt);
+        control_target_t target = m_loop_ctrl->get_output();
         ud = target.id_ref;
         uq = target.iq_ref;
+    } else if (!pwm_update) {
+        return;
     }
 
     // 步骤5: 逆Park变换
     m_motor->set_voltage(ud, uq);
 
-    // 步骤6: SVPWM计算
-    state = m_motor->get_state();
+    // 步骤6: SVPWM计算（复用电机模型本步已求得的旋转因子）
+    const rotation_t rot = m_motor->get_rotation();
     double u_alpha, u_beta;
-    m_transform.inv_park(state.ud, state.uq, state.theta_e, u_alpha, u_beta);
+    m_transform.inv_park(ud, uq, rot, u_alpha, u_beta);
     m_svpwm.calc(u_alpha, u_beta, m_udc,
                  m_svpwm_out.ta, m_svpwm_out.tb, m_svpwm_out.tc);
     m_svpwm_out.sector = m_svpwm.get_sector();
-    m_svpwm.get_vector(m_svpwm_out.mag, m_svpwm_out.angle);
+    m_u_alpha_cmd = u_alpha;
+    m_u_beta_cmd = u_beta;
+    if (m_config.inverter.mode == e_inverter_mode::SWITCHING) {
+        m_inverter.start_period(m_svpwm_out.ta, m_svpwm_out.tb, m_svpwm_out.tc,
+                                current_div * m_config.dt);
+    }
 }
 
 // 六步换向控制执行
 void sim_engine::execute_six_step(motor_state_t& state, bool /*detailed*/) {
     if (!m_six_step_ctrl) return;
 
-    // 计算霍尔传感器状态
+    // 计算霍尔传感器状态（随快照发布，见publish_snapshot）
     calc_hall_state(state.theta_e);
-    emit hall_state_changed(m_hall_state);
 
     // 获取速度目标（从loop_controller获取，如果有的话）
     double vel_ref = 100.0;  // 默认速度目标
@@ -164,9 +482,9 @@ void sim_engine::execute_six_step(motor_state_t& state, bool /*detailed*/) {
     double u_alpha, u_beta;
     m_transform.clark(ua, ub, uc, u_alpha, u_beta);
 
-    // Park变换: αβ -> dq
+    // Park变换: αβ -> dq（复用电机模型的旋转因子）
     double ud, uq;
-    m_transform.park(u_alpha, u_beta, state.theta_e, ud, uq);
+    m_transform.park(u_alpha, u_beta, m_motor->get_rotation(), ud, uq);
 
     m_motor->set_voltage(ud, uq);
 
@@ -175,8 +493,8 @@ void sim_engine::execute_six_step(motor_state_t& state, bool /*detailed*/) {
     m_svpwm_out.tb = duty_b;
     m_svpwm_out.tc = duty_c;
     m_svpwm_out.sector = m_hall_state.sector;
-    m_svpwm_out.mag = std::sqrt(u_alpha * u_alpha + u_beta * u_beta);
-    m_svpwm_out.angle = std::atan2(u_beta, u_alpha);
+    m_u_alpha_cmd = u_alpha;
+    m_u_beta_cmd = u_beta;
 }
 
 // 霍尔传感器状态查表（扇区1-6对应的Ha,Hb,Hc状态和编码）
@@ -189,7 +507,7 @@ static constexpr struct { bool ha, hb, hc; int code; } HALL_TABLE[6] = {
     {false, false, true,  1},  // 扇区6 (300-360°)
 };
 
-void sim_engine::calc_hall_state(double theta_e) {
+hall_state_t sim_engine::hall_from_angle(double theta_e) {
     // 归一化角度到[0, 2π)并计算扇区索引(0-5)
     theta_e = std::fmod(theta_e, TWO_PI);
     if (theta_e < 0) theta_e += TWO_PI;
@@ -197,9 +515,15 @@ void sim_engine::calc_hall_state(double theta_e) {
     
     // 查表获取霍尔状态
     const auto& h = HALL_TABLE[idx];
-    m_hall_state.sector = idx + 1;
-    m_hall_state.ha = h.ha;
-    m_hall_state.hb = h.hb;
-    m_hall_state.hc = h.hc;
-    m_hall_state.hall_code = h.code;
+    hall_state_t hall;
+    hall.sector = idx + 1;
+    hall.ha = h.ha;
+    hall.hb = h.hb;
+    hall.hc = h.hc;
+    hall.hall_code = h.code;
+    return hall;
+}
+
+void sim_engine::calc_hall_state(double theta_e) {
+    m_hall_state = hall_from_angle(theta_e);
 }
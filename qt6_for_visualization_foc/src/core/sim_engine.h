@@ -5,14 +5,48 @@
 #include "i_motor_model.h"
 #include "transform.h"
 #include "svpwm.h"
+#include "inverter_model.h"
+#include "data_buffer.h"
+#include "ring_buffer.h"
+#include "control/loop_controller.h"
 #include "control/six_step_controller.h"
 #include <QObject>
 #include <QTimer>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <thread>
+
+// 仿真快照（线程模式下由仿真线程发布，UI线程读取）
+struct sim_snapshot_t {
+    motor_state_t state;        // 电机状态
+    svpwm_output_t svpwm;       // SVPWM输出
+    hall_state_t hall;          // 霍尔状态
+    control_target_t ref;       // 控制器内部参考值（id/iq/vel/pos）
+    int step_index = 0;         // 已执行步数
+    double sim_time = 0.0;      // 仿真时间 (s)
+};
 
-class loop_controller;
+// 仿真检查点：某一步执行前引擎的全部动态状态
+// 电机参数、PID参数、目标值与负载转矩属于用户设置，不随检查点恢复
+struct sim_checkpoint_t {
+    int step_index = 0;
+    double sim_time = 0.0;
+    motor_checkpoint_t motor;
+    loop_state_t loop;
+    six_step_state_t six_step;
+    svpwm_output_t svpwm;
+    double u_alpha_cmd = 0.0;
+    double u_beta_cmd = 0.0;
+    hall_state_t hall;
+    inverter_state_t inverter;
+};
 
 // 仿真引擎 - 负责运行仿真主循环
+// 两种运行方式：
+// - 同步模式：引擎定时器槽函数内执行多步仿真（默认）
+// - 线程模式：独立仿真线程按墙钟时间积分，引擎不启动定时器
+// 两种模式下界面均由frame_scheduler每帧读取get_snapshot()与sample_buffer()
 class sim_engine : public QObject {
     Q_OBJECT
 
@@ -22,7 +56,14 @@ public:
 
     // 配置
     void set_config(const sim_config_t& cfg);
-    sim_config_t get_config() const { return m_config; }
+    sim_config_t get_config() const;
+
+    // 线程模式开关（仅在停止状态下切换生效）
+    void set_threaded(bool en);
+    bool is_threaded() const { return m_threaded; }
+
+    // 仿真状态锁：线程模式下UI线程修改电机模型/控制器参数前需持有
+    std::unique_lock<std::mutex> lock_state() const { return std::unique_lock<std::mutex>(m_mutex); }
 
     // 设置电机模型
     void set_motor_model(std::unique_ptr<i_motor_model> model);
@@ -37,29 +78,56 @@ public:
     e_control_mode get_control_mode() const { return m_control_mode; }
 
     // 获取SVPWM输出
-    svpwm_output_t get_svpwm_output() const { return m_svpwm_out; }
+    svpwm_output_t get_svpwm_output() const;
 
     // 获取霍尔状态
-    hall_state_t get_hall_state() const { return m_hall_state; }
-    
+    hall_state_t get_hall_state() const;
+
+    // 获取最新仿真快照
+    sim_snapshot_t get_snapshot() const;
+
+    // 由电角度查表得到霍尔状态（轨迹回放等离线场景复用）
+    static hall_state_t hall_from_angle(double theta_e);
+
+    // 获取电机模型积分器统计（子步数、右端求值次数）
+    integrator_stats_t get_integrator_stats() const;
+
+    // 逐步采样缓冲（每个仿真步写入一个采样点，UI线程作为唯一消费者读取）
+    data_buffer<sim_sample_t>* sample_buffer() { return m_samples.get(); }
+
+    // 重设采样缓冲容量（仅在停止状态下调用，未读采样将被丢弃）
+    // set_config会按步长与倍速自动扩容，需要更小缓冲时在set_config之后调用
+    void set_sample_capacity(size_t capacity);
+
     // 设置负载转矩
-    void set_load_torque(double tl) { m_load_torque = tl; }
+    void set_load_torque(double tl);
     double get_load_torque() const { return m_load_torque; }
 
+    // 跳转到指定步：向前直接仿真；向后从不晚于目标的最近检查点恢复，再重新仿真剩余步数
+    // （重新仿真的步不写入采样缓冲，最多checkpoint_interval-1步）
+    // 目标早于最早的检查点时返回false
+    bool seek_step(int step_index);
+
+    // 当前保留的检查点数与最早可回退到的步数
+    size_t checkpoint_count() const;
+    int earliest_step() const;
+
+    // 在调用线程中连续执行count步（不经定时器、不发射信号），用于无界面批量仿真
+    // 每步采样仍写入sample_buffer()，调用方需及时取出
+    void run_steps(int count);
+
 public slots:
     void start();
     void stop();
     void pause();
     void step();
+    void step_back();
     void reset();
 
 signals:
-    void state_updated(const motor_state_t& state);
     void step_completed(int step_index, const QString& step_name);
     // FOC算法步骤变化信号（用于步骤高亮）
     void foc_step_changed(e_foc_step step);
-    // 霍尔状态变化信号
-    void hall_state_changed(const hall_state_t& hall);
 
 private slots:
     void run_loop();
@@ -70,6 +138,19 @@ private:
     void execute_six_step(motor_state_t& state, bool detailed);
     void calc_hall_state(double theta_e);
 
+    void apply_config(const sim_config_t& cfg);
+
+    // 检查点（调用方需持有m_mutex）
+    void save_checkpoint();
+    void restore_checkpoint(const sim_checkpoint_t& cp);
+
+    // 线程模式
+    void start_worker();
+    void stop_worker();
+    void worker_loop();
+    void publish_snapshot();
+    void fill_ref(control_target_t& ref) const;
+
     sim_config_t m_config;
     std::unique_ptr<i_motor_model> m_motor;
     loop_controller* m_loop_ctrl = nullptr;
@@ -77,13 +158,36 @@ private:
     transform m_transform;
     svpwm m_svpwm;
     svpwm_output_t m_svpwm_out;
+    inverter_model m_inverter;      // 开关模型（sim_config_t::inverter为SWITCHING时代替平均值电压推进电机）
+    double m_u_alpha_cmd = 0.0;     // 最近一次PWM更新的αβ电压指令（发布快照时计算幅值/角度）
+    double m_u_beta_cmd = 0.0;
     hall_state_t m_hall_state;
     e_control_mode m_control_mode = e_control_mode::FOC;
 
     QTimer* m_timer = nullptr;
     int m_step_index = 0;
+    double m_sim_time = 0.0;    // 仿真时间 (s)
     double m_udc = 24.0;        // 直流母线电压
     double m_load_torque = 0.2; // 负载转矩
+
+    // 线程模式状态
+    bool m_threaded = false;
+    std::thread m_worker;
+    std::atomic<bool> m_worker_running{false};
+    mutable std::mutex m_mutex;     // 保护仿真状态与快照
+    sim_snapshot_t m_snapshot;      // 最近一次发布的快照
+
+    // 采样缓冲容量：set_config按 dt 与 speed_ratio 扩大到可容纳约4个显示帧内的全部仿真步，只增不减
+    static constexpr size_t SAMPLE_BUFFER_SIZE = 1 << 16;      // 初始容量
+    // 自动扩容上限（sim_sample_t约248字节，约65MB）；更高步率下超出部分由dropped()计数
+    static constexpr size_t SAMPLE_BUFFER_MAX = 1 << 18;
+    static constexpr double SAMPLE_BUFFER_SECONDS = 4 * 0.016; // 需容纳的墙钟时长 (s)
+    static size_t required_sample_capacity(const sim_config_t& cfg);
+    std::unique_ptr<data_buffer<sim_sample_t>> m_samples;
+    bool m_record_samples = true;   // 检查点恢复后重新仿真期间不写采样
+
+    // 检查点按步数递增排列，满时覆盖最旧
+    ring_buffer<sim_checkpoint_t> m_checkpoints;
 };
 
 #endif // CORE_SIM_ENGINE_H
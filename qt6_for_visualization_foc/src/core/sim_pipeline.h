@@ -0,0 +1,268 @@
+#ifndef CORE_SIM_PIPELINE_H
+#define CORE_SIM_PIPELINE_H
+
+#include "types.h"
+#include "transform.h"
+#include "svpwm.h"
+#include "inverter_model.h"
+#include "pmsm_model.h"
+#include "bldc_model.h"
+#include "sim_engine.h"
+#include "control/loop_controller.h"
+#include "control/six_step_controller.h"
+#include "scalar_traits.h"
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// 编译期特化仿真流水线
+// 电机模型类型、控制模式和外环开关均为模板参数：模型按具体类型持有（final类，直接调用），
+// 各环由loop_controller的模板版本展开，不参与的分支在编译期消除，单步内没有虚函数分派。
+// 逐步计算与sim_engine::execute_one_step完全一致（同一输入得到逐位相同的轨迹），
+// 但不含检查点、快照发布和采样缓冲，供无界面批量仿真和参数扫描使用；
+// 界面程序仍使用可运行期切换模型的sim_engine
+// SCALAR为FOC控制通路的数值类型（scalar_traits.h）：double时直接驱动loop的级联计算核，
+// 与sim_engine逐位一致；其他类型按loop的参数与目标建立独立的控制通路，反馈量按SCALAR量化
+// 后输入控制器，输出电压再换算回物理单位作用于电机模型（电机模型始终为double）
+template<typename MODEL, e_control_mode MODE, bool VELOCITY, bool POSITION, typename SCALAR = double>
+class sim_pipeline {
+public:
+    using traits = scalar_traits<SCALAR>;
+    static constexpr bool NATIVE = std::is_same_v<SCALAR, double>;
+
+    sim_pipeline(loop_controller& loop, six_step_controller& six_step)
+        : m_loop(loop), m_six_step(six_step) {
+        if constexpr (NATIVE) {
+            m_ctrl = &loop.core();
+        } else {
+            m_own.copy_config(loop.core());
+            if constexpr (traits::PER_UNIT) {
+                m_own.set_base(suggest_per_unit_base(loop.get_vel_pid(), loop.get_pos_pid(),
+                                                     loop.get_target(), UDC));
+            }
+            m_ctrl = &m_own;
+        }
+    }
+    sim_pipeline(const sim_pipeline&) = delete;
+    sim_pipeline& operator=(const sim_pipeline&) = delete;
+
+    // 标幺化基值（仅定点控制通路生效；缺省按suggest_per_unit_base推算）
+    void set_base(const per_unit_base_t& base) {
+        if constexpr (traits::PER_UNIT) m_own.set_base(base);
+    }
+
+    void set_params(const motor_params_t& params) { m_model.set_params(params); }
+
+    void set_config(const sim_config_t& cfg) {
+        m_dt = cfg.dt;
+        m_current_div = std::max(1, cfg.loop_rates.current_div);
+        m_velocity_div = std::max(1, cfg.loop_rates.velocity_div);
+        m_position_div = std::max(1, cfg.loop_rates.position_div);
+        m_model.set_integrator(cfg.integrator);
+        m_model.set_trig_mode(cfg.trig_mode);
+        // 开关模型仅用于FOC（六步换向的占空比不是中心对齐PWM）
+        m_switching = MODE == e_control_mode::FOC && cfg.inverter.mode == e_inverter_mode::SWITCHING;
+        m_inverter.set_config(cfg.inverter);
+        m_inverter.set_udc(UDC);
+    }
+
+    void set_load_torque(double tl) { m_load_torque = tl; }
+
+    // 执行count步，每步结束后以流水线自身调用sink(const sim_pipeline&)
+    template<typename SINK>
+    void run(int64_t count, SINK&& sink) {
+        for (int64_t i = 0; i < count; ++i) {
+            step();
+            sink(static_cast<const sim_pipeline&>(*this));
+        }
+    }
+
+    // 单步仿真
+    void step() {
+        m_model.set_load_torque(m_load_torque);
+        const motor_state_t& state = m_model.state();
+        if constexpr (MODE == e_control_mode::SIX_STEP) {
+            step_six_step(state);
+        } else {
+            step_foc(state);
+        }
+        if (m_switching) {
+            m_inverter.advance(m_model, m_dt);
+        } else {
+            m_model.step(m_dt);
+        }
+        ++m_step_index;
+        m_sim_time += m_dt;
+    }
+
+    const motor_state_t& state() const { return m_model.state(); }
+    const svpwm_output_t& svpwm_output() const { return m_svpwm_out; }
+    const hall_state_t& hall_state() const { return m_hall_state; }
+    double sim_time() const { return m_sim_time; }
+    int64_t step_index() const { return m_step_index; }
+    const MODEL& model() const { return m_model; }
+    const inverter_model& inverter() const { return m_inverter; }
+    const basic_loop_controller<SCALAR>& controller() const { return *m_ctrl; }
+
+    // 组装与sim_engine采样缓冲相同的采样点（参考值换算为物理单位）
+    sim_sample_t sample() const {
+        const per_unit_base_t& base = m_ctrl->base();
+        sim_sample_t s;
+        s.t = m_sim_time;
+        s.state = m_model.state();
+        s.svpwm = m_svpwm_out;
+        s.ref.id_ref = m_ctrl->target().id_ref;
+        s.ref.iq_ref = traits::to_double(m_ctrl->iq_ref()) * base.current;
+        s.ref.vel_ref = traits::to_double(m_ctrl->vel_ref()) * base.speed;
+        s.ref.pos_ref = m_ctrl->target().pos_ref;
+        return s;
+    }
+
+private:
+    // FOC：多速率调度与sim_engine::execute_foc_step一致
+    void step_foc(const motor_state_t& state) {
+        if constexpr (NATIVE) {
+            run_foc(state);
+        } else {
+            run_foc(m_ctrl->quantize(state));
+        }
+    }
+
+    template<typename FEEDBACK>
+    void run_foc(const FEEDBACK& fb) {
+        basic_loop_controller<SCALAR>& ctrl = *m_ctrl;
+        if constexpr (POSITION) {
+            if (m_step_index % m_position_div == 0) {
+                ctrl.template update_position_t<POSITION>(fb, m_position_div * m_dt);
+            }
+        }
+        if (m_step_index % m_velocity_div == 0) {
+            ctrl.template update_velocity_t<POSITION, VELOCITY>(fb, m_velocity_div * m_dt);
+        }
+        if (m_step_index % m_current_div != 0) return;
+        ctrl.template update_current_t<VELOCITY, true>(fb, m_current_div * m_dt);
+        const SCALAR ud = ctrl.ud();
+        const SCALAR uq = ctrl.uq();
+
+        const double u_base = ctrl.base().voltage;
+        m_model.set_voltage(traits::to_double(ud) * u_base, traits::to_double(uq) * u_base);
+        SCALAR u_alpha, u_beta, ta, tb, tc;
+        if constexpr (NATIVE) {
+            basic_transform<double>::inv_park(ud, uq, m_model.get_rotation(), u_alpha, u_beta);
+        } else {
+            basic_transform<SCALAR>::inv_park(ud, uq, basic_rotation<SCALAR>::from(m_model.get_rotation()),
+                                              u_alpha, u_beta);
+        }
+        m_svpwm.calc(u_alpha, u_beta, UDC / u_base, ta, tb, tc);
+        m_svpwm_out.ta = traits::to_double(ta);
+        m_svpwm_out.tb = traits::to_double(tb);
+        m_svpwm_out.tc = traits::to_double(tc);
+        m_svpwm_out.sector = m_svpwm.get_sector();
+        if (m_switching) {
+            m_inverter.start_period(m_svpwm_out.ta, m_svpwm_out.tb, m_svpwm_out.tc, m_current_div * m_dt);
+        }
+    }
+
+    // 六步换向：与sim_engine::execute_six_step一致
+    void step_six_step(const motor_state_t& state) {
+        m_hall_state = sim_engine::hall_from_angle(state.theta_e);
+        const double vel_ref = m_loop.get_target().vel_ref;
+
+        double duty_a, duty_b, duty_c;
+        m_six_step.calc(state.theta_e, vel_ref, state.omega_m, m_dt, duty_a, duty_b, duty_c);
+
+        double u_alpha, u_beta;
+        m_transform.clark((duty_a - 0.5) * UDC, (duty_b - 0.5) * UDC, (duty_c - 0.5) * UDC,
+                          u_alpha, u_beta);
+        double ud, uq;
+        m_transform.park(u_alpha, u_beta, m_model.get_rotation(), ud, uq);
+        m_model.set_voltage(ud, uq);
+
+        m_svpwm_out.ta = duty_a;
+        m_svpwm_out.tb = duty_b;
+        m_svpwm_out.tc = duty_c;
+        m_svpwm_out.sector = m_hall_state.sector;
+    }
+
+    // 直流母线电压（与sim_engine一致）
+    static constexpr double UDC = 24.0;
+
+    MODEL m_model;
+    loop_controller& m_loop;
+    six_step_controller& m_six_step;
+    basic_loop_controller<SCALAR>* m_ctrl = nullptr;
+    basic_loop_controller<SCALAR> m_own;        // 非double控制通路自有的控制器
+    transform m_transform;
+    basic_svpwm<SCALAR> m_svpwm;
+    inverter_model m_inverter;
+    bool m_switching = false;
+
+    svpwm_output_t m_svpwm_out;
+    hall_state_t m_hall_state;
+    double m_dt = 1e-5;
+    double m_load_torque = 0.0;
+    double m_sim_time = 0.0;
+    int64_t m_step_index = 0;
+    int m_current_div = 1;
+    int m_velocity_div = 1;
+    int m_position_div = 1;
+};
+
+// 流水线类型标签：visit_pipeline通过它把选中的具体类型交给调用方
+template<typename T>
+struct pipeline_tag {
+    using type = T;
+};
+
+// 按运行期配置选择对应的流水线实例，以pipeline_tag<sim_pipeline<...>>调用fn
+// FOC模式下电流环关闭（仅调试用）不提供特化版本，返回false，调用方回退到sim_engine
+// numeric仅作用于FOC控制通路，六步换向始终为double
+template<typename F>
+bool visit_pipeline(e_motor_type motor_type, e_control_mode mode, e_numeric_type numeric,
+                    const loop_controller& loop, F&& fn) {
+    auto with_scalar = [&](auto model_tag, auto scalar_tag) {
+        using model_t = typename decltype(model_tag)::type;
+        using scalar_t = typename decltype(scalar_tag)::type;
+        const bool vel = loop.is_velocity_loop_enabled();
+        const bool pos = loop.is_position_loop_enabled();
+        if (vel && pos) {
+            fn(pipeline_tag<sim_pipeline<model_t, e_control_mode::FOC, true, true, scalar_t>>{});
+        } else if (vel) {
+            fn(pipeline_tag<sim_pipeline<model_t, e_control_mode::FOC, true, false, scalar_t>>{});
+        } else if (pos) {
+            fn(pipeline_tag<sim_pipeline<model_t, e_control_mode::FOC, false, true, scalar_t>>{});
+        } else {
+            fn(pipeline_tag<sim_pipeline<model_t, e_control_mode::FOC, false, false, scalar_t>>{});
+        }
+    };
+    auto with_model = [&](auto model_tag) {
+        using model_t = typename decltype(model_tag)::type;
+        if (mode == e_control_mode::SIX_STEP) {
+            fn(pipeline_tag<sim_pipeline<model_t, e_control_mode::SIX_STEP, false, false>>{});
+            return true;
+        }
+        if (!loop.is_current_loop_enabled()) return false;
+        switch (numeric) {
+            case e_numeric_type::FLOAT32: with_scalar(model_tag, pipeline_tag<float>{}); break;
+            case e_numeric_type::Q31:     with_scalar(model_tag, pipeline_tag<q31_t>{}); break;
+            case e_numeric_type::Q15:     with_scalar(model_tag, pipeline_tag<q15_t>{}); break;
+            default:                      with_scalar(model_tag, pipeline_tag<double>{}); break;
+        }
+        return true;
+    };
+    switch (motor_type) {
+        case e_motor_type::PMSM: return with_model(pipeline_tag<pmsm_model>{});
+        case e_motor_type::BLDC: return with_model(pipeline_tag<bldc_model>{});
+        default: return false;
+    }
+}
+
+// double控制通路
+template<typename F>
+bool visit_pipeline(e_motor_type motor_type, e_control_mode mode,
+                    const loop_controller& loop, F&& fn) {
+    return visit_pipeline(motor_type, mode, e_numeric_type::DOUBLE, loop, std::forward<F>(fn));
+}
+
+#endif // CORE_SIM_PIPELINE_H
@@ -2,6 +2,9 @@
 #define CORE_SVPWM_H
 
 #include "types.h"
+#include "scalar_traits.h"
+#include <algorithm>
+#include <limits>
 
 // i_svpwm接口
 class i_svpwm {
@@ -13,30 +16,139 @@ public:
     virtual void get_vector(double& mag, double& angle) const = 0;
 };
 
+// SVPWM计算核（按标量类型实例化，double实例即svpwm类的计算）
+// 七段式中心对齐：扇区判断 -> 相邻有效矢量作用时间T1、T2 -> 零矢量时间T0 -> 三相占空比
+// 作用时间的计算、求和与过调制归一化在wide_t中进行（定点时可表示1.0及以上），最后饱和回[0, 1]
+template<typename T>
+class basic_svpwm {
+public:
+    using traits = scalar_traits<T>;
+    using wide_t = typename traits::wide_t;
+
+    // udc与u_alpha/u_beta同单位（PER_UNIT类型为标幺值）
+    void calc(T u_alpha, T u_beta, double udc, T& ta, T& tb, T& tc) {
+        m_u_alpha = u_alpha;
+        m_u_beta = u_beta;
+
+        // 系数K = √3·Ts/udc（Ts归一化为1），母线电压不变时不重新计算
+        if (udc != m_udc) {
+            m_udc = udc;
+            m_k = scalar_traits<wide_t>::gain(SQRT3 / udc);
+        }
+
+        // 计算U1, U2, U3用于确定基本矢量作用时间
+        const T k_half = traits::from_double(0.5);
+        const T k_s = traits::from_double(SQRT3_DIV_2);
+        const wide_t W1 = traits::widen(u_beta);
+        const wide_t W2 = traits::widen(k_s * u_alpha) - traits::widen(k_half * u_beta);
+        const wide_t W3 = traits::widen(-k_s * u_alpha) - traits::widen(k_half * u_beta);
+        m_sector = calc_sector(W1, W2, W3);
+
+        // 根据扇区计算T1, T2（基本矢量作用时间）
+        // U1~U3及T1、T2均在wide_t中计算，过调制时不会在归一化前饱和
+        wide_t T1{}, T2{};
+        switch (m_sector) {
+            case 1:  T1 = W2 * m_k;     T2 = W1 * m_k;     break;  // V4(100), V6(110)
+            case 2:  T1 = -(W3 * m_k);  T2 = -(W2 * m_k);  break;  // V6(110), V2(010)
+            case 3:  T1 = W1 * m_k;     T2 = W3 * m_k;     break;  // V2(010), V3(011)
+            case 4:  T1 = -(W2 * m_k);  T2 = -(W1 * m_k);  break;  // V3(011), V1(001)
+            case 5:  T1 = W3 * m_k;     T2 = W2 * m_k;     break;  // V1(001), V5(101)
+            case 6:  T1 = -(W1 * m_k);  T2 = -(W3 * m_k);  break;  // V5(101), V4(100)
+        }
+
+        // 限制T1+T2不超过Ts
+        const wide_t one = unit();
+        const wide_t T_sum = T1 + T2;
+        if (T_sum > one) {
+            T1 = ratio(T1, T_sum);
+            T2 = ratio(T2, T_sum);
+        }
+
+        // 零矢量作用时间
+        const wide_t T0 = half(one - T1 - T2);
+
+        // 三相占空比（七段式中心对齐）
+        wide_t Tcm1{}, Tcm2{}, Tcm3{};
+        switch (m_sector) {
+            case 1: Tcm1 = T1 + T2 + T0; Tcm2 = T2 + T0;      Tcm3 = T0;           break;
+            case 2: Tcm1 = T1 + T0;      Tcm2 = T1 + T2 + T0; Tcm3 = T0;           break;
+            case 3: Tcm1 = T0;           Tcm2 = T1 + T2 + T0; Tcm3 = T2 + T0;      break;
+            case 4: Tcm1 = T0;           Tcm2 = T1 + T0;      Tcm3 = T1 + T2 + T0; break;
+            case 5: Tcm1 = T2 + T0;      Tcm2 = T0;           Tcm3 = T1 + T2 + T0; break;
+            case 6: Tcm1 = T1 + T2 + T0; Tcm2 = T0;           Tcm3 = T1 + T0;      break;
+        }
+
+        // 饱和到[0, 1]（定点上限为最大可表示值）
+        ta = duty(Tcm1);
+        tb = duty(Tcm2);
+        tc = duty(Tcm3);
+    }
+
+    int get_sector() const { return m_sector; }
+    T u_alpha() const { return m_u_alpha; }
+    T u_beta() const { return m_u_beta; }
+
+private:
+    // 扇区判断：基于U1、U2、U3的符号，N = A + 2B + 4C -> 扇区
+    static int calc_sector(wide_t U1, wide_t U2, wide_t U3) {
+        const wide_t zero{};
+        const int N = (U1 > zero ? 1 : 0) + (U2 > zero ? 2 : 0) + (U3 > zero ? 4 : 0);
+        switch (N) {
+            case 3: return 1;
+            case 1: return 2;
+            case 5: return 3;
+            case 4: return 4;
+            case 6: return 5;
+            case 2: return 6;
+            default: return 1;
+        }
+    }
+
+    static wide_t unit() {
+        if constexpr (traits::PER_UNIT) return wide_t::saturate(wide_t::ONE_RAW);
+        else return wide_t(1.0);
+    }
+    static wide_t ratio(wide_t num, wide_t den) {
+        if constexpr (traits::PER_UNIT) return wide_t::ratio(num, den);
+        else return num / den;
+    }
+    static wide_t half(wide_t v) {
+        if constexpr (traits::PER_UNIT) return wide_t::saturate(v.raw() / 2);
+        else return v / wide_t(2.0);
+    }
+    static T duty(wide_t v) {
+        return traits::narrow(std::clamp(v, wide_t{}, traits::widen(upper())));
+    }
+    static T upper() {
+        if constexpr (traits::PER_UNIT) return T::max();
+        else return T(1.0);
+    }
+
+    int m_sector = 1;
+    T m_u_alpha{};              // 最近一次输入的αβ电压
+    T m_u_beta{};
+    double m_udc = std::numeric_limits<double>::quiet_NaN();
+    typename scalar_traits<wide_t>::gain_t m_k{};
+};
+
 // SVPWM空间矢量脉宽调制算法
 // 将αβ坐标系的电压矢量转换为三相占空比
 class svpwm : public i_svpwm {
 public:
     // 计算三相占空比
     void calc(double u_alpha, double u_beta, double udc,
-              double& Ta, double& Tb, double& Tc) override;
+              double& Ta, double& Tb, double& Tc) override {
+        m_core.calc(u_alpha, u_beta, udc, Ta, Tb, Tc);
+    }
 
     // 获取当前扇区(1-6)
-    int get_sector() const override { return m_sector; }
+    int get_sector() const override { return m_core.get_sector(); }
 
-    // 获取电压矢量的幅值和角度
-    void get_vector(double& mag, double& angle) const override {
-        mag = m_mag;
-        angle = m_angle;
-    }
+    // 获取电压矢量的幅值和角度（按需计算，calc中不做sqrt/atan2）
+    void get_vector(double& mag, double& angle) const override;
 
 private:
-    // 判断扇区
-    int calc_sector(double u_alpha, double u_beta);
-
-    int m_sector = 1;
-    double m_mag = 0.0;
-    double m_angle = 0.0;
+    basic_svpwm<double> m_core;
 };
 
 #endif // CORE_SVPWM_H
@@ -0,0 +1,245 @@
+#include "trajectory_file.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+static const char TRAJ_MAGIC[8] = {'F', 'O', 'C', 'T', 'R', 'J', '0', '1'};
+
+static const char* const COLUMN_NAMES[TRAJ_COLUMN_COUNT] = {
+    "t",
+    "theta_e", "theta_m", "omega_e", "omega_m",
+    "id", "iq", "ud", "uq",
+    "ia", "ib", "ic",
+    "i_alpha", "i_beta", "u_alpha", "u_beta",
+    "ua", "ub", "uc",
+    "te", "tl",
+    "ta", "tb", "tc", "sector", "mag", "angle",
+    "id_ref", "iq_ref", "vel_ref", "pos_ref",
+};
+
+const char* traj_column_name(e_traj_column column) {
+    size_t c = static_cast<size_t>(column);
+    return c < TRAJ_COLUMN_COUNT ? COLUMN_NAMES[c] : "";
+}
+
+void traj_pack_row(const sim_sample_t& s, double* row) {
+    const motor_state_t& st = s.state;
+    const double values[TRAJ_COLUMN_COUNT] = {
+        s.t,
+        st.theta_e, st.theta_m, st.omega_e, st.omega_m,
+        st.id, st.iq, st.ud, st.uq,
+        st.ia, st.ib, st.ic,
+        st.i_alpha, st.i_beta, st.u_alpha, st.u_beta,
+        st.ua, st.ub, st.uc,
+        st.te, st.tl,
+        s.svpwm.ta, s.svpwm.tb, s.svpwm.tc, static_cast<double>(s.svpwm.sector),
+        s.svpwm.mag, s.svpwm.angle,
+        s.ref.id_ref, s.ref.iq_ref, s.ref.vel_ref, s.ref.pos_ref,
+    };
+    std::memcpy(row, values, sizeof(values));
+}
+
+// 行 → 采样点
+static void unpack_row(const double* row, sim_sample_t& s) {
+    motor_state_t& st = s.state;
+    const double* v = row;
+    s.t = *v++;
+    st.theta_e = *v++; st.theta_m = *v++; st.omega_e = *v++; st.omega_m = *v++;
+    st.id = *v++; st.iq = *v++; st.ud = *v++; st.uq = *v++;
+    st.ia = *v++; st.ib = *v++; st.ic = *v++;
+    st.i_alpha = *v++; st.i_beta = *v++; st.u_alpha = *v++; st.u_beta = *v++;
+    st.ua = *v++; st.ub = *v++; st.uc = *v++;
+    st.te = *v++; st.tl = *v++;
+    s.svpwm.ta = *v++; s.svpwm.tb = *v++; s.svpwm.tc = *v++;
+    s.svpwm.sector = static_cast<int>(*v++);
+    s.svpwm.mag = *v++; s.svpwm.angle = *v++;
+    s.ref.id_ref = *v++; s.ref.iq_ref = *v++; s.ref.vel_ref = *v++; s.ref.pos_ref = *v++;
+}
+
+// ========== trajectory_recorder ==========
+
+// 初始容量（块），之后按倍增扩容
+static constexpr size_t INITIAL_CHUNKS = 4;
+
+trajectory_recorder::~trajectory_recorder() {
+    close();
+}
+
+bool trajectory_recorder::open(const QString& path, double dt) {
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        qWarning() << "无法创建轨迹文件:" << path << m_file.errorString();
+        return false;
+    }
+    m_rows = 0;
+    m_chunks = 0;
+    if (!reserve_chunks(INITIAL_CHUNKS)) {
+        m_file.close();
+        return false;
+    }
+    trajectory_header_t header{};
+    std::memcpy(header.magic, TRAJ_MAGIC, sizeof(header.magic));
+    header.version = TRAJ_VERSION;
+    header.column_count = static_cast<uint32_t>(TRAJ_COLUMN_COUNT);
+    header.chunk_rows = static_cast<uint32_t>(TRAJ_CHUNK_ROWS);
+    header.row_count = 0;
+    header.dt = dt;
+    std::memcpy(m_map, &header, sizeof(header));
+    return true;
+}
+
+bool trajectory_recorder::reserve_chunks(size_t min_chunks) {
+    if (min_chunks <= m_chunks) return true;
+    size_t chunks = std::max(min_chunks, m_chunks * 2);
+    qint64 bytes = static_cast<qint64>(TRAJ_HEADER_BYTES + chunks * TRAJ_CHUNK_BYTES);
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    if (!m_file.resize(bytes)) {
+        qWarning() << "轨迹文件扩容失败:" << m_file.errorString();
+        return false;
+    }
+    m_map = m_file.map(0, bytes);
+    if (!m_map) {
+        qWarning() << "轨迹文件映射失败:" << m_file.errorString();
+        return false;
+    }
+    m_chunks = chunks;
+    return true;
+}
+
+bool trajectory_recorder::append(const sim_sample_t* samples, size_t count) {
+    if (!m_map) return false;
+    if (count == 0) return true;
+    // 只写入时间单调的前缀
+    size_t valid = 0;
+    double last_t = m_rows > 0 ? m_last_t : samples[0].t;
+    while (valid < count && samples[valid].t >= last_t) {
+        last_t = samples[valid].t;
+        ++valid;
+    }
+    const bool reversed = valid < count;
+    count = valid;
+    if (count == 0) {
+        qWarning() << "仿真时间回退，轨迹录制结束于t =" << m_last_t;
+        close();
+        return false;
+    }
+    const size_t need_chunks = static_cast<size_t>((m_rows + count + TRAJ_CHUNK_ROWS - 1) / TRAJ_CHUNK_ROWS);
+    if (!reserve_chunks(need_chunks)) {
+        close();
+        return false;
+    }
+    double row[TRAJ_COLUMN_COUNT];
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t r = m_rows + i;
+        double* base = reinterpret_cast<double*>(
+            m_map + TRAJ_HEADER_BYTES + (r / TRAJ_CHUNK_ROWS) * TRAJ_CHUNK_BYTES);
+        const size_t offset = r % TRAJ_CHUNK_ROWS;
+        traj_pack_row(samples[i], row);
+        for (size_t c = 0; c < TRAJ_COLUMN_COUNT; ++c) {
+            base[c * TRAJ_CHUNK_ROWS + offset] = row[c];
+        }
+    }
+    // 数据写完再提交行数
+    m_rows += count;
+    m_last_t = last_t;
+    std::memcpy(m_map + offsetof(trajectory_header_t, row_count), &m_rows, sizeof(m_rows));
+    if (reversed) {
+        qWarning() << "仿真时间回退，轨迹录制结束于t =" << m_last_t;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void trajectory_recorder::close() {
+    if (!m_file.isOpen()) return;
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    // 只保留已使用的块
+    size_t used = static_cast<size_t>((m_rows + TRAJ_CHUNK_ROWS - 1) / TRAJ_CHUNK_ROWS);
+    m_file.resize(static_cast<qint64>(TRAJ_HEADER_BYTES + used * TRAJ_CHUNK_BYTES));
+    m_file.close();
+    m_chunks = 0;
+}
+
+// ========== trajectory_reader ==========
+
+trajectory_reader::~trajectory_reader() {
+    close();
+}
+
+bool trajectory_reader::open(const QString& path) {
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法打开轨迹文件:" << path << m_file.errorString();
+        return false;
+    }
+    const qint64 size = m_file.size();
+    if (size < static_cast<qint64>(TRAJ_HEADER_BYTES)) {
+        qWarning() << "轨迹文件过小:" << path;
+        m_file.close();
+        return false;
+    }
+    m_map = m_file.map(0, size);
+    if (!m_map) {
+        qWarning() << "轨迹文件映射失败:" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    trajectory_header_t header;
+    std::memcpy(&header, m_map, sizeof(header));
+    if (std::memcmp(header.magic, TRAJ_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TRAJ_VERSION ||
+        header.column_count != TRAJ_COLUMN_COUNT ||
+        header.chunk_rows != TRAJ_CHUNK_ROWS) {
+        qWarning() << "轨迹文件格式不匹配:" << path;
+        close();
+        return false;
+    }
+    // 行数不超过文件实际包含的完整块（防止截断的文件越界访问）
+    const uint64_t max_rows = static_cast<uint64_t>((size - TRAJ_HEADER_BYTES) / TRAJ_CHUNK_BYTES) * TRAJ_CHUNK_ROWS;
+    m_rows = std::min(header.row_count, max_rows);
+    m_dt = header.dt;
+    return true;
+}
+
+void trajectory_reader::close() {
+    if (m_map) {
+        m_file.unmap(const_cast<uchar*>(m_map));
+        m_map = nullptr;
+    }
+    if (m_file.isOpen()) m_file.close();
+    m_rows = 0;
+}
+
+sim_sample_t trajectory_reader::sample(uint64_t row) const {
+    double values[TRAJ_COLUMN_COUNT];
+    for (size_t c = 0; c < TRAJ_COLUMN_COUNT; ++c) {
+        values[c] = value(static_cast<e_traj_column>(c), row);
+    }
+    sim_sample_t s;
+    unpack_row(values, s);
+    return s;
+}
+
+uint64_t trajectory_reader::find_row(double time) const {
+    if (m_rows == 0) return 0;
+    uint64_t lo = 0, hi = m_rows - 1;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (value(e_traj_column::T, mid) < time) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
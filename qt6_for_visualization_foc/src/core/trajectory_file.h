@@ -0,0 +1,126 @@
+#ifndef CORE_TRAJECTORY_FILE_H
+#define CORE_TRAJECTORY_FILE_H
+
+#include "types.h"
+#include <QFile>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+
+// 轨迹文件列（每个仿真采样点一行，每列一个double）
+enum class e_traj_column : uint32_t {
+    T,
+    THETA_E, THETA_M, OMEGA_E, OMEGA_M,
+    ID, IQ, UD, UQ,
+    IA, IB, IC,
+    I_ALPHA, I_BETA, U_ALPHA, U_BETA,
+    UA, UB, UC,
+    TE, TL,
+    TA, TB, TC, SECTOR, MAG, ANGLE,
+    ID_REF, IQ_REF, VEL_REF, POS_REF,
+    COUNT
+};
+
+constexpr size_t TRAJ_COLUMN_COUNT = static_cast<size_t>(e_traj_column::COUNT);
+
+// 列名（导出/调试用）
+const char* traj_column_name(e_traj_column column);
+
+// 采样点 → 一行（row需容纳TRAJ_COLUMN_COUNT个double，列顺序与e_traj_column一致）
+// 轨迹文件与foc_headless的CSV输出共用，保证两种格式列一致
+void traj_pack_row(const sim_sample_t& s, double* row);
+
+// 轨迹文件格式（小端，追加写入，按块列存）：
+// - [0, 4096)：文件头 trajectory_header_t，其余字节保留
+// - 之后为连续的数据块，每块 TRAJ_CHUNK_ROWS 行；块内按列存放，
+//   第c列占 TRAJ_CHUNK_ROWS 个double，行r位于 块首 + (c * TRAJ_CHUNK_ROWS + r) * 8
+// - 行数只在每批追加完成后写入文件头，进程异常退出时已提交的行仍然有效
+struct trajectory_header_t {
+    char magic[8];              // "FOCTRJ01"
+    uint32_t version;
+    uint32_t column_count;
+    uint32_t chunk_rows;
+    uint32_t reserved;
+    uint64_t row_count;         // 已提交行数
+    double dt;                  // 仿真步长 (s)，仅供参考
+};
+
+constexpr uint32_t TRAJ_VERSION = 1;
+constexpr size_t TRAJ_HEADER_BYTES = 4096;
+constexpr size_t TRAJ_CHUNK_ROWS = 4096;
+constexpr size_t TRAJ_CHUNK_BYTES = TRAJ_CHUNK_ROWS * TRAJ_COLUMN_COUNT * sizeof(double);
+
+// 轨迹录制器：将sim_sample_t流追加写入内存映射的列存文件
+// 文件按块倍增扩容（解除映射→扩大文件→重新映射），写入本身只是内存拷贝
+class trajectory_recorder {
+public:
+    trajectory_recorder() = default;
+    ~trajectory_recorder();
+
+    trajectory_recorder(const trajectory_recorder&) = delete;
+    trajectory_recorder& operator=(const trajectory_recorder&) = delete;
+
+    // 新建轨迹文件（已存在则覆盖），失败返回false
+    bool open(const QString& path, double dt);
+
+    // 追加采样，写完后提交行数
+    // 时间列必须单调不减（读取端按时间二分查找）：遇到t回退（复位、单步后退）时
+    // 提交此前的行并关闭文件，返回false
+    bool append(const sim_sample_t* samples, size_t count);
+
+    // 截掉未使用的预分配块并关闭
+    void close();
+
+    bool is_open() const { return m_map != nullptr; }
+    uint64_t row_count() const { return m_rows; }
+    QString path() const { return m_file.fileName(); }
+
+private:
+    // 容量扩大到至少min_chunks块
+    bool reserve_chunks(size_t min_chunks);
+
+    QFile m_file;
+    uchar* m_map = nullptr;
+    size_t m_chunks = 0;        // 当前文件容量（块）
+    uint64_t m_rows = 0;
+    double m_last_t = 0.0;      // 最后一行的时间
+};
+
+// 轨迹读取器：只读映射整个文件，按行随机访问
+class trajectory_reader {
+public:
+    trajectory_reader() = default;
+    ~trajectory_reader();
+
+    trajectory_reader(const trajectory_reader&) = delete;
+    trajectory_reader& operator=(const trajectory_reader&) = delete;
+
+    // 打开并校验轨迹文件，失败返回false
+    bool open(const QString& path);
+    void close();
+
+    bool is_open() const { return m_map != nullptr; }
+    uint64_t row_count() const { return m_rows; }
+    double dt() const { return m_dt; }
+
+    // 单列单行
+    double value(e_traj_column column, uint64_t row) const {
+        const double* base = reinterpret_cast<const double*>(
+            m_map + TRAJ_HEADER_BYTES + (row / TRAJ_CHUNK_ROWS) * TRAJ_CHUNK_BYTES);
+        return base[static_cast<size_t>(column) * TRAJ_CHUNK_ROWS + row % TRAJ_CHUNK_ROWS];
+    }
+
+    // 还原为采样点（row需小于row_count）
+    sim_sample_t sample(uint64_t row) const;
+
+    // 时间列单调时，返回首个 t >= time 的行（超出末尾返回row_count-1）
+    uint64_t find_row(double time) const;
+
+private:
+    QFile m_file;
+    const uchar* m_map = nullptr;
+    uint64_t m_rows = 0;
+    double m_dt = 0.0;
+};
+
+#endif // CORE_TRAJECTORY_FILE_H
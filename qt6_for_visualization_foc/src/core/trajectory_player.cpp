@@ -0,0 +1,126 @@
+#include "trajectory_player.h"
+#include <QDebug>
+#include <algorithm>
+
+// 单次推进的最大墙钟间隔 (s)，避免窗口拖动等卡顿后一次跳过大段轨迹
+static constexpr double MAX_WALL_STEP = 0.1;
+
+bool trajectory_player::open(const QString& path) {
+    close();
+    if (!m_reader.open(path)) return false;
+    if (m_reader.row_count() == 0) {
+        qWarning() << "轨迹文件为空:" << path;
+        m_reader.close();
+        return false;
+    }
+    seek_row(0);
+    return true;
+}
+
+void trajectory_player::close() {
+    m_reader.close();
+    m_row = 0;
+    m_play_time = 0.0;
+    m_playing = false;
+    m_backfill = true;
+}
+
+void trajectory_player::set_speed(double speed) {
+    if (speed > 0.0) m_speed = speed;
+}
+
+void trajectory_player::set_playing(bool playing) {
+    if (playing && !m_playing && is_open() && m_row + 1 >= m_reader.row_count()) {
+        seek_row(0);
+    }
+    m_playing = playing && is_open();
+    m_last_wall = clock_t_::now();
+}
+
+void trajectory_player::seek_row(uint64_t row) {
+    if (!is_open()) return;
+    m_row = std::min(row, m_reader.row_count() - 1);
+    m_play_time = m_reader.value(e_traj_column::T, m_row);
+    m_backfill = true;
+    m_last_wall = clock_t_::now();
+}
+
+void trajectory_player::seek_time(double time) {
+    if (!is_open()) return;
+    seek_row(m_reader.find_row(time));
+}
+
+void trajectory_player::seek_fraction(double fraction) {
+    if (!is_open()) return;
+    fraction = std::clamp(fraction, 0.0, 1.0);
+    seek_row(static_cast<uint64_t>(fraction * static_cast<double>(m_reader.row_count() - 1) + 0.5));
+}
+
+void trajectory_player::step() {
+    if (!is_open() || m_row + 1 >= m_reader.row_count()) return;
+    ++m_row;
+    m_play_time = m_reader.value(e_traj_column::T, m_row);
+    // 下一次advance输出这一行
+    m_backfill = false;
+    m_step_pending = true;
+}
+
+double trajectory_player::progress() const {
+    const uint64_t n = m_reader.row_count();
+    return n > 1 ? static_cast<double>(m_row) / static_cast<double>(n - 1) : 0.0;
+}
+
+void trajectory_player::emit_rows(uint64_t first, uint64_t last,
+                                  std::vector<sim_sample_t>& out, size_t max_samples) const {
+    if (max_samples == 0 || first > last) return;
+    if (last - first + 1 > max_samples) first = last + 1 - max_samples;
+    for (uint64_t r = first; r <= last; ++r) {
+        out.push_back(m_reader.sample(r));
+    }
+}
+
+void trajectory_player::advance(std::vector<sim_sample_t>& out, size_t max_samples) {
+    if (!is_open()) return;
+    const uint64_t prev = m_row;
+    if (m_backfill) {
+        // 跳转/打开后：回填到当前行为止的历史
+        m_backfill = false;
+        m_step_pending = false;
+        emit_rows(0, m_row, out, max_samples);
+    } else if (m_step_pending) {
+        m_step_pending = false;
+        emit_rows(m_row, m_row, out, max_samples);
+    }
+    if (!m_playing) return;
+
+    const auto now = clock_t_::now();
+    const double wall = std::min(std::chrono::duration<double>(now - m_last_wall).count(), MAX_WALL_STEP);
+    m_last_wall = now;
+    m_play_time += wall * m_speed;
+
+    // 时间列单调递增：从当前行向后推进到不超过回放时间的最后一行
+    const uint64_t last = m_reader.row_count() - 1;
+    uint64_t row = m_reader.find_row(m_play_time);
+    if (row > 0 && m_reader.value(e_traj_column::T, row) > m_play_time) --row;
+    row = std::max(row, prev);
+    if (row > prev) {
+        emit_rows(prev + 1, row, out, max_samples);
+        m_row = row;
+    }
+    if (m_row >= last) {
+        m_playing = false;
+    }
+}
+
+sim_snapshot_t trajectory_player::snapshot() const {
+    sim_snapshot_t snap;
+    if (!is_open()) return snap;
+    const sim_sample_t s = m_reader.sample(m_row);
+    snap.state = s.state;
+    snap.svpwm = s.svpwm;
+    snap.ref = s.ref;
+    snap.hall = sim_engine::hall_from_angle(s.state.theta_e);
+    snap.step_index = static_cast<int>(m_row);
+    snap.sim_time = s.t;
+    return snap;
+}
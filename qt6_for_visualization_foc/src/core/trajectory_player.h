@@ -0,0 +1,63 @@
+#ifndef CORE_TRAJECTORY_PLAYER_H
+#define CORE_TRAJECTORY_PLAYER_H
+
+#include "trajectory_file.h"
+#include "sim_engine.h"
+#include <chrono>
+#include <vector>
+
+// 轨迹回放器：按墙钟时间×回放倍速推进轨迹文件中的时间列
+// - advance() 取出自上次调用以来越过的全部行，交给波形等逐点消费者
+// - snapshot() 返回当前行的快照，供各面板按帧刷新
+// - 支持任意位置跳转，跳转后下一次advance回填跳转点之前的历史
+class trajectory_player {
+public:
+    // 打开轨迹文件并定位到首行（暂停状态），失败返回false
+    bool open(const QString& path);
+    void close();
+    bool is_open() const { return m_reader.is_open() && m_reader.row_count() > 0; }
+
+    // 回放倍速（相对仿真时间）
+    void set_speed(double speed);
+    double speed() const { return m_speed; }
+
+    // 播放/暂停；在末尾开始播放时从头播放
+    void set_playing(bool playing);
+    bool is_playing() const { return m_playing; }
+
+    // 跳转到指定行 / 指定仿真时间
+    void seek_row(uint64_t row);
+    void seek_time(double time);
+    // 跳转到进度比例 [0, 1]
+    void seek_fraction(double fraction);
+
+    // 暂停状态下前进一行
+    void step();
+
+    uint64_t position() const { return m_row; }
+    uint64_t row_count() const { return m_reader.row_count(); }
+    double progress() const;
+
+    // 按墙钟推进并将越过的行追加到out（最多保留最后max_samples行）
+    void advance(std::vector<sim_sample_t>& out, size_t max_samples);
+
+    // 当前行快照（霍尔状态由电角度重新计算）
+    sim_snapshot_t snapshot() const;
+
+private:
+    using clock_t_ = std::chrono::steady_clock;
+
+    // 将行区间 [first, last] 追加到out，超出max_samples时只保留末尾
+    void emit_rows(uint64_t first, uint64_t last, std::vector<sim_sample_t>& out, size_t max_samples) const;
+
+    trajectory_reader m_reader;
+    uint64_t m_row = 0;             // 当前行（已显示）
+    double m_play_time = 0.0;       // 当前回放仿真时间
+    double m_speed = 1.0;
+    bool m_playing = false;
+    bool m_backfill = true;         // 跳转后需要回填历史
+    bool m_step_pending = false;    // 单步后需要输出当前行
+    clock_t_::time_point m_last_wall;
+};
+
+#endif // CORE_TRAJECTORY_PLAYER_H
@@ -1,6 +1,5 @@
 #include "transform.h"
-#include "types.h"
-#include <cmath>
+#include "fast_trig.h"
 
 // Clark变换（等幅值变换）
 // iα = ia
@@ -9,8 +8,7 @@
 void transform::clark(double ia, double ib, double ic,
                       double& i_alpha, double& i_beta) {
     (void)ic;  // 三相对称时ic不需要
-    i_alpha = ia;
-    i_beta = (ia + 2.0 * ib) * ONE_DIV_SQRT3;
+    basic_transform<double>::clark(ia, ib, i_alpha, i_beta);
 }
 
 // Park变换
@@ -18,10 +16,12 @@ void transform::clark(double ia, double ib, double ic,
 // iq = -iα*sin(θ) + iβ*cos(θ)
 void transform::park(double i_alpha, double i_beta, double theta,
                      double& id, double& iq) {
-    double cos_t = std::cos(theta);
-    double sin_t = std::sin(theta);
-    id = i_alpha * cos_t + i_beta * sin_t;
-    iq = -i_alpha * sin_t + i_beta * cos_t;
+    park(i_alpha, i_beta, make_rotation(theta), id, iq);
+}
+
+void transform::park(double i_alpha, double i_beta, const rotation_t& rot,
+                     double& id, double& iq) {
+    basic_transform<double>::park(i_alpha, i_beta, rot, id, iq);
 }
 
 // 逆Clark变换
@@ -30,9 +30,7 @@ void transform::park(double i_alpha, double i_beta, double theta,
 // uc = -0.5*uα - (√3/2)*uβ
 void transform::inv_clark(double u_alpha, double u_beta,
                           double& ua, double& ub, double& uc) {
-    ua = u_alpha;
-    ub = -0.5 * u_alpha + SQRT3_DIV_2 * u_beta;
-    uc = -0.5 * u_alpha - SQRT3_DIV_2 * u_beta;
+    basic_transform<double>::inv_clark(u_alpha, u_beta, ua, ub, uc);
 }
 
 // 逆Park变换
@@ -40,8 +38,10 @@ void transform::inv_clark(double u_alpha, double u_beta,
 // uβ = ud*sin(θ) + uq*cos(θ)
 void transform::inv_park(double ud, double uq, double theta,
                          double& u_alpha, double& u_beta) {
-    double cos_t = std::cos(theta);
-    double sin_t = std::sin(theta);
-    u_alpha = ud * cos_t - uq * sin_t;
-    u_beta = ud * sin_t + uq * cos_t;
+    inv_park(ud, uq, make_rotation(theta), u_alpha, u_beta);
+}
+
+void transform::inv_park(double ud, double uq, const rotation_t& rot,
+                         double& u_alpha, double& u_beta) {
+    basic_transform<double>::inv_park(ud, uq, rot, u_alpha, u_beta);
 }
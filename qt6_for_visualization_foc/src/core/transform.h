@@ -2,6 +2,59 @@
 #define CORE_TRANSFORM_H
 
 #include "i_transform.h"
+#include "scalar_traits.h"
+
+// 控制通路标量类型的旋转因子（定点时sin/cos相当于固件的正弦查表输出）
+// double控制通路直接使用rotation_t
+template<typename T>
+struct basic_rotation {
+    T sin_t{};
+    T cos_t{};
+
+    static basic_rotation from(const rotation_t& rot) {
+        return {scalar_traits<T>::from_double(rot.sin_t), scalar_traits<T>::from_double(rot.cos_t)};
+    }
+};
+
+// 坐标变换计算核（按标量类型实例化，double实例即transform类的计算）
+// ROT为rotation_t或basic_rotation<T>
+template<typename T>
+struct basic_transform {
+    using traits = scalar_traits<T>;
+
+    // Clark变换（等幅值，假设ia + ib + ic = 0）
+    static void clark(T ia, T ib, T& i_alpha, T& i_beta) {
+        i_alpha = ia;
+        if constexpr (traits::PER_UNIT) {
+            // 2/√3超出Q格式范围，拆为两个系数分别相乘
+            constexpr auto K1 = traits::gain(ONE_DIV_SQRT3);
+            constexpr auto K2 = traits::gain(2.0 * ONE_DIV_SQRT3);
+            i_beta = ia * K1 + ib * K2;
+        } else {
+            i_beta = (ia + T(2.0) * ib) * T(ONE_DIV_SQRT3);
+        }
+    }
+
+    template<typename ROT>
+    static void park(T i_alpha, T i_beta, const ROT& rot, T& id, T& iq) {
+        id = i_alpha * rot.cos_t + i_beta * rot.sin_t;
+        iq = -i_alpha * rot.sin_t + i_beta * rot.cos_t;
+    }
+
+    static void inv_clark(T u_alpha, T u_beta, T& ua, T& ub, T& uc) {
+        const T half = traits::from_double(-0.5);
+        const T k = traits::from_double(SQRT3_DIV_2);
+        ua = u_alpha;
+        ub = half * u_alpha + k * u_beta;
+        uc = half * u_alpha - k * u_beta;
+    }
+
+    template<typename ROT>
+    static void inv_park(T ud, T uq, const ROT& rot, T& u_alpha, T& u_beta) {
+        u_alpha = ud * rot.cos_t - uq * rot.sin_t;
+        u_beta = ud * rot.sin_t + uq * rot.cos_t;
+    }
+};
 
 // 坐标变换实现
 // Clark变换: 三相静止坐标系(abc) -> 两相静止坐标系(αβ)
@@ -24,6 +77,12 @@ public:
     // 逆Park变换: ud,uq,θ -> uα,uβ
     void inv_park(double ud, double uq, double theta,
                   double& u_alpha, double& u_beta) override;
+
+    // 使用旋转因子的Park/逆Park变换（同一步内sin/cos只计算一次）
+    void park(double i_alpha, double i_beta, const rotation_t& rot,
+              double& id, double& iq) override;
+    void inv_park(double ud, double uq, const rotation_t& rot,
+                  double& u_alpha, double& u_beta) override;
 };
 
 #endif // CORE_TRANSFORM_H
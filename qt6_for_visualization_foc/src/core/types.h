@@ -95,10 +95,105 @@ struct pid_params_t {
     double integral_max = 50.0;
 };
 
+// PID内部状态（仿真检查点保存/恢复用）
+struct pid_state_t {
+    double integral     = 0.0;
+    double prev_error   = 0.0;
+};
+
+// 电机模型数值积分方法
+enum class e_integrator {
+    EULER,          // 前向欧拉（默认，与原模型一致）
+    RK4,            // 经典四阶龙格-库塔，定步长
+    RK45,           // Dormand–Prince 5(4)，自适应步长+误差控制
+    ZOH             // dq电流方程零阶保持精确离散（矩阵指数），机械方程半隐式；仅PMSM，其余模型按RK4
+};
+
+// 积分器配置
+struct integrator_config_t {
+    e_integrator method = e_integrator::EULER;
+    double rtol         = 1e-6;     // 相对误差容限（RK45）
+    double atol         = 1e-8;     // 绝对误差容限（RK45）
+    double h_max        = 0.0;      // 最大子步长 (s)，0表示不限制（RK4按此拆分子步）
+    double h_min        = 1e-9;     // 最小子步长 (s)（RK45）
+    int max_substeps    = 100000;   // 单次step最大子步数（RK45）
+    double zoh_omega_tol = 1.0;     // ZOH离散矩阵的电角速度量化间隔 (rad/s)，跨格时重新计算，≤0表示每步计算（ZOH）
+};
+
+// 积分器统计（自上次reset起累计）
+struct integrator_stats_t {
+    long long accepted  = 0;        // 接受的子步数
+    long long rejected  = 0;        // 被拒绝的子步数（RK45）
+    long long rhs_evals = 0;        // 微分方程右端求值次数
+    long long discretizations = 0;  // ZOH离散矩阵计算次数
+    long long failed    = 0;        // 达到max_substeps、剩余区间按RK4补完的step数（RK45）
+};
+
+// 三角函数计算模式
+enum class e_trig_mode {
+    EXACT,          // 标准库std::sin/std::cos
+    FAST            // 象限约简+多项式（|x|<1e5时绝对误差≤3e-16，见fast_trig.h）
+};
+
+// 控制通路数值类型（见scalar_traits.h；电机模型始终为double）
+enum class e_numeric_type {
+    DOUBLE,         // 双精度（参考实现）
+    FLOAT32,        // 单精度
+    Q31,            // 32位定点，标幺值
+    Q15             // 16位定点，标幺值（积分器Q31累加）
+};
+
+// 逆变器仿真方式
+enum class e_inverter_mode {
+    AVERAGE,        // 平均值模型：PWM周期内按占空比对应的平均电压恒定作用（默认，与原实现一致）
+    SWITCHING       // 开关模型：按七段式开关序列在各开关边沿间推进电机模型，含死区（仅FOC）
+};
+
+// 逆变器配置
+struct inverter_config_t {
+    e_inverter_mode mode = e_inverter_mode::AVERAGE;
+    double dead_time    = 0.0;      // 死区时间 (s)（SWITCHING）
+};
+
+// 逆变器动态状态（仿真检查点保存/恢复用）
+struct inverter_state_t {
+    double duty[3]      = {0.0, 0.0, 0.0};   // 当前PWM周期锁存的三相占空比
+    double period       = 0.0;      // PWM周期 (s)，0表示尚未锁存
+    double tau          = 0.0;      // 周期内时刻 (s)
+};
+
+// 旋转因子：同一电角度的sin/cos，每步计算一次后供Park/逆Park/αβ电流共用
+struct rotation_t {
+    double theta    = 0.0;      // 电角度 (rad)
+    double sin_t    = 0.0;      // sin(theta)
+    double cos_t    = 1.0;      // cos(theta)
+};
+
+// 电机模型动态状态（仿真检查点保存/恢复用；参数、积分方法与统计不在其中）
+struct motor_checkpoint_t {
+    motor_state_t state;
+    rotation_t rotation;
+    double rk45_h = 0.0;        // RK45建议子步长
+};
+
+// 多速率环路调度：各环执行周期 = 分频系数 × 仿真步长
+// 例：dt=10μs时 current_div=5(20kHz)、velocity_div=50(2kHz)、position_div=200(500Hz)
+struct loop_rate_config_t {
+    int current_div     = 1;        // 电流环分频（同时决定PWM占空比更新周期）
+    int velocity_div    = 1;        // 速度环分频
+    int position_div    = 1;        // 位置环分频
+};
+
 // 仿真配置
 struct sim_config_t {
     double dt           = 100e-6;   // 仿真步长 (s): 默认100μs
     double speed_ratio  = 1.0;      // 仿真速度倍率
+    integrator_config_t integrator; // 电机模型积分方法
+    loop_rate_config_t loop_rates;  // 三环执行分频
+    e_trig_mode trig_mode = e_trig_mode::EXACT;   // 三角函数计算模式
+    inverter_config_t inverter;     // 逆变器仿真方式
+    int checkpoint_interval = 1000; // 检查点间隔（步），0表示关闭检查点与单步后退
+    int checkpoint_count    = 256;  // 保留的检查点个数（超出时覆盖最旧）
     bool running        = false;
     bool single_step    = false;
 };
@@ -109,8 +204,16 @@ struct svpwm_output_t {
     double tb       = 0.0;      // b相占空比
     double tc       = 0.0;      // c相占空比
     int sector      = 1;        // 当前扇区(1-6)
-    double mag      = 0.0;      // 矢量幅值
-    double angle    = 0.0;      // 矢量角度 (rad)
+    double mag      = 0.0;      // 矢量幅值（仅在发布快照时计算，逐步采样中为上次快照值）
+    double angle    = 0.0;      // 矢量角度 (rad)（同上）
+};
+
+// 仿真采样点（每个仿真步产生一个，经环形缓冲送往波形窗口）
+struct sim_sample_t {
+    double t = 0.0;             // 仿真时间 (s)
+    motor_state_t state;        // 电机状态
+    svpwm_output_t svpwm;       // SVPWM输出
+    control_target_t ref;       // 控制器内部参考值
 };
 
 // 常量定义
@@ -0,0 +1,105 @@
+#include "frame_scheduler.h"
+#include <QGuiApplication>
+#include <QScreen>
+#include <algorithm>
+#include <cmath>
+
+frame_scheduler::frame_scheduler(sim_engine* engine, QObject* parent)
+    : QObject(parent), m_engine(engine) {
+    m_timer = new QTimer(this);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    m_timer->setInterval(16);
+    connect(m_timer, &QTimer::timeout, this, &frame_scheduler::flush);
+    use_engine();
+}
+
+void frame_scheduler::add_view(QWidget* owner, snapshot_fn fn) {
+    m_views.push_back({owner, std::move(fn), 0});
+}
+
+void frame_scheduler::add_sample_sink(sample_sink_fn fn) {
+    m_sinks.push_back(std::move(fn));
+}
+
+void frame_scheduler::set_source(snapshot_source_fn snapshot, samples_source_fn samples) {
+    m_snapshot_source = std::move(snapshot);
+    m_samples_source = std::move(samples);
+    // 新数据源的步数/时间与旧数据源无关，强制全部视图刷新
+    m_last_step = -1;
+    m_last_time = -1.0;
+    ++m_version;
+}
+
+void frame_scheduler::use_engine() {
+    if (!m_engine) {
+        set_source(nullptr, nullptr);
+        return;
+    }
+    sim_engine* engine = m_engine;
+    set_source([engine]() { return engine->get_snapshot(); },
+               [engine](std::vector<sim_sample_t>& out) {
+                   engine->sample_buffer()->drain([&out](const sim_sample_t& s) { out.push_back(s); });
+               });
+}
+
+void frame_scheduler::add_frame_task(task_fn fn) {
+    m_tasks.push_back(std::move(fn));
+}
+
+void frame_scheduler::start() {
+    // 帧间隔跟随主屏刷新率（取不到时按60Hz），限制在[4, 50]ms
+    int interval_ms = 16;
+    if (QScreen* screen = QGuiApplication::primaryScreen()) {
+        double hz = screen->refreshRate();
+        if (hz > 1.0) {
+            interval_ms = std::clamp(static_cast<int>(std::lround(1000.0 / hz)), 4, 50);
+        }
+    }
+    m_timer->setInterval(interval_ms);
+    m_timer->start();
+}
+
+void frame_scheduler::stop() {
+    m_timer->stop();
+}
+
+void frame_scheduler::invalidate() {
+    ++m_version;
+}
+
+bool frame_scheduler::is_on_screen(const QWidget* widget) {
+    if (!widget || !widget->isVisible()) return false;
+    const QWidget* win = widget->window();
+    if (win && (win->windowState() & Qt::WindowMinimized)) return false;
+    return !widget->visibleRegion().isEmpty();
+}
+
+void frame_scheduler::flush() {
+    // 逐步采样：无论窗口是否可见都取出，由各消费者自行决定是否使用
+    m_frame_samples.clear();
+    if (m_samples_source) m_samples_source(m_frame_samples);
+    if (!m_frame_samples.empty()) {
+        for (auto& sink : m_sinks) {
+            sink(m_frame_samples.data(), m_frame_samples.size());
+        }
+    }
+
+    if (m_snapshot_source) {
+        // 单次加锁取快照；仿真未推进时所有视图保持不变
+        const sim_snapshot_t snap = m_snapshot_source();
+        if (snap.step_index != m_last_step || snap.sim_time != m_last_time) {
+            m_last_step = snap.step_index;
+            m_last_time = snap.sim_time;
+            ++m_version;
+        }
+        for (auto& view : m_views) {
+            if (view.shown_version == m_version) continue;
+            if (!is_on_screen(view.owner)) continue;
+            view.fn(snap);
+            view.shown_version = m_version;
+        }
+    }
+    for (auto& task : m_tasks) {
+        task();
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef UI_FRAME_SCHEDULER_H
+#define UI_FRAME_SCHEDULER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QWidget>
+#include <functional>
+#include <vector>
+#include "core/sim_engine.h"
+
+// UI帧调度器
+// 界面刷新与仿真信号发射解耦：每个显示刷新周期执行一次flush
+// - 主动读取sim_engine最新快照，快照未变化时不刷新任何面板
+// - 每个注册的视图独立记录已显示的快照版本（脏标记），只刷新落后的视图
+// - 视图不可见（隐藏的选项卡页、被关闭或最小化的窗口）时跳过，保持脏标记，重新可见后下一帧补刷新
+// - 每帧先取出数据源的逐步采样交给采样消费者（波形、轨迹录制），再刷新快照视图，最后执行每帧任务
+// - 数据源默认为sim_engine，可切换为轨迹回放等其他来源
+class frame_scheduler : public QObject {
+    Q_OBJECT
+public:
+    using snapshot_fn = std::function<void(const sim_snapshot_t&)>;
+    using task_fn = std::function<void()>;
+    using sample_sink_fn = std::function<void(const sim_sample_t* samples, size_t count)>;
+    using snapshot_source_fn = std::function<sim_snapshot_t()>;
+    using samples_source_fn = std::function<void(std::vector<sim_sample_t>& out)>;
+
+    explicit frame_scheduler(sim_engine* engine, QObject* parent = nullptr);
+
+    // 注册快照视图：owner可见且快照有更新时调用fn
+    void add_view(QWidget* owner, snapshot_fn fn);
+
+    // 注册采样消费者：每帧以本帧取出的全部逐步采样调用一次（无采样时不调用）
+    void add_sample_sink(sample_sink_fn fn);
+
+    // 切换数据源：snapshot提供当前快照，samples追加本帧新增采样
+    void set_source(snapshot_source_fn snapshot, samples_source_fn samples);
+    // 恢复以sim_engine为数据源
+    void use_engine();
+
+    // 注册每帧任务（无论快照是否变化都执行，可见性由任务自行判断）
+    void add_frame_task(task_fn fn);
+
+    // 按主屏刷新率启动/停止帧定时器
+    void start();
+    void stop();
+
+    // 标记全部视图为脏（配置变化等快照版本不变但需要重绘的场景）
+    void invalidate();
+
+    // 控件当前是否实际显示在屏幕上
+    static bool is_on_screen(const QWidget* widget);
+
+public slots:
+    // 执行一帧刷新
+    void flush();
+
+private:
+    struct view_t {
+        QPointer<QWidget> owner;
+        snapshot_fn fn;
+        quint64 shown_version = 0;      // 已显示的快照版本，0表示从未显示
+    };
+
+    sim_engine* m_engine = nullptr;
+    QTimer* m_timer = nullptr;
+    std::vector<view_t> m_views;
+    std::vector<task_fn> m_tasks;
+    std::vector<sample_sink_fn> m_sinks;
+
+    snapshot_source_fn m_snapshot_source;
+    samples_source_fn m_samples_source;
+    std::vector<sim_sample_t> m_frame_samples;      // 本帧采样（内存复用）
+
+    // 快照版本：检测到新快照（步数或仿真时间变化）或invalidate时递增
+    quint64 m_version = 1;
+    int m_last_step = -1;
+    double m_last_time = -1.0;
+};
+
+#endif // UI_FRAME_SCHEDULER_H
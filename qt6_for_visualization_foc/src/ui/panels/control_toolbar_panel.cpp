@@ -3,6 +3,7 @@
 #include <QHBoxLayout>
 #include <QGroupBox>
 #include <QFileDialog>
+#include <QSignalBlocker>
 
 control_toolbar_panel::control_toolbar_panel(QWidget* parent) : QWidget(parent) {
     setup_ui();
@@ -23,6 +24,11 @@ void control_toolbar_panel::setup_ui() {
     connect(m_btn_run, &QPushButton::clicked, this, &control_toolbar_panel::on_run_clicked);
     run_layout->addWidget(m_btn_run);
     
+    m_btn_step_back = new QPushButton("⏮ 后退", run_group);
+    m_btn_step_back->setToolTip("从最近的检查点恢复并后退一步");
+    connect(m_btn_step_back, &QPushButton::clicked, this, &control_toolbar_panel::on_step_back_clicked);
+    run_layout->addWidget(m_btn_step_back);
+    
     m_btn_step = new QPushButton("⏭ 单步", run_group);
     connect(m_btn_step, &QPushButton::clicked, this, &control_toolbar_panel::on_step_clicked);
     run_layout->addWidget(m_btn_step);
@@ -67,10 +73,14 @@ void control_toolbar_panel::setup_ui() {
     speed_layout->setContentsMargins(5, 5, 5, 5);
     
     m_combo_speed = new QComboBox(speed_group);
+    m_combo_speed->addItem("0.1x", 0.1);
+    m_combo_speed->addItem("0.5x", 0.5);
     m_combo_speed->addItem("1x", 1.0);
     m_combo_speed->addItem("2x", 2.0);
     m_combo_speed->addItem("5x", 5.0);
     m_combo_speed->addItem("10x", 10.0);
+    m_combo_speed->addItem("100x", 100.0);
+    m_combo_speed->setCurrentIndex(2);  // 默认1x
     connect(m_combo_speed, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &control_toolbar_panel::on_speed_changed);
     speed_layout->addWidget(m_combo_speed);
@@ -92,6 +102,37 @@ void control_toolbar_panel::setup_ui() {
     
     layout->addWidget(config_group);
     
+    // 轨迹录制/回放
+    auto* traj_group = new QGroupBox("轨迹录制/回放", this);
+    auto* traj_layout = new QVBoxLayout(traj_group);
+    traj_layout->setContentsMargins(5, 5, 5, 5);
+
+    auto* traj_btn_layout = new QHBoxLayout();
+    m_btn_record = new QPushButton("⏺ 录制", traj_group);
+    m_btn_record->setCheckable(true);
+    connect(m_btn_record, &QPushButton::clicked, this, &control_toolbar_panel::on_record_clicked);
+    traj_btn_layout->addWidget(m_btn_record);
+
+    m_btn_replay = new QPushButton("📼 回放", traj_group);
+    m_btn_replay->setCheckable(true);
+    connect(m_btn_replay, &QPushButton::clicked, this, &control_toolbar_panel::on_replay_clicked);
+    traj_btn_layout->addWidget(m_btn_replay);
+    traj_layout->addLayout(traj_btn_layout);
+
+    m_slider_seek = new QSlider(Qt::Horizontal, traj_group);
+    m_slider_seek->setRange(0, 1000);
+    m_slider_seek->setEnabled(false);
+    connect(m_slider_seek, &QSlider::valueChanged, this, [this](int value) {
+        emit seek_requested(value / 1000.0);
+    });
+    traj_layout->addWidget(m_slider_seek);
+
+    m_label_replay_time = new QLabel("--", traj_group);
+    m_label_replay_time->setAlignment(Qt::AlignCenter);
+    traj_layout->addWidget(m_label_replay_time);
+
+    layout->addWidget(traj_group);
+
     // 窗口开关按钮组
     auto* window_group = new QGroupBox("窗口管理", this);
     auto* window_layout = new QVBoxLayout(window_group);
@@ -131,6 +172,11 @@ void control_toolbar_panel::on_step_clicked() {
     emit step_requested();
 }
 
+void control_toolbar_panel::on_step_back_clicked() {
+    m_label_status->setText("单步后退");
+    emit step_back_requested();
+}
+
 void control_toolbar_panel::on_reset_clicked() {
     m_running = false;
     m_btn_run->setChecked(false);
@@ -176,3 +222,65 @@ void control_toolbar_panel::on_toggle_algo_clicked() {
 void control_toolbar_panel::on_toggle_wave_clicked() {
     emit toggle_wave_window();
 }
+
+void control_toolbar_panel::set_running(bool running) {
+    m_running = running;
+    m_btn_run->setChecked(running);
+    m_btn_run->setText(running ? "⏸ 暂停" : "▶ 运行");
+}
+
+void control_toolbar_panel::set_recording(bool recording) {
+    m_btn_record->setChecked(recording);
+}
+
+void control_toolbar_panel::stop_recording(const QString& reason) {
+    m_btn_record->setChecked(false);
+    m_label_status->setText(reason);
+}
+
+void control_toolbar_panel::set_replay_active(bool active) {
+    m_btn_replay->setChecked(active);
+    m_slider_seek->setEnabled(active);
+    if (!active) m_label_replay_time->setText("--");
+    set_running(false);
+}
+
+void control_toolbar_panel::set_replay_progress(double fraction, double time) {
+    const QSignalBlocker blocker(m_slider_seek);
+    m_slider_seek->setValue(static_cast<int>(fraction * 1000.0 + 0.5));
+    m_label_replay_time->setText(QString("t = %1 s").arg(time, 0, 'f', 4));
+}
+
+void control_toolbar_panel::on_record_clicked(bool checked) {
+    if (!checked) {
+        emit record_stop_requested();
+        m_label_status->setText("录制已停止");
+        return;
+    }
+    QString path = QFileDialog::getSaveFileName(this, "录制轨迹文件",
+                                                QString(), "轨迹文件 (*.foctrj)");
+    if (path.isEmpty()) {
+        m_btn_record->setChecked(false);
+        return;
+    }
+    emit record_start_requested(path);
+    m_label_status->setText("录制中...");
+}
+
+void control_toolbar_panel::on_replay_clicked(bool checked) {
+    if (!checked) {
+        set_replay_active(false);
+        emit replay_stop_requested();
+        m_label_status->setText("回放已退出");
+        return;
+    }
+    QString path = QFileDialog::getOpenFileName(this, "打开轨迹文件",
+                                                QString(), "轨迹文件 (*.foctrj)");
+    if (path.isEmpty()) {
+        m_btn_replay->setChecked(false);
+        return;
+    }
+    set_replay_active(true);
+    emit replay_start_requested(path);
+    m_label_status->setText("回放模式");
+}
@@ -5,6 +5,7 @@
 #include <QPushButton>
 #include <QComboBox>
 #include <QLabel>
+#include <QSlider>
 
 // 控制工具栏面板
 // 包含运行控制按钮、电机类型选择、控制模式选择、仿真速度等
@@ -16,6 +17,20 @@ public:
     // 获取运行状态
     bool is_running() const { return m_running; }
 
+    // 同步运行按钮状态（不发出信号，如回放播放到末尾自动停止）
+    void set_running(bool running);
+
+    // 同步录制/回放按钮状态（不发出信号，如打开文件失败时复位）
+    void set_recording(bool recording);
+    void set_replay_active(bool active);
+
+    // 录制被动结束（复位、时间回退、采样丢失），在状态栏显示原因
+    void stop_recording(const QString& reason);
+
+public slots:
+    // 更新回放进度条与时间显示（不触发跳转）
+    void set_replay_progress(double fraction, double time);
+
 signals:
     // 运行状态变化
     void run_state_changed(bool running);
@@ -23,6 +38,8 @@ signals:
     void reset_requested();
     // 单步请求
     void step_requested();
+    // 单步后退请求
+    void step_back_requested();
     // 电机类型变化 (0=PMSM, 1=BLDC)
     void motor_type_changed(int type);
     // 控制模式变化 (0=FOC, 1=六步换向)
@@ -37,10 +54,19 @@ signals:
     void toggle_algo_window();
     // 波形窗口开关
     void toggle_wave_window();
+    // 开始/停止录制轨迹
+    void record_start_requested(const QString& path);
+    void record_stop_requested();
+    // 开始/停止回放轨迹
+    void replay_start_requested(const QString& path);
+    void replay_stop_requested();
+    // 回放跳转（进度比例 [0, 1]）
+    void seek_requested(double fraction);
 
 private slots:
     void on_run_clicked();
     void on_step_clicked();
+    void on_step_back_clicked();
     void on_reset_clicked();
     void on_motor_type_changed(int index);
     void on_control_mode_changed(int index);
@@ -49,6 +75,8 @@ private slots:
     void on_reset_config_clicked();
     void on_toggle_algo_clicked();
     void on_toggle_wave_clicked();
+    void on_record_clicked(bool checked);
+    void on_replay_clicked(bool checked);
 
 private:
     void setup_ui();
@@ -56,6 +84,7 @@ private:
 private:
     QPushButton* m_btn_run = nullptr;
     QPushButton* m_btn_step = nullptr;
+    QPushButton* m_btn_step_back = nullptr;
     QPushButton* m_btn_reset = nullptr;
     QComboBox* m_combo_motor = nullptr;
     QComboBox* m_combo_mode = nullptr;
@@ -64,6 +93,10 @@ private:
     QPushButton* m_btn_reset_config = nullptr;
     QPushButton* m_btn_toggle_algo = nullptr;
     QPushButton* m_btn_toggle_wave = nullptr;
+    QPushButton* m_btn_record = nullptr;
+    QPushButton* m_btn_replay = nullptr;
+    QSlider* m_slider_seek = nullptr;
+    QLabel* m_label_replay_time = nullptr;
     QLabel* m_label_status = nullptr;
     bool m_running = false;
 };
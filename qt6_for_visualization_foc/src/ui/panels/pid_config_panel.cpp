@@ -2,7 +2,8 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
-#include <QLabel>
+#include <QFileDialog>
+#include <cmath>
 
 pid_config_panel::pid_config_panel(QWidget* parent) : QWidget(parent) {
     setup_ui();
@@ -17,6 +18,7 @@ void pid_config_panel::setup_ui() {
     layout->addWidget(create_current_group());
     layout->addWidget(create_velocity_group());
     layout->addWidget(create_position_group());
+    layout->addWidget(create_tune_group());
     layout->addStretch();
 }
 
@@ -157,6 +159,105 @@ QGroupBox* pid_config_panel::create_position_group() {
     return group;
 }
 
+QGroupBox* pid_config_panel::create_tune_group() {
+    auto* group = new QGroupBox("自动整定", this);
+    auto* layout = new QGridLayout(group);
+    layout->setContentsMargins(5, 5, 5, 5);
+
+    // 整定的环
+    layout->addWidget(new QLabel("环路:", group), 0, 0);
+    m_combo_tune_loop = new QComboBox(group);
+    m_combo_tune_loop->addItems({"电流环", "速度环", "位置环", "级联(由内到外)"});
+    m_combo_tune_loop->setCurrentIndex(1);
+    layout->addWidget(m_combo_tune_loop, 0, 1);
+
+    // 代价函数
+    layout->addWidget(new QLabel("代价:", group), 1, 0);
+    m_combo_tune_cost = new QComboBox(group);
+    m_combo_tune_cost->addItems({"误差平方积分", "超调量", "调节时间"});
+    layout->addWidget(m_combo_tune_cost, 1, 1);
+
+    // 开始/停止
+    m_btn_tune = new QPushButton("开始整定", group);
+    connect(m_btn_tune, &QPushButton::clicked, this, &pid_config_panel::on_tune_clicked);
+    layout->addWidget(m_btn_tune, 2, 0, 1, 2);
+
+    // 应用/导出整定结果
+    m_btn_tune_apply = new QPushButton("应用", group);
+    m_btn_tune_apply->setEnabled(false);
+    connect(m_btn_tune_apply, &QPushButton::clicked, this, &pid_config_panel::tune_apply_requested);
+    layout->addWidget(m_btn_tune_apply, 3, 0);
+    m_btn_tune_export = new QPushButton("导出配置", group);
+    m_btn_tune_export->setEnabled(false);
+    connect(m_btn_tune_export, &QPushButton::clicked, this, &pid_config_panel::on_tune_export_clicked);
+    layout->addWidget(m_btn_tune_export, 3, 1);
+
+    m_label_tune_status = new QLabel("就绪", group);
+    m_label_tune_status->setWordWrap(true);
+    layout->addWidget(m_label_tune_status, 4, 0, 1, 2);
+
+    return group;
+}
+
+// 回填数值：按需扩展范围并增加小数位（至多4位），避免整定结果被截断
+static void set_spin_value(QDoubleSpinBox* spin, double val) {
+    if (val > spin->maximum()) spin->setMaximum(std::ceil(val * 2.0));
+    int decimals = spin->decimals();
+    while (decimals < 4 && val != 0.0 && std::abs(val) < 100.0 * std::pow(10.0, -decimals)) {
+        ++decimals;
+    }
+    spin->setDecimals(decimals);
+    spin->setValue(val);
+}
+
+void pid_config_panel::set_current_pid(double kp, double ki) {
+    set_spin_value(m_spin_current_kp, kp);
+    set_spin_value(m_spin_current_ki, ki);
+}
+
+void pid_config_panel::set_velocity_pid(double kp, double ki) {
+    set_spin_value(m_spin_velocity_kp, kp);
+    set_spin_value(m_spin_velocity_ki, ki);
+}
+
+void pid_config_panel::set_position_pid(double kp, double ki, double kd) {
+    set_spin_value(m_spin_position_kp, kp);
+    set_spin_value(m_spin_position_ki, ki);
+    set_spin_value(m_spin_position_kd, kd);
+}
+
+void pid_config_panel::set_tune_running(bool running) {
+    m_tune_running = running;
+    m_btn_tune->setText(running ? "停止整定" : "开始整定");
+    m_combo_tune_loop->setEnabled(!running);
+    m_combo_tune_cost->setEnabled(!running);
+}
+
+void pid_config_panel::set_tune_status(const QString& text) {
+    m_label_tune_status->setText(text);
+}
+
+void pid_config_panel::set_tune_result_available(bool available) {
+    m_btn_tune_apply->setEnabled(available);
+    m_btn_tune_export->setEnabled(available);
+}
+
+void pid_config_panel::on_tune_clicked() {
+    if (m_tune_running) {
+        emit tune_cancel_requested();
+        return;
+    }
+    emit auto_tune_requested(m_combo_tune_loop->currentIndex(), m_combo_tune_cost->currentIndex());
+}
+
+void pid_config_panel::on_tune_export_clicked() {
+    QString path = QFileDialog::getSaveFileName(this, "导出整定配置",
+                                                QString(), "JSON文件 (*.json)");
+    if (!path.isEmpty()) {
+        emit tune_export_requested(path);
+    }
+}
+
 bool pid_config_panel::is_current_enabled() const {
     return m_check_current_enable && m_check_current_enable->isChecked();
 }
@@ -6,6 +6,9 @@
 #include <QSlider>
 #include <QDoubleSpinBox>
 #include <QCheckBox>
+#include <QComboBox>
+#include <QPushButton>
+#include <QLabel>
 
 // 三环PID参数配置面板
 // 集中管理电流环、速度环、位置环的PID参数和使能状态
@@ -19,6 +22,17 @@ public:
     bool is_velocity_enabled() const;
     bool is_position_enabled() const;
 
+    // 设置PID参数（整定结果回填，经各自的参数变化信号下发到控制器）
+    // 超出输入框范围时扩展范围，精度不足时增加小数位
+    void set_current_pid(double kp, double ki);
+    void set_velocity_pid(double kp, double ki);
+    void set_position_pid(double kp, double ki, double kd);
+
+    // 自动整定状态
+    void set_tune_running(bool running);
+    void set_tune_status(const QString& text);
+    void set_tune_result_available(bool available);
+
 signals:
     // 电流环PID参数变化
     void current_pid_changed(double kp, double ki);
@@ -36,6 +50,12 @@ signals:
     void position_enabled_changed(bool enabled);
     // 环路预设变化（用于框图联动）
     void loop_preset_changed(const QString& preset);
+    // 自动整定：loop为0电流环/1速度环/2位置环/3级联，cost与e_tune_cost顺序一致
+    void auto_tune_requested(int loop, int cost);
+    void tune_cancel_requested();
+    // 整定结果应用到控制器 / 导出为配置文件
+    void tune_apply_requested();
+    void tune_export_requested(const QString& path);
 
 private slots:
     // 电流环参数槽
@@ -55,12 +75,16 @@ private slots:
     void on_position_enable_changed(int state);
     // 更新环路预设
     void update_loop_preset();
+    // 自动整定按钮槽
+    void on_tune_clicked();
+    void on_tune_export_clicked();
 
 private:
     void setup_ui();
     QGroupBox* create_current_group();
     QGroupBox* create_velocity_group();
     QGroupBox* create_position_group();
+    QGroupBox* create_tune_group();
 
 private:
     // 电流环控件
@@ -80,6 +104,15 @@ private:
     QDoubleSpinBox* m_spin_position_kd = nullptr;
     QDoubleSpinBox* m_spin_position_target = nullptr;
     QCheckBox* m_check_position_enable = nullptr;
+
+    // 自动整定控件
+    QComboBox* m_combo_tune_loop = nullptr;
+    QComboBox* m_combo_tune_cost = nullptr;
+    QPushButton* m_btn_tune = nullptr;
+    QPushButton* m_btn_tune_apply = nullptr;
+    QPushButton* m_btn_tune_export = nullptr;
+    QLabel* m_label_tune_status = nullptr;
+    bool m_tune_running = false;
 };
 
 #endif // UI_PID_CONFIG_PANEL_H
@@ -1,13 +1,58 @@
 #include "waveform_window.h"
+#include "frame_scheduler.h"
 #include "widgets/waveform_view.h"
 #include "widgets/resizable_group.h"
+#include "core/types.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 
+// 每个波形保留的采样点数（采样点逐仿真步写入）
+static constexpr size_t WAVE_HISTORY_POINTS = 10000;
+
 waveform_window::waveform_window(QWidget* parent) : QMainWindow(parent) {
     setup_ui();
 }
 
+void waveform_window::append_samples(const sim_sample_t* samples, size_t count) {
+    // 窗口关闭或最小化时不更新波形
+    if (!frame_scheduler::is_on_screen(this)) return;
+    // 先按波形收集本帧全部采样，再逐个波形批量写入：每个波形每帧只写入一次、重绘一次
+    // 波形只保留最近history_points()个点，更早的采样写入后即被覆盖，直接跳过
+    if (count > WAVE_HISTORY_POINTS) {
+        samples += count - WAVE_HISTORY_POINTS;
+        count = WAVE_HISTORY_POINTS;
+    }
+    for (auto& batch : m_batches) batch.frames.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const sim_sample_t& s = samples[i];
+        const motor_state_t& st = s.state;
+        append_frame(BATCH_I_ABC, {st.ia, st.ib, st.ic});
+        append_frame(BATCH_I_AB, {st.i_alpha, st.i_beta});
+        append_frame(BATCH_ID_IQ, {st.id, st.iq});
+        append_frame(BATCH_I_REF, {s.ref.id_ref, s.ref.iq_ref});
+        append_frame(BATCH_UD_UQ, {st.ud, st.uq});
+        append_frame(BATCH_U_AB, {st.u_alpha, st.u_beta});
+        append_frame(BATCH_U_ABC, {st.ua, st.ub, st.uc});
+        append_frame(BATCH_PWM, {s.svpwm.ta, s.svpwm.tb, s.svpwm.tc});
+        append_frame(BATCH_VEL, {s.ref.vel_ref, st.omega_m});
+        append_frame(BATCH_POS, {s.ref.pos_ref, st.theta_m});
+    }
+    for (auto& batch : m_batches) {
+        if (!batch.view || batch.view->channel_count() == 0 || batch.frames.empty()) continue;
+        batch.view->add_frames(batch.frames.data(), batch.frames.size() / batch.view->channel_count());
+    }
+}
+
+void waveform_window::clear_waveforms() {
+    for (auto& batch : m_batches) {
+        if (batch.view) batch.view->clear();
+    }
+}
+
+size_t waveform_window::history_points() {
+    return WAVE_HISTORY_POINTS;
+}
+
 void waveform_window::setup_ui() {
     setWindowTitle("FOC波形显示");
     setMinimumSize(800, 900);
@@ -127,6 +172,22 @@ void waveform_window::setup_ui() {
     
     layout->addStretch();
     m_scroll_area->setWidget(m_content);
+
+    for (auto* view : {m_wave_ud_uq, m_wave_id_iq, m_wave_i_ref, m_wave_vel, m_wave_pos,
+                       m_wave_u_ab, m_wave_i_ab, m_wave_u_abc, m_wave_i_abc, m_wave_pwm}) {
+        view->set_max_points(WAVE_HISTORY_POINTS);
+    }
+
+    m_batches[BATCH_I_ABC].view = m_wave_i_abc;
+    m_batches[BATCH_I_AB].view = m_wave_i_ab;
+    m_batches[BATCH_ID_IQ].view = m_wave_id_iq;
+    m_batches[BATCH_I_REF].view = m_wave_i_ref;
+    m_batches[BATCH_UD_UQ].view = m_wave_ud_uq;
+    m_batches[BATCH_U_AB].view = m_wave_u_ab;
+    m_batches[BATCH_U_ABC].view = m_wave_u_abc;
+    m_batches[BATCH_PWM].view = m_wave_pwm;
+    m_batches[BATCH_VEL].view = m_wave_vel;
+    m_batches[BATCH_POS].view = m_wave_pos;
 }
 
 void waveform_window::update_currents(double ia, double ib, double ic,
@@ -3,9 +3,13 @@
 
 #include <QMainWindow>
 #include <QScrollArea>
+#include <array>
+#include <initializer_list>
+#include <vector>
 
 class waveform_view;
 class resizable_group;
+struct sim_sample_t;
 
 // 波形显示窗口
 // 显示FOC算法相关的所有波形数据
@@ -15,6 +19,15 @@ public:
     explicit waveform_window(QWidget* parent = nullptr);
     ~waveform_window() override = default;
 
+    // 写入一批逐步采样（由frame_scheduler每帧调用；窗口不可见时直接丢弃）
+    void append_samples(const sim_sample_t* samples, size_t count);
+
+    // 清空全部波形（切换数据源/回放跳转时调用）
+    void clear_waveforms();
+
+    // 每个波形保留的采样点数
+    static size_t history_points();
+
 public slots:
     // 更新电流波形
     void update_currents(double ia, double ib, double ic,
@@ -39,7 +52,28 @@ public slots:
 private:
     void setup_ui();
 
+    // 批量写入暂存下标
+    enum e_wave_batch {
+        BATCH_I_ABC, BATCH_I_AB, BATCH_ID_IQ, BATCH_I_REF,
+        BATCH_UD_UQ, BATCH_U_AB, BATCH_U_ABC,
+        BATCH_PWM, BATCH_VEL, BATCH_POS,
+        BATCH_COUNT
+    };
+
+    // 单个波形的批量写入暂存：按帧交错收集，结束后一次性写入波形（内存复用）
+    struct wave_batch_t {
+        waveform_view* view = nullptr;
+        std::vector<double> frames;
+    };
+
+    void append_frame(e_wave_batch batch, std::initializer_list<double> values) {
+        auto& frames = m_batches[batch].frames;
+        frames.insert(frames.end(), values);
+    }
+
 private:
+    std::array<wave_batch_t, BATCH_COUNT> m_batches;
+
     QScrollArea* m_scroll_area = nullptr;
     QWidget* m_content = nullptr;
     
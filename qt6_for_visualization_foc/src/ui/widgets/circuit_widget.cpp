@@ -11,6 +11,11 @@ void circuit_widget::paintEvent(QPaintEvent* event)
 {
     Q_UNUSED(event);
     QPainter painter(this);
+    m_background.paint(painter, this, [this](QPainter& lp) { draw_static(lp); });
+}
+
+void circuit_widget::draw_static(QPainter& painter)
+{
     painter.setRenderHint(QPainter::Antialiasing);
     
     int cx = width() / 2;
@@ -2,6 +2,7 @@
 #define UI_WIDGETS_CIRCUIT_WIDGET_H
 
 #include <QWidget>
+#include "static_layer.h"
 
 // 电机等效电路图绘制控件
 class circuit_widget : public QWidget {
@@ -11,6 +12,12 @@ public:
 
 protected:
     void paintEvent(QPaintEvent* event) override;
+
+private:
+    // 图形内容全部静态，绘制一次后缓存，尺寸变化时重建
+    void draw_static(QPainter& painter);
+
+    static_layer m_background;
 };
 
 #endif // UI_WIDGETS_CIRCUIT_WIDGET_H
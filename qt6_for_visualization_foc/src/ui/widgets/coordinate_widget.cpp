@@ -12,6 +12,11 @@ void coordinate_widget::paintEvent(QPaintEvent* event)
 {
     Q_UNUSED(event);
     QPainter painter(this);
+    m_background.paint(painter, this, [this](QPainter& lp) { draw_static(lp); });
+}
+
+void coordinate_widget::draw_static(QPainter& painter)
+{
     painter.setRenderHint(QPainter::Antialiasing);
     
     int w = width();
@@ -12,6 +12,11 @@ void hexagon_widget::paintEvent(QPaintEvent* event)
 {
     Q_UNUSED(event);
     QPainter painter(this);
+    m_background.paint(painter, this, [this](QPainter& lp) { draw_static(lp); });
+}
+
+void hexagon_widget::draw_static(QPainter& painter)
+{
     painter.setRenderHint(QPainter::Antialiasing);
     
     int cx = width() / 2;
@@ -21,6 +21,7 @@ void rotor_animator::set_pole_pairs(int pairs) {
 
 void rotor_animator::set_show_stator(bool show) {
     m_show_stator = show;
+    m_background.invalidate();
     update();
 }
 
@@ -52,12 +53,15 @@ void rotor_animator::draw_stator(QPainter& p, int cx, int cy, int r_stator, int
     }
 }
 
-// 绘制转子和磁极
-void rotor_animator::draw_rotor(QPainter& p, int cx, int cy, int r_rotor, int r_shaft) {
+// 绘制转子铁芯
+void rotor_animator::draw_rotor_core(QPainter& p, int cx, int cy, int r_rotor) {
     p.setPen(QPen(QColor(60, 60, 60), 2));
     p.setBrush(QColor(200, 200, 200));
     p.drawEllipse(QPoint(cx, cy), r_rotor, r_rotor);
-    
+}
+
+// 绘制磁极和转轴
+void rotor_animator::draw_rotor(QPainter& p, int cx, int cy, int r_rotor, int r_shaft) {
     int num_poles = m_pole_pairs * 2;
     for (int i = 0; i < num_poles; ++i) {
         double pole_angle = m_angle + i * 2 * M_PI / num_poles;
@@ -112,7 +116,12 @@ void rotor_animator::paintEvent(QPaintEvent* event) {
     int cx = width() / 2, cy = height() / 2 + 5;
     int r_stator = size / 2, r_rotor = size * 3 / 8, r_shaft = size / 10;
     
-    draw_stator(p, cx, cy, r_stator, r_rotor);
+    // 定子与转子铁芯不随角度变化，缓存为静态层
+    m_background.paint(p, this, [&](QPainter& lp) {
+        lp.setRenderHint(QPainter::Antialiasing);
+        draw_stator(lp, cx, cy, r_stator, r_rotor);
+        draw_rotor_core(lp, cx, cy, r_rotor);
+    });
     draw_rotor(p, cx, cy, r_rotor, r_shaft);
     draw_arrow_and_labels(p, cx, cy, r_rotor, height());
 }
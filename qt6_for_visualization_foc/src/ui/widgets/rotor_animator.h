@@ -2,6 +2,7 @@
 #define UI_WIDGETS_ROTOR_ANIMATOR_H
 
 #include <QWidget>
+#include "static_layer.h"
 
 class QPainter;
 
@@ -27,7 +28,10 @@ protected:
     void paintEvent(QPaintEvent* event) override;
 
 private:
+    // 静态层：定子、绕组与转子铁芯
     void draw_stator(QPainter& p, int cx, int cy, int r_stator, int r_rotor);
+    void draw_rotor_core(QPainter& p, int cx, int cy, int r_rotor);
+    // 动态层：随角度变化的磁极、转轴、箭头与标注
     void draw_rotor(QPainter& p, int cx, int cy, int r_rotor, int r_shaft);
     void draw_arrow_and_labels(QPainter& p, int cx, int cy, int r_rotor, int h);
 
@@ -35,6 +39,8 @@ private:
     int m_pole_pairs = 4;
     bool m_show_stator = true;
     bool m_show_angle_label = true;
+
+    static_layer m_background;
 };
 
 #endif // UI_WIDGETS_ROTOR_ANIMATOR_H
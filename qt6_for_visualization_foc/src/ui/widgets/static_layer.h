@@ -0,0 +1,38 @@
+#ifndef UI_WIDGETS_STATIC_LAYER_H
+#define UI_WIDGETS_STATIC_LAYER_H
+
+#include <QPainter>
+#include <QPixmap>
+#include <QWidget>
+
+// 静态图层缓存
+// 将不随数据变化的内容（背景、刻度、图例等）绘制到透明QPixmap，重绘时直接贴图
+// - 控件尺寸或设备像素比变化时自动重建
+// - 内容相关配置变化时由控件调用invalidate()
+class static_layer {
+public:
+    // 标记缓存失效，下次paint时重建
+    void invalidate() { m_valid = false; }
+
+    // 缓存有效则直接贴图，否则先调用draw(QPainter&)重建（坐标系与控件一致）
+    template<typename F>
+    void paint(QPainter& p, const QWidget* widget, F&& draw) {
+        const qreal dpr = widget->devicePixelRatioF();
+        const QSize size = widget->size() * dpr;
+        if (!m_valid || m_pixmap.size() != size || m_pixmap.devicePixelRatio() != dpr) {
+            m_pixmap = QPixmap(size);
+            m_pixmap.setDevicePixelRatio(dpr);
+            m_pixmap.fill(Qt::transparent);
+            QPainter lp(&m_pixmap);
+            draw(lp);
+            m_valid = true;
+        }
+        p.drawPixmap(0, 0, m_pixmap);
+    }
+
+private:
+    QPixmap m_pixmap;
+    bool m_valid = false;
+};
+
+#endif // UI_WIDGETS_STATIC_LAYER_H
@@ -41,18 +41,8 @@ void vector_scope::clear_trail() {
     update();
 }
 
-void vector_scope::paintEvent(QPaintEvent* event) {
-    Q_UNUSED(event);
-    QPainter p(this);
+void vector_scope::draw_background(QPainter& p, int cx, int cy, int r) {
     p.setRenderHint(QPainter::Antialiasing);
-    
-    int w = width();
-    int h = height();
-    int size = qMin(w, h) - 20;  // 留出边距
-    int cx = w / 2;
-    int cy = h / 2;
-    int r = size / 2;
-    
     // 绘制背景圆
     p.setPen(QPen(QColor(200, 200, 200), 1));
     p.setBrush(QColor(250, 250, 250));
@@ -76,6 +66,21 @@ void vector_scope::paintEvent(QPaintEvent* event) {
     p.setFont(font);
     p.drawText(cx + r + 3, cy + 4, "α");
     p.drawText(cx - 4, cy - r - 5, "β");
+}
+
+void vector_scope::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing);
+    
+    int w = width();
+    int h = height();
+    int size = qMin(w, h) - 20;  // 留出边距
+    int cx = w / 2;
+    int cy = h / 2;
+    int r = size / 2;
+    
+    m_background.paint(p, this, [&](QPainter& lp) { draw_background(lp, cx, cy, r); });
     
     // 坐标转换函数（限制在圆内）
     auto to_screen = [&](double alpha, double beta) -> QPointF {
@@ -4,6 +4,7 @@
 #include <QWidget>
 #include <QColor>
 #include <deque>
+#include "static_layer.h"
 
 // αβ坐标系矢量示波器
 class vector_scope : public QWidget {
@@ -30,6 +31,9 @@ protected:
     void paintEvent(QPaintEvent* event) override;
 
 private:
+    // 静态层：背景圆、刻度圆、坐标轴与标签
+    void draw_background(QPainter& p, int cx, int cy, int r);
+
     double m_alpha = 0.0;
     double m_beta = 0.0;
     double m_range = 1.0;  // 坐标轴范围
@@ -37,6 +41,7 @@ private:
     bool m_show_trail = true;  // 是否显示轨迹
     std::deque<std::pair<double, double>> m_trail;  // 历史轨迹
     size_t m_max_trail = 200;  // 最大轨迹点数
+    static_layer m_background;
 };
 
 #endif // UI_WIDGETS_VECTOR_SCOPE_H
@@ -1,6 +1,22 @@
+/**
+ * @file waveform_view.cpp
+ * @brief 多通道波形显示控件
+ *
+ * 长历史数据绘制优化：
+ * - 按像素列做min/max抽取：每列记录首/末/最小/最大值，绘制点数与控件宽度成正比
+ * - 抽取列按采样绝对序号对齐，追加采样时增量更新，重绘无需重新扫描历史
+ * - 自动缩放使用滑动窗口单调队列，O(1)获取窗口极值
+ *
+ * 高频写入优化：
+ * - 采样、极值队列、抽取列均为预分配的定长环形队列，写入不分配内存
+ * - add_frames批量写入交错帧；两次绘制之间最多请求一次重绘
+ *
+ * 分层绘制：背景/网格/刻度与图例缓存为静态层，每次重绘只绘制波形曲线
+ */
 #include "waveform_view.h"
 #include <QPainter>
-#include <QPainterPath>
+#include <QPolygonF>
+#include <QResizeEvent>
 #include <algorithm>
 #include <cmath>
 #include <limits>
@@ -10,40 +26,147 @@ waveform_view::waveform_view(QWidget* parent) : QWidget(parent) {
     setBackgroundRole(QPalette::Base);
     setAutoFillBackground(true);
     // 默认单通道
-    m_channels.push_back({std::deque<double>(), QColor(0, 150, 255), "CH1"});
+    m_channels.resize(1);
+    m_channels[0].color = QColor(0, 150, 255);
+    m_channels[0].name = "CH1";
+    reset_storage(m_channels[0]);
 }
 
 void waveform_view::add_point(double value) {
     if (m_channels.empty()) return;
-    m_channels[0].data.push_back(value);
-    while (m_channels[0].data.size() > m_max_points) {
-        m_channels[0].data.pop_front();
-    }
-    update();
+    push_sample(m_channels[0], value);
+    schedule_repaint();
 }
 
 void waveform_view::add_points(const std::vector<double>& values) {
     for (size_t i = 0; i < values.size() && i < m_channels.size(); ++i) {
-        m_channels[i].data.push_back(values[i]);
-        while (m_channels[i].data.size() > m_max_points) {
-            m_channels[i].data.pop_front();
+        push_sample(m_channels[i], values[i]);
+    }
+    schedule_repaint();
+}
+
+void waveform_view::add_frames(const double* values, size_t frame_count) {
+    const size_t stride = m_channels.size();
+    if (frame_count == 0 || stride == 0) return;
+    // 超出窗口的旧帧不会显示：直接清空并跳过，只推进绝对序号以保持抽取列对齐
+    size_t skip = 0;
+    if (frame_count > m_max_points) {
+        skip = frame_count - m_max_points;
+        for (auto& ch : m_channels) {
+            ch.data.clear();
+            ch.min_q.clear();
+            ch.max_q.clear();
+            ch.columns.clear();
+            ch.next_index += skip;
         }
     }
+    for (size_t c = 0; c < stride; ++c) {
+        channel_data& ch = m_channels[c];
+        const double* v = values + skip * stride + c;
+        for (size_t f = skip; f < frame_count; ++f, v += stride) {
+            push_sample(ch, *v);
+        }
+    }
+    schedule_repaint();
+}
+
+void waveform_view::schedule_repaint() {
+    if (m_repaint_pending) return;
+    m_repaint_pending = true;
     update();
 }
 
+void waveform_view::push_sample(channel_data& ch, double value) {
+    if (m_max_points == 0) return;
+    const uint64_t index = ch.next_index++;
+    // 本次写入后窗口内最旧采样的序号（窗口满时环形队列自动覆盖最旧采样）
+    const uint64_t oldest = ch.next_index - std::min<uint64_t>(ch.data.size() + 1, m_max_points);
+    ch.data.push_back(value);
+
+    // 先淘汰移出窗口的极值，保证队列长度不超过窗口长度
+    while (!ch.max_q.empty() && ch.max_q.front().first < oldest) ch.max_q.pop_front();
+    while (!ch.min_q.empty() && ch.min_q.front().first < oldest) ch.min_q.pop_front();
+    // 单调队列：max_q值递减，min_q值递增，队首即窗口极值
+    while (!ch.max_q.empty() && ch.max_q.back().second <= value) ch.max_q.pop_back();
+    ch.max_q.push_back({index, value});
+    while (!ch.min_q.empty() && ch.min_q.back().second >= value) ch.min_q.pop_back();
+    ch.min_q.push_back({index, value});
+
+    if (m_bucket > 0) {
+        // 整列移出窗口才丢弃；首列部分移出时保留其统计值（最多影响最左一个像素列）
+        while (!ch.columns.empty() && (ch.column_base + 1) * m_bucket <= oldest) {
+            ch.columns.pop_front();
+            ++ch.column_base;
+        }
+        column_append(ch, index, value);
+    }
+}
+
+void waveform_view::column_append(channel_data& ch, uint64_t index, double value) {
+    // 采样序号连续，跨列时列边界累加即可，只有首列需要除法定位
+    if (ch.columns.empty() || index >= ch.column_end) {
+        if (ch.columns.empty()) {
+            ch.column_base = index / m_bucket;
+            ch.column_end = (ch.column_base + 1) * m_bucket;
+        } else {
+            ch.column_end += m_bucket;
+        }
+        ch.columns.push_back({value, value, value, value, true});
+        return;
+    }
+    column_t& c = ch.columns.back();
+    c.last = value;
+    if (value < c.lo) {
+        c.lo = value;
+        c.lo_first = false;
+    }
+    if (value > c.hi) {
+        c.hi = value;
+        c.lo_first = true;
+    }
+    ch.columns.commit_back();
+}
+
+void waveform_view::reset_storage(channel_data& ch) {
+    // 取出窗口内最新的采样，重新分配后按原绝对序号回放
+    const size_t keep = std::min(ch.data.size(), m_max_points);
+    std::vector<double> recent(ch.data.data() + (ch.data.size() - keep),
+                               ch.data.data() + ch.data.size());
+    ch.data.reset(m_max_points);
+    ch.min_q.reset(m_max_points);
+    ch.max_q.reset(m_max_points);
+    // 窗口最多跨越 m_max_points/m_bucket + 2 列（首尾列可能不满）
+    ch.columns.reset(m_bucket > 0 ? m_max_points / m_bucket + 2 : 0);
+    ch.next_index -= keep;
+    for (double v : recent) push_sample(ch, v);
+}
+
+void waveform_view::rebuild_columns() {
+    const size_t cols = static_cast<size_t>(std::max(1, plot_width()));
+    const size_t bucket = (m_max_points > cols * 2) ? (m_max_points + cols - 1) / cols : 0;
+    if (bucket == m_bucket) return;
+    m_bucket = bucket;
+    for (auto& ch : m_channels) reset_storage(ch);
+}
+
 void waveform_view::set_channels(int count, const std::vector<QColor>& colors) {
     m_channels.clear();
+    m_channels.resize(count > 0 ? count : 0);
     for (int i = 0; i < count; ++i) {
-        QColor c = (i < static_cast<int>(colors.size())) ? colors[i] : Qt::blue;
-        m_channels.push_back({std::deque<double>(), c, QString("CH%1").arg(i+1)});
+        channel_data& ch = m_channels[i];
+        ch.color = (i < static_cast<int>(colors.size())) ? colors[i] : QColor(Qt::blue);
+        ch.name = QString("CH%1").arg(i+1);
+        reset_storage(ch);
     }
+    m_legend.invalidate();
 }
 
 void waveform_view::set_channel_names(const std::vector<QString>& names) {
     for (size_t i = 0; i < names.size() && i < m_channels.size(); ++i) {
         m_channels[i].name = names[i];
     }
+    m_legend.invalidate();
+    update();
 }
 
 void waveform_view::set_y_range(double min_val, double max_val) {
@@ -59,14 +182,25 @@ void waveform_view::set_auto_scale(bool enabled) {
 }
 
 void waveform_view::set_max_points(size_t count) {
+    if (count == m_max_points) return;
     m_max_points = count;
+    const size_t old_bucket = m_bucket;
+    rebuild_columns();
+    // 每列采样数未变时rebuild_columns不会重新分配，这里按新容量重建
+    if (m_bucket == old_bucket) {
+        for (auto& ch : m_channels) reset_storage(ch);
+    }
+    schedule_repaint();
 }
 
 void waveform_view::clear() {
     for (auto& ch : m_channels) {
         ch.data.clear();
+        ch.min_q.clear();
+        ch.max_q.clear();
+        ch.columns.clear();
     }
-    update();
+    schedule_repaint();
 }
 
 // 计算Y轴显示范围
@@ -79,11 +213,11 @@ void waveform_view::calc_y_range(double& y_min, double& y_max) const {
     y_min = std::numeric_limits<double>::max();
     y_max = std::numeric_limits<double>::lowest();
     for (const auto& ch : m_channels) {
-        for (double v : ch.data) {
-            y_min = std::min(y_min, v);
-            y_max = std::max(y_max, v);
-        }
+        if (ch.min_q.empty()) continue;
+        y_min = std::min(y_min, ch.min_q.front().second);
+        y_max = std::max(y_max, ch.max_q.front().second);
     }
+    if (y_min > y_max) { y_min = -1.0; y_max = 1.0; }
     if (y_min == y_max) { y_min -= 1.0; y_max += 1.0; }
     double margin = (y_max - y_min) * 0.1;
     y_min -= margin;
@@ -122,21 +256,42 @@ void waveform_view::draw_y_axis(QPainter& p, const QRect& plot, double y_min, do
 }
 
 // 绘制波形曲线
+// 点数不超过像素列数2倍时逐点连线；否则每列输出 首值→极值→极值→末值 四个点，
+// 列内竖线覆盖该列全部采样的范围，尖峰不会因抽取丢失
 void waveform_view::draw_waveforms(QPainter& p, const QRect& plot, double y_min, double y_max) {
-    auto to_screen = [&](size_t idx, double val, size_t total) -> QPointF {
-        double x = plot.left() + (double(idx) / std::max(size_t(1), total - 1)) * plot.width();
-        double y = plot.top() + (1.0 - (val - y_min) / (y_max - y_min)) * plot.height();
-        return QPointF(x, y);
+    auto to_y = [&](double val) -> double {
+        return plot.top() + (1.0 - (val - y_min) / (y_max - y_min)) * plot.height();
     };
+    // 抽取后的折线为逐像素竖线段，关闭抗锯齿
+    p.setRenderHint(QPainter::Antialiasing, m_bucket == 0);
     for (const auto& ch : m_channels) {
-        if (ch.data.size() < 2) continue;
+        const size_t n = ch.data.size();
+        if (n < 2) continue;
+        const double* samples = ch.data.data();
+        const double x_scale = double(plot.width()) / double(n - 1);
+        QPolygonF poly;
+        if (m_bucket == 0) {
+            poly.reserve(static_cast<int>(n));
+            for (size_t i = 0; i < n; ++i) {
+                poly << QPointF(plot.left() + i * x_scale, to_y(samples[i]));
+            }
+        } else {
+            const double first = double(ch.next_index - n);
+            poly.reserve(static_cast<int>(ch.columns.size() * 4));
+            for (size_t k = 0; k < ch.columns.size(); ++k) {
+                const column_t& c = ch.columns[k];
+                double center = double((ch.column_base + k) * m_bucket) + 0.5 * (m_bucket - 1) - first;
+                double x = plot.left() + std::clamp(center, 0.0, double(n - 1)) * x_scale;
+                poly << QPointF(x, to_y(c.first))
+                     << QPointF(x, to_y(c.lo_first ? c.lo : c.hi))
+                     << QPointF(x, to_y(c.lo_first ? c.hi : c.lo))
+                     << QPointF(x, to_y(c.last));
+            }
+        }
         p.setPen(QPen(ch.color, 1.5));
-        QPainterPath path;
-        path.moveTo(to_screen(0, ch.data[0], ch.data.size()));
-        for (size_t i = 1; i < ch.data.size(); ++i)
-            path.lineTo(to_screen(i, ch.data[i], ch.data.size()));
-        p.drawPath(path);
+        p.drawPolyline(poly);
     }
+    p.setRenderHint(QPainter::Antialiasing, true);
 }
 
 // 绘制图例
@@ -151,25 +306,40 @@ void waveform_view::draw_legend(QPainter& p, const QRect& plot) {
     }
 }
 
+void waveform_view::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+    rebuild_columns();
+}
+
 void waveform_view::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
+    m_repaint_pending = false;
     QPainter p(this);
     p.setRenderHint(QPainter::Antialiasing);
     
     // 计算绘图区域
     QRect plot(50, 10, width() - 60, height() - 30);
     
-    // 绘制背景
-    p.fillRect(rect(), QColor(250, 250, 250));
-    p.fillRect(plot, Qt::white);
-    
     // 计算Y轴范围
     double y_min, y_max;
     calc_y_range(y_min, y_max);
     
-    // 分步绘制
-    draw_grid(p, plot);
+    // 背景与网格与Y轴范围无关，缓存为静态层，仅尺寸变化时重绘
+    // （自动缩放时范围几乎每帧变化，刻度文字放在动态层）
+    m_background.paint(p, this, [&](QPainter& lp) {
+        lp.setRenderHint(QPainter::Antialiasing);
+        lp.fillRect(rect(), QColor(250, 250, 250));
+        lp.fillRect(plot, Qt::white);
+        draw_grid(lp, plot);
+    });
+    
+    // 动态层：Y轴刻度与波形曲线
     draw_y_axis(p, plot, y_min, y_max);
     draw_waveforms(p, plot, y_min, y_max);
-    draw_legend(p, plot);
+    
+    // 图例覆盖在波形之上
+    m_legend.paint(p, this, [&](QPainter& lp) {
+        lp.setRenderHint(QPainter::Antialiasing);
+        draw_legend(lp, plot);
+    });
 }
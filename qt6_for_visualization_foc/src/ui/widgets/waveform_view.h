@@ -5,7 +5,10 @@
 #include <QColor>
 #include <QRect>
 #include <vector>
-#include <deque>
+#include <cstdint>
+#include <utility>
+#include "core/ring_buffer.h"
+#include "static_layer.h"
 
 class QPainter;
 
@@ -20,10 +23,17 @@ public:
     
     // 添加多通道数据点
     void add_points(const std::vector<double>& values);
+
+    // 批量添加多通道数据点：values按帧交错排列，每帧依次为各通道的值
+    // 一次调用只安排一次重绘，适合每帧批量写入大量采样
+    void add_frames(const double* values, size_t frame_count);
     
     // 设置通道数和颜色
     void set_channels(int count, const std::vector<QColor>& colors);
     
+    // 通道数
+    size_t channel_count() const { return m_channels.size(); }
+
     // 设置通道名称
     void set_channel_names(const std::vector<QString>& names);
     
@@ -41,6 +51,7 @@ public:
 
 protected:
     void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
 
 private:
     // 绘制辅助方法
@@ -50,18 +61,62 @@ private:
     void draw_waveforms(QPainter& p, const QRect& plot, double y_min, double y_max);
     void draw_legend(QPainter& p, const QRect& plot);
 
+    // 抽取列：一列覆盖固定个数的连续采样，记录首/末值与最小/最大值
+    struct column_t {
+        double first;
+        double last;
+        double lo;
+        double hi;
+        bool lo_first;              // 最小值先于最大值出现（决定列内连线顺序）
+    };
+
+    // 通道存储均为预分配的定长环形队列，追加采样不分配内存
     struct channel_data {
-        std::deque<double> data;
+        ring_buffer<double> data;   // 最近m_max_points个采样（连续存储）
         QColor color;
         QString name;
+
+        uint64_t next_index = 0;    // 下一个采样的绝对序号
+
+        // 滑动窗口极值单调队列（绝对序号, 值），自动缩放O(1)取极值
+        ring_buffer<std::pair<uint64_t, double>> min_q;
+        ring_buffer<std::pair<uint64_t, double>> max_q;
+
+        // 按绝对序号对齐的抽取列，追加采样时增量更新
+        ring_buffer<column_t> columns;
+        uint64_t column_base = 0;   // columns.front()的列号
+        uint64_t column_end = 0;    // 末列之后第一个采样的绝对序号
     };
+
+    // 追加采样并维护极值队列与抽取列，窗口满时淘汰最旧采样
+    void push_sample(channel_data& ch, double value);
+
+    // 按当前最大点数与每列采样数重新分配通道存储，保留窗口内最新的采样
+    void reset_storage(channel_data& ch);
+
+    // 按当前宽度和最大点数重新确定每列采样数，变化时重建抽取列
+    void rebuild_columns();
+
+    // 单通道抽取列更新
+    void column_append(channel_data& ch, uint64_t index, double value);
+
+    // 安排重绘：两次绘制之间最多调用一次update()
+    void schedule_repaint();
+
+    int plot_width() const { return width() - 60; }
     
     std::vector<channel_data> m_channels;
+    size_t m_bucket = 0;        // 每列采样数，0表示不抽取（点数不超过像素列数的2倍）
     size_t m_max_points = 500;
     double m_y_min = -1.0;
     double m_y_max = 1.0;
     bool m_auto_scale = true;
     bool m_show_grid = true;
+    bool m_repaint_pending = false;     // 已请求重绘，尚未绘制
+
+    // 静态层：背景与网格（尺寸变化时重建）；图例层（通道配置变化时重建）
+    static_layer m_background;
+    static_layer m_legend;
 };
 
 #endif // UI_WIDGETS_WAVEFORM_VIEW_H
@@ -0,0 +1,355 @@
+/**
+ * @file foc_headless.cpp
+ * @brief 无界面批量仿真工具
+ *
+ * 通过config_loader加载config目录下的JSON配置，以CPU最大速度运行指定仿真时长，
+ * 并将逐步轨迹写入CSV或foctrj文件。默认使用编译期特化的仿真流水线（core/sim_pipeline.h），
+ * 结果与sim_engine逐位一致；--generic强制走sim_engine的运行期路径（对照与性能比较用）：
+ * - CSV：首行为列名，之后每行一个采样点（列与foctrj相同，见e_traj_column）
+ * - foctrj：内存映射列存二进制轨迹文件（core/trajectory_file.h，魔数"FOCTRJ01"），可在界面程序中回放
+ * --numeric选择FOC控制通路的数值类型（double | float | q31 | q15，见core/scalar_traits.h），
+ * 电机模型始终为double，用于评估控制算法移植到单精度/定点固件后的量化误差；仅流水线路径支持
+ *
+ * 用法示例：
+ *   foc_headless config/default_pmsm.json -o out.csv --duration 2.0
+ *   foc_headless config/bldc_six_step.json -o out.csv --motor bldc
+ *   foc_headless config/default_pmsm.json -o out.foctrj --format foctrj   # 界面程序可回放
+ *   foc_headless config/default_pmsm.json --duration 10 --generic          # 运行期分派路径
+ *   foc_headless config/default_pmsm.json -o q15.csv --numeric q15         # Q15定点控制通路
+ *   foc_headless config/switching_pmsm.json -o sw.csv --dead-time 2e-6     # 开关模型，含死区
+ */
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include "core/sim_engine.h"
+#include "core/sim_pipeline.h"
+#include "core/motor_model_factory.h"
+#include "core/config_loader.h"
+#include "core/trajectory_file.h"
+#include "control/loop_controller.h"
+#include "control/six_step_controller.h"
+
+// CSV轨迹写出器：按块缓存后整块写入文件
+class csv_writer {
+public:
+    explicit csv_writer(QFile& file) : m_file(file) {
+        m_text.reserve(1 << 20);
+    }
+
+    // 列名与列顺序与轨迹文件一致（core/trajectory_file.h）
+    void write_header() {
+        for (size_t i = 0; i < TRAJ_COLUMN_COUNT; ++i) {
+            m_text.append(traj_column_name(static_cast<e_traj_column>(i)));
+            m_text.push_back(i + 1 < TRAJ_COLUMN_COUNT ? ',' : '\n');
+        }
+    }
+
+    void append(const sim_sample_t& s) {
+        double row[TRAJ_COLUMN_COUNT];
+        traj_pack_row(s, row);
+        char buf[32];
+        for (size_t i = 0; i < TRAJ_COLUMN_COUNT; ++i) {
+            int n = std::snprintf(buf, sizeof(buf), "%.9g", row[i]);
+            m_text.append(buf, static_cast<size_t>(n));
+            m_text.push_back(i + 1 < TRAJ_COLUMN_COUNT ? ',' : '\n');
+        }
+        ++m_count;
+    }
+
+    void flush() {
+        if (!m_text.empty()) {
+            m_file.write(m_text.data(), static_cast<qint64>(m_text.size()));
+            m_text.clear();
+        }
+    }
+
+    uint64_t count() const { return m_count; }
+
+private:
+    QFile& m_file;
+    std::string m_text;
+    uint64_t m_count = 0;
+};
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("foc_headless");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("FOC无界面批量仿真：加载JSON配置并输出仿真轨迹");
+    parser.addHelpOption();
+    parser.addPositionalArgument("config", "配置文件路径 (config/*.json)");
+    QCommandLineOption opt_output({"o", "output"}, "轨迹输出文件（缺省不输出）", "file");
+    QCommandLineOption opt_format("format", "输出格式: csv | foctrj（默认csv；foctrj为二进制列存格式，可在界面程序中回放）", "format", "csv");
+    QCommandLineOption opt_duration("duration", "仿真时长/秒（默认1.0）", "seconds", "1.0");
+    QCommandLineOption opt_mode("mode", "控制模式: foc | six_step（默认按配置自动选择）", "mode");
+    QCommandLineOption opt_motor("motor", "电机类型: pmsm | bldc（默认pmsm）", "type", "pmsm");
+    QCommandLineOption opt_decimate("decimate", "每N步输出一个采样点（默认1）", "n", "1");
+    QCommandLineOption opt_dt("dt", "覆盖配置中的仿真步长/秒", "seconds");
+    QCommandLineOption opt_load("load", "负载转矩/N·m（默认0.2）", "torque", "0.2");
+    QCommandLineOption opt_integrator("integrator", "覆盖配置中的积分方法: euler | rk4 | rk45 | zoh", "method");
+    QCommandLineOption opt_rtol("rtol", "RK45相对误差容限", "value");
+    QCommandLineOption opt_atol("atol", "RK45绝对误差容限", "value");
+    QCommandLineOption opt_inverter("inverter", "覆盖配置中的逆变器模型: average | switching", "mode");
+    QCommandLineOption opt_dead_time("dead-time", "覆盖配置中的死区时间/秒（开关模型）", "seconds");
+    QCommandLineOption opt_fast_trig("fast-trig", "使用快速多项式sin/cos（绝对误差≤3e-16）");
+    QCommandLineOption opt_generic("generic", "使用sim_engine运行期分派路径（默认使用编译期特化流水线）");
+    QCommandLineOption opt_numeric("numeric", "FOC控制通路数值类型: double | float | q31 | q15（默认double）", "type", "double");
+    parser.addOption(opt_output);
+    parser.addOption(opt_format);
+    parser.addOption(opt_duration);
+    parser.addOption(opt_mode);
+    parser.addOption(opt_motor);
+    parser.addOption(opt_decimate);
+    parser.addOption(opt_dt);
+    parser.addOption(opt_load);
+    parser.addOption(opt_integrator);
+    parser.addOption(opt_rtol);
+    parser.addOption(opt_atol);
+    parser.addOption(opt_inverter);
+    parser.addOption(opt_dead_time);
+    parser.addOption(opt_fast_trig);
+    parser.addOption(opt_generic);
+    parser.addOption(opt_numeric);
+    parser.process(app);
+
+    QTextStream err(stderr);
+    const QStringList args = parser.positionalArguments();
+    if (args.isEmpty()) {
+        err << "缺少配置文件参数\n";
+        parser.showHelp(1);
+    }
+
+    config_data_t cfg = config_loader::load(args.first());
+    if (!cfg.valid) {
+        err << "配置文件加载失败: " << args.first() << "\n";
+        return 1;
+    }
+    if (parser.isSet(opt_dt)) {
+        cfg.sim.dt = parser.value(opt_dt).toDouble();
+    }
+    if (parser.isSet(opt_integrator)) {
+        QString method = parser.value(opt_integrator).toLower();
+        if (method == "rk4") {
+            cfg.sim.integrator.method = e_integrator::RK4;
+        } else if (method == "rk45") {
+            cfg.sim.integrator.method = e_integrator::RK45;
+        } else if (method == "zoh") {
+            cfg.sim.integrator.method = e_integrator::ZOH;
+        } else {
+            cfg.sim.integrator.method = e_integrator::EULER;
+        }
+    }
+    if (parser.isSet(opt_rtol)) {
+        cfg.sim.integrator.rtol = parser.value(opt_rtol).toDouble();
+    }
+    if (parser.isSet(opt_atol)) {
+        cfg.sim.integrator.atol = parser.value(opt_atol).toDouble();
+    }
+    if (parser.isSet(opt_inverter)) {
+        cfg.sim.inverter.mode = (parser.value(opt_inverter).toLower() == "switching")
+                                ? e_inverter_mode::SWITCHING : e_inverter_mode::AVERAGE;
+    }
+    if (parser.isSet(opt_dead_time)) {
+        cfg.sim.inverter.dead_time = parser.value(opt_dead_time).toDouble();
+    }
+    if (parser.isSet(opt_fast_trig)) {
+        cfg.sim.trig_mode = e_trig_mode::FAST;
+    }
+    if (cfg.sim.dt <= 0.0) {
+        err << "仿真步长无效\n";
+        return 1;
+    }
+
+    // 电机模型
+    e_motor_type motor_type = (parser.value(opt_motor).toLower() == "bldc")
+                              ? e_motor_type::BLDC : e_motor_type::PMSM;
+    // 控制器（与界面程序加载配置的方式一致）
+    loop_controller ctrl;
+    ctrl.set_current_pid(cfg.current_pid, cfg.current_pid);
+    ctrl.set_velocity_pid(cfg.velocity_pid);
+    ctrl.set_position_pid(cfg.position_pid);
+    ctrl.set_target(cfg.target);
+
+    six_step_controller six_step_ctrl;
+    if (cfg.has_six_step) {
+        six_step_ctrl.set_speed_pid(cfg.six_step.kp, cfg.six_step.ki);
+    }
+
+    // 控制模式：未指定时含六步换向参数的配置使用六步换向
+    e_control_mode mode = cfg.has_six_step ? e_control_mode::SIX_STEP : e_control_mode::FOC;
+    if (parser.isSet(opt_mode)) {
+        mode = (parser.value(opt_mode).toLower() == "six_step")
+               ? e_control_mode::SIX_STEP : e_control_mode::FOC;
+    }
+
+    // 控制通路数值类型（sim_engine只有double实现）
+    const QString numeric_name = parser.value(opt_numeric).toLower();
+    e_numeric_type numeric = e_numeric_type::DOUBLE;
+    if (numeric_name == "float") {
+        numeric = e_numeric_type::FLOAT32;
+    } else if (numeric_name == "q31") {
+        numeric = e_numeric_type::Q31;
+    } else if (numeric_name == "q15") {
+        numeric = e_numeric_type::Q15;
+    } else if (numeric_name != "double") {
+        err << "未知的数值类型: " << numeric_name << "\n";
+        return 1;
+    }
+    if (numeric != e_numeric_type::DOUBLE && parser.isSet(opt_generic)) {
+        err << "--numeric仅支持编译期特化流水线，不能与--generic同时使用\n";
+        return 1;
+    }
+
+    // 输出文件
+    const QString format = parser.value(opt_format).toLower();
+    if (format != "csv" && format != "foctrj") {
+        err << "不支持的输出格式: " << format << "（二进制输出请使用foctrj）\n";
+        return 1;
+    }
+    QFile out_file;
+    trajectory_recorder recorder;
+    bool write_output = parser.isSet(opt_output);
+    if (write_output && format == "foctrj") {
+        if (!recorder.open(parser.value(opt_output), cfg.sim.dt)) {
+            err << "无法写入输出文件: " << parser.value(opt_output) << "\n";
+            return 1;
+        }
+        write_output = false;
+    } else if (write_output) {
+        out_file.setFileName(parser.value(opt_output));
+        if (!out_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "无法写入输出文件: " << parser.value(opt_output) << "\n";
+            return 1;
+        }
+    }
+    csv_writer writer(out_file);
+    if (write_output) {
+        writer.write_header();
+    }
+
+    const int64_t total_steps = static_cast<int64_t>(parser.value(opt_duration).toDouble() / cfg.sim.dt);
+    const int64_t decimate = std::max<int64_t>(1, parser.value(opt_decimate).toLongLong());
+    const double load_torque = parser.value(opt_load).toDouble();
+    const bool keep_samples = write_output || recorder.is_open();
+
+    int64_t done = 0;
+    int64_t sample_index = 0;
+    auto consume = [&](const sim_sample_t& s) {
+        if (write_output) writer.append(s);
+        if (recorder.is_open()) recorder.append(&s, 1);
+    };
+
+    // 运行结果（两条路径共用的统计输出）
+    double sim_time = 0.0;
+    motor_state_t final_state;
+    integrator_stats_t istats;
+    uint64_t inverter_segments = 0;
+    uint64_t dropped = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 默认：编译期特化流水线，采样点按抽取间隔直接从流水线组装，不经过采样缓冲
+    const bool fused = !parser.isSet(opt_generic) &&
+        visit_pipeline(motor_type, mode, numeric, ctrl, [&](auto tag) {
+            typename decltype(tag)::type pipe(ctrl, six_step_ctrl);
+            pipe.set_params(cfg.motor);
+            pipe.set_config(cfg.sim);
+            pipe.set_load_torque(load_torque);
+            // 每批写出一次文件，与通用路径的写出粒度相当
+            constexpr int64_t BATCH = 8192;
+            while (done < total_steps) {
+                const int64_t n = std::min(BATCH, total_steps - done);
+                pipe.run(n, [&](const auto& p) {
+                    if (keep_samples && sample_index % decimate == 0) consume(p.sample());
+                    ++sample_index;
+                });
+                done += n;
+                if (write_output) {
+                    writer.flush();
+                }
+            }
+            sim_time = pipe.sim_time();
+            final_state = pipe.state();
+            istats = pipe.model().get_integrator_stats();
+            inverter_segments = pipe.inverter().segment_count();
+        });
+
+    // 通用路径：sim_engine按运行期配置分派（电流环关闭等无特化版本的配置也走这里）
+    if (!fused && numeric != e_numeric_type::DOUBLE) {
+        err << "当前配置没有特化流水线，--numeric " << numeric_name << " 不可用\n";
+        return 1;
+    }
+    if (!fused) {
+        auto motor = motor_model_factory::create(motor_type);
+        motor->set_params(cfg.motor);
+
+        sim_engine engine;
+        engine.set_motor_model(std::move(motor));
+        engine.set_loop_controller(&ctrl);
+        engine.set_six_step_controller(&six_step_ctrl);
+        engine.set_control_mode(mode);
+        engine.set_config(cfg.sim);
+        engine.set_load_torque(load_torque);
+
+        // 每批步数不超过采样缓冲容量的一半，保证批间取出时不丢采样
+        auto* samples = engine.sample_buffer();
+        const int64_t batch = static_cast<int64_t>(samples->capacity() / 2);
+        while (done < total_steps) {
+            int n = static_cast<int>(std::min(batch, total_steps - done));
+            engine.run_steps(n);
+            done += n;
+            samples->drain([&](const sim_sample_t& s) {
+                if (sample_index % decimate == 0) consume(s);
+                ++sample_index;
+            });
+            if (write_output) {
+                writer.flush();
+            }
+        }
+        sim_snapshot_t snap = engine.get_snapshot();
+        sim_time = snap.sim_time;
+        final_state = snap.state;
+        istats = engine.get_integrator_stats();
+        dropped = samples->dropped();
+    }
+    const double wall = timer.nsecsElapsed() * 1e-9;
+
+    err << "仿真路径: " << (fused ? "编译期特化流水线" : "sim_engine")
+        << "  控制通路: " << (mode == e_control_mode::SIX_STEP ? QString("double") : numeric_name) << "\n";
+    err << "仿真步数: " << done << "  仿真时间: " << sim_time << " s"
+        << "  耗时: " << wall << " s"
+        << "  步/秒: " << (wall > 0.0 ? done / wall : 0.0)
+        << "  实时倍率: " << (wall > 0.0 ? sim_time / wall : 0.0) << "x\n";
+    err << "积分子步: " << istats.accepted << "  拒绝: " << istats.rejected
+        << "  右端求值: " << istats.rhs_evals
+        << "  ZOH离散: " << istats.discretizations << "\n";
+    if (istats.failed > 0) {
+        err << "警告: " << istats.failed << " 个仿真步RK45子步数超过上限(max_substeps)，"
+            << "剩余区间按定步长RK4补完，可调大max_substeps或放宽rtol/atol\n";
+    }
+    if (cfg.sim.inverter.mode == e_inverter_mode::SWITCHING && inverter_segments > 0) {
+        err << "开关模型: 死区 " << cfg.sim.inverter.dead_time * 1e6 << " us  推进段数: " << inverter_segments
+            << "  平均每步: " << (done > 0 ? static_cast<double>(inverter_segments) / done : 0.0) << "\n";
+    }
+    err << "末状态: omega_m=" << final_state.omega_m << " rad/s  iq=" << final_state.iq
+        << " A  te=" << final_state.te << " N·m\n";
+    if (write_output) {
+        err << "已输出 " << writer.count() << " 个采样点 -> " << parser.value(opt_output) << "\n";
+    }
+    if (recorder.is_open()) {
+        err << "已输出 " << recorder.row_count() << " 个采样点 -> " << parser.value(opt_output) << "\n";
+        recorder.close();
+    }
+    if (dropped > 0) {
+        err << "警告: 采样缓冲丢弃 " << dropped << " 个采样点\n";
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file foc_tune.cpp
+ * @brief PID自动整定工具
+ *
+ * 以JSON配置为基准，用多起点Nelder–Mead在多核上并行仿真阶跃响应，
+ * 按所选代价（ISE、超调量、调节时间）整定电流环、速度环、位置环增益，
+ * 结果可通过config_loader::save写回配置文件。
+ *
+ * 用法示例：
+ *   foc_tune config/default_pmsm.json --loop velocity --cost ise
+ *   foc_tune config/cascade_full.json --loop cascade --cost overshoot -o config/tuned.json
+ */
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <cstdio>
+#include "analysis/pid_tuner.h"
+#include "core/config_loader.h"
+
+static const char* signal_name(e_sweep_signal signal) {
+    switch (signal) {
+        case e_sweep_signal::CURRENT:  return "current";
+        case e_sweep_signal::VELOCITY: return "velocity";
+        case e_sweep_signal::POSITION: return "position";
+    }
+    return "";
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("foc_tune");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("FOC PID自动整定：多起点Nelder–Mead并行仿真");
+    parser.addHelpOption();
+    parser.addPositionalArgument("config", "基准配置文件路径");
+    QCommandLineOption opt_loop("loop",
+        "整定的环: current | velocity | position | cascade（由内到外依次整定，默认velocity）",
+        "loop", "velocity");
+    QCommandLineOption opt_cost("cost", "代价: ise | overshoot | settling（默认ise）", "cost", "ise");
+    QCommandLineOption opt_step("step", "阶跃参考值（默认取配置中的对应目标，仅单环整定）", "value");
+    QCommandLineOption opt_duration("duration", "单次仿真时长/秒（默认0.5）", "seconds", "0.5");
+    QCommandLineOption opt_starts("starts", "并行起点个数（默认4）", "n", "4");
+    QCommandLineOption opt_evals("max-evals", "每环仿真次数上限（默认400）", "n", "400");
+    QCommandLineOption opt_seed("seed", "起点扰动随机种子（默认1）", "n", "1");
+    QCommandLineOption opt_threads("threads", "线程数（默认全部核心）", "n", "0");
+    QCommandLineOption opt_motor("motor", "电机类型: pmsm | bldc（默认pmsm）", "type", "pmsm");
+    QCommandLineOption opt_load("load", "负载转矩/N·m（默认0）", "torque", "0");
+    QCommandLineOption opt_output({"o", "output"}, "写出整定后的配置文件", "file");
+    parser.addOption(opt_loop);
+    parser.addOption(opt_cost);
+    parser.addOption(opt_step);
+    parser.addOption(opt_duration);
+    parser.addOption(opt_starts);
+    parser.addOption(opt_evals);
+    parser.addOption(opt_seed);
+    parser.addOption(opt_threads);
+    parser.addOption(opt_motor);
+    parser.addOption(opt_load);
+    parser.addOption(opt_output);
+    parser.process(app);
+
+    QTextStream err(stderr);
+    const QStringList args = parser.positionalArguments();
+    if (args.isEmpty()) {
+        err << "缺少配置文件参数\n";
+        parser.showHelp(1);
+    }
+    config_data_t cfg = config_loader::load(args.first());
+    if (!cfg.valid) {
+        err << "配置文件加载失败: " << args.first() << "\n";
+        return 1;
+    }
+
+    tune_options_t opt;
+    if (!pid_tuner::parse_cost(parser.value(opt_cost).toLower().toStdString(), opt.cost)) {
+        err << "未知代价: " << parser.value(opt_cost) << "\n";
+        return 1;
+    }
+    opt.starts = parser.value(opt_starts).toInt();
+    opt.max_evaluations = parser.value(opt_evals).toInt();
+    opt.seed = parser.value(opt_seed).toUInt();
+    opt.threads = parser.value(opt_threads).toUInt();
+
+    sweep_spec_t spec;
+    spec.motor_type = (parser.value(opt_motor).toLower() == "bldc") ? e_motor_type::BLDC : e_motor_type::PMSM;
+    spec.motor = cfg.motor;
+    spec.current_pid = cfg.current_pid;
+    spec.velocity_pid = cfg.velocity_pid;
+    spec.position_pid = cfg.position_pid;
+    spec.sim = cfg.sim;
+    spec.duration = parser.value(opt_duration).toDouble();
+    spec.load_torque = parser.value(opt_load).toDouble();
+
+    QElapsedTimer timer;
+    timer.start();
+    auto progress = [](int evaluations, double best_cost) {
+        std::fprintf(stderr, "仿真 %d 次, 当前最优代价 %.6g\n", evaluations, best_cost);
+    };
+
+    std::vector<tune_result_t> results;
+    const QString loop = parser.value(opt_loop).toLower();
+    if (loop == "cascade") {
+        results = pid_tuner::tune_cascade(spec,
+            {e_sweep_signal::CURRENT, e_sweep_signal::VELOCITY, e_sweep_signal::POSITION},
+            cfg.target, opt, progress);
+        if (results.empty()) {
+            err << "配置中iq_ref、vel_ref、pos_ref均为0，无可整定的环\n";
+            return 1;
+        }
+    } else {
+        if (loop == "current") {
+            spec.signal = e_sweep_signal::CURRENT;
+            spec.step_ref = cfg.target.iq_ref;
+        } else if (loop == "position") {
+            spec.signal = e_sweep_signal::POSITION;
+            spec.step_ref = cfg.target.pos_ref;
+        } else if (loop == "velocity") {
+            spec.signal = e_sweep_signal::VELOCITY;
+            spec.step_ref = cfg.target.vel_ref;
+        } else {
+            err << "未知的环: " << parser.value(opt_loop) << "\n";
+            return 1;
+        }
+        if (parser.isSet(opt_step)) {
+            spec.step_ref = parser.value(opt_step).toDouble();
+        }
+        if (spec.step_ref == 0.0) {
+            err << "阶跃参考值为0，请用--step指定\n";
+            return 1;
+        }
+        results.push_back(pid_tuner::tune(spec, opt, progress));
+    }
+    const double wall = timer.nsecsElapsed() * 1e-9;
+
+    // 结果汇总（只采用优于初始增益的结果）
+    QTextStream out(stdout);
+    int total = 0;
+    for (const auto& r : results) {
+        total += r.evaluations;
+        const bool improved = r.cost < r.initial_cost;
+        out << signal_name(r.signal) << ": 代价(" << pid_tuner::cost_name(opt.cost) << ") "
+            << r.initial_cost << " -> " << r.cost
+            << (r.converged ? "" : "（未收敛）") << (improved ? "" : "（未改善，保持原增益）") << "\n";
+        for (size_t i = 0; i < r.params.size() && i < r.values.size(); ++i) {
+            out << "  " << sweep_runner::param_name(r.params[i]) << " = " << r.values[i] << "\n";
+        }
+        const auto& m = r.metrics;
+        out << "  rise_time=" << m.rise_time << " overshoot=" << m.overshoot
+            << " settling_time=" << m.settling_time << " ss_error=" << m.ss_error << "\n";
+        if (improved) {
+            cfg.current_pid = r.current_pid;
+            cfg.velocity_pid = r.velocity_pid;
+            cfg.position_pid = r.position_pid;
+        }
+    }
+    out.flush();
+
+    if (parser.isSet(opt_output)) {
+        if (!config_loader::save(parser.value(opt_output), cfg)) {
+            err << "无法写入输出文件: " << parser.value(opt_output) << "\n";
+            return 1;
+        }
+        err << "已写出: " << parser.value(opt_output) << "\n";
+    }
+    err << "完成: " << total << " 次仿真, 耗时 " << wall << " s\n";
+    return 0;
+}